@@ -0,0 +1,200 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/resource.h>
+#include "NeuralNetwork.h"
+#include "NN_Blocchi.h"
+#include "Dataset.h"
+#include "bench_comune.h"
+
+/* ============================================================
+ *        TRAINING A BLOCCHI: SOVRAPPOSIZIONE E MEMORIA
+ * ============================================================
+ *
+ * Per ogni numero di righe genera un CSV sintetico nel formato
+ * di dataset.csv (in /tmp), lo converte nel formato colonnare
+ * e per ciascuna sorgente misura:
+ *
+ *   lettura   solo dataset_leggi_blocco sull'intero file
+ *   epoca     un'epoca nnb_epoca (lettore + training)
+ *   calcolo   epoca meno l'attesa del training sul lettore
+ *   sovrap.   quota del tempo di lettura nascosta dal calcolo:
+ *             (lettura + calcolo - epoca) / lettura
+ *
+ * La memoria di picco (ru_maxrss) non deve crescere con le
+ * righe: dipende solo da blocco e numero di buffer. La rete
+ * addestrata dal CSV deve coincidere bit per bit con quella
+ * addestrata dal file colonnare (stessi valori normalizzati,
+ * stesso ordine).
+ *
+ * Su una macchina a un solo core lettura e calcolo si
+ * alternano sulla stessa CPU e la sovrapposizione è bassa.
+ *
+ * Uso: bench_blocchi [righe_blocco] [n_blocchi] [batch] [righe ...]
+ *      (default 65536 3 1 1000000 10000000)
+ *
+ * Termina con codice 1 se le due reti differiscono.
+ */
+
+#define SEME 42
+
+static int scrivi_csv(char *nome, long righe) {
+    strcpy(nome, "/tmp/bench_blocchi_XXXXXX");
+    const int fd = mkstemp(nome);
+    if (fd < 0) return -1;
+    FILE *f = fdopen(fd, "w");
+    if (!f) {
+        close(fd);
+        return -1;
+    }
+
+    unsigned long long seme = 2024;
+    for (long r = 0; r < righe; r++) {
+        const int ora = (int)(bench_rand_u64(&seme) % 24);
+        const double luci = bench_uniforme(&seme, 0.0, 1.0);
+        const double mov  = bench_uniforme(&seme, 0.0, 1.0);
+        const int classe = (luci + mov < 0.4) ? ((ora < 7) ? 2 : 0) : 1;
+
+        fprintf(f, "%d, %.1f, %.2f, %.2f, %.2f, %.2f, %.1f, %d\n",
+                ora, bench_uniforme(&seme, -2.0, 12.0), luci, mov,
+                bench_uniforme(&seme, 0.0, 8.0),
+                bench_uniforme(&seme, 0.3, 0.6),
+                bench_uniforme(&seme, 15.0, 22.0), classe);
+    }
+
+    return fclose(f);
+}
+
+static double dim_mb(const char *nome) {
+    struct stat st;
+    return stat(nome, &st) == 0 ? (double)st.st_size / 1e6 : 0.0;
+}
+
+static double picco_mb(void) {
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    return (double)ru.ru_maxrss / 1e3;      // ru_maxrss in KB
+}
+
+/* Solo lettura, con un buffer di un blocco */
+static double solo_lettura(const char *nome, long righe_blocco) {
+    Dataset_Flusso *fl = dataset_apri_flusso(nome);
+    double *X = (double*)malloc((size_t)righe_blocco * DATASET_N_FEATURE * sizeof(double));
+    int *y = (int*)malloc((size_t)righe_blocco * sizeof(int));
+    double t = -1.0;
+
+    if (fl && X && y) {
+        const double t0 = orologio_secondi();
+        while (dataset_leggi_blocco(fl, X, y, righe_blocco) > 0)
+            ;
+        t = orologio_secondi() - t0;
+    }
+
+    free(X);
+    free(y);
+    dataset_chiudi_flusso(fl);
+    return t;
+}
+
+/* Un'epoca a blocchi su una rete nuova, restituita al chiamante */
+static NeuralNetwork *epoca(const char *nome, const char *etichetta,
+                            long righe_blocco, int n_blocchi, int batch) {
+    NeuralNetwork *net = nn_create(DATASET_N_FEATURE, 16, DATASET_N_CLASSI,
+                                   0.01, 0.001, SEME);
+    NN_Blocchi *b = nnb_crea(nome, righe_blocco, n_blocchi, batch);
+    if (!net || !b) {
+        fprintf(stderr, "impossibile preparare il training su %s\n", nome);
+        nnb_free(b);
+        nn_free(net);
+        return NULL;
+    }
+
+    const double t_lettura = solo_lettura(nome, righe_blocco);
+
+    const double t0 = orologio_secondi();
+    const long righe = nnb_epoca(b, net);
+    const double t_epoca = orologio_secondi() - t0;
+
+    NNB_Statistiche st;
+    nnb_statistiche(b, &st);
+    const double t_calcolo = t_epoca - st.attesa_training;
+    const double sovrapposizione = t_lettura > 0.0
+        ? (t_lettura + t_calcolo - t_epoca) / t_lettura : 0.0;
+
+    printf("  %-10s %11.0f righe/s | lettura %6.2f s | epoca %6.2f s | "
+           "calcolo %6.2f s | sovrap. %5.1f%% | lettore fermo %6.2f s | "
+           "buffer %.1f MB | picco RSS %.1f MB\n",
+           etichetta, righe / t_epoca, t_lettura, t_epoca, t_calcolo,
+           100.0 * sovrapposizione, st.attesa_lettura,
+           (double)st.memoria / 1e6, picco_mb());
+
+    nnb_free(b);
+    if (righe < 0) {
+        fprintf(stderr, "errore di lettura su %s\n", nome);
+        nn_free(net);
+        return NULL;
+    }
+    return net;
+}
+
+int main(int argc, char **argv) {
+    static const long predefinite[] = { 1000000L, 10000000L };
+    const long righe_blocco = (argc > 1) ? atol(argv[1]) : 65536;
+    const int n_blocchi     = (argc > 2) ? atoi(argv[2]) : 3;
+    const int batch         = (argc > 3) ? atoi(argv[3]) : 1;
+    const int n_prove       = (argc > 4) ? argc - 4 : 2;
+
+    if (righe_blocco < 1 || n_blocchi < 2 || batch < 1) {
+        fprintf(stderr, "uso: %s [righe_blocco] [n_blocchi] [batch] [righe ...]\n",
+                argv[0]);
+        return 2;
+    }
+
+    printf("blocco %ld righe | %d buffer | batch %d | core disponibili %ld\n\n",
+           righe_blocco, n_blocchi, batch, sysconf(_SC_NPROCESSORS_ONLN));
+
+    int errori = 0;
+    for (int p = 0; p < n_prove; p++) {
+        const long n = (argc > 4) ? atol(argv[p + 4]) : predefinite[p];
+        if (n < 1) {
+            fprintf(stderr, "righe non valide: %s\n", argv[p + 4]);
+            return 2;
+        }
+
+        char csv[64], bin[72];
+        Dataset_Conversione conv;
+        if (scrivi_csv(csv, n) != 0) {
+            fprintf(stderr, "impossibile scrivere il CSV temporaneo\n");
+            return 2;
+        }
+        snprintf(bin, sizeof(bin), "%s.col", csv);
+        if (dataset_converti_colonne(csv, bin, &conv) != 0) {
+            fprintf(stderr, "conversione non riuscita\n");
+            unlink(csv);
+            return 2;
+        }
+
+        printf("%ld righe | CSV %.0f MB | colonnare %.0f MB\n",
+               n, dim_mb(csv), dim_mb(bin));
+
+        NeuralNetwork *da_csv = epoca(csv, "CSV", righe_blocco, n_blocchi, batch);
+        NeuralNetwork *da_bin = epoca(bin, "colonnare", righe_blocco, n_blocchi, batch);
+
+        const int uguali = da_csv && da_bin &&
+            memcmp(da_csv->parametri, da_bin->parametri,
+                   (size_t)da_csv->num_parametri * sizeof(double)) == 0;
+        printf("  reti coincidenti: %s\n\n", uguali ? "si" : "NO");
+        if (!uguali) errori++;
+
+        nn_free(da_csv);
+        nn_free(da_bin);
+        unlink(csv);
+        unlink(bin);
+    }
+
+    return errori ? 1 : 0;
+}
@@ -0,0 +1,33 @@
+#ifndef BENCH_COMUNE_H
+#define BENCH_COMUNE_H
+
+/* ============================================================
+ *              UTILITÀ COMUNI AI BENCHMARK
+ * ============================================================
+ *
+ * Da includere dopo aver definito _POSIX_C_SOURCE
+ * (necessario per clock_gettime). I tempi si misurano con
+ * orologio_secondi (src/Orologio.h).
+ */
+
+#include "Orologio.h"
+
+/*
+ * Generatore pseudo-casuale deterministico (xorshift64*),
+ * indipendente da rand() per rendere i benchmark ripetibili.
+ */
+static inline unsigned long long bench_rand_u64(unsigned long long *s) {
+    *s ^= *s >> 12;
+    *s ^= *s << 25;
+    *s ^= *s >> 27;
+    return *s * 2685821657736338717ULL;
+}
+
+/* Uniforme in [lo, hi) */
+static inline double bench_uniforme(unsigned long long *s,
+                                    double lo, double hi) {
+    double u = (double)(bench_rand_u64(s) >> 11) * (1.0 / 9007199254740992.0);
+    return lo + (hi - lo) * u;
+}
+
+#endif
@@ -0,0 +1,332 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "Dataset.h"
+#include "bench_comune.h"
+
+/* ============================================================
+ *     INGESTIONE DEL DATASET: CSV CONTRO FORMATO COLONNARE
+ * ============================================================
+ *
+ * Per ogni numero di righe richiesto genera un CSV sintetico
+ * nel formato di dataset.csv (file temporaneo in /tmp) e
+ * misura le righe/s rese disponibili al training:
+ *
+ *   fscanf      fscanf "%lf, %lf, ..." + normalizzazione
+ *   strtod      fgets + strtod/strtol per campo + normalizzazione
+ *               (il tokenizer precedente)
+ *   analizza    fgets + dataset_analizza_riga (dataset_strtod)
+ *   tokenizer   dataset_leggi_blocco sul CSV: buffer da 1 MB,
+ *               righe terminate sul posto, dataset_strtod
+ *   conversione dataset_converti_colonne (una tantum)
+ *   mmap seq    dataset_mappa_colonne + lettura di tutte le
+ *               righe in ordine
+ *   mmap rand   come sopra, in ordine rimescolato (epoca)
+ *
+ * Le letture CSV non conservano le righe, così anche 100M
+ * righe non richiedono memoria proporzionale. Le letture del
+ * file colonnare partono con la page cache calda se il file
+ * vi entra; a 100M righe (circa 5,7 GB) il sistema operativo
+ * la ricarica dal disco durante la misura, e la lettura in
+ * ordine rimescolato viene saltata se il file supera metà
+ * della memoria fisica.
+ *
+ * Uso: bench_dataset [righe ...]     (default 1000000 100000000)
+ *
+ * Le somme di controllo delle feature devono coincidere tra
+ * tutti i lettori (a meno dell'arrotondamento in ordine
+ * rimescolato).
+ *
+ * Termina con codice 1 se una somma differisce.
+ */
+
+/* ============================================================
+ * DATI SINTETICI
+ * ============================================================ */
+
+static int scrivi_csv(char *nome, long righe) {
+    strcpy(nome, "/tmp/bench_dataset_XXXXXX");
+    const int fd = mkstemp(nome);
+    if (fd < 0) return -1;
+    FILE *f = fdopen(fd, "w");
+    if (!f) {
+        close(fd);
+        return -1;
+    }
+
+    unsigned long long seme = 2024;
+    for (long r = 0; r < righe; r++) {
+        const int ora = (int)(bench_rand_u64(&seme) % 24);
+        const double luci = bench_uniforme(&seme, 0.0, 1.0);
+        const double mov  = bench_uniforme(&seme, 0.0, 1.0);
+        const int classe = (luci + mov < 0.4) ? ((ora < 7) ? 2 : 0) : 1;
+
+        fprintf(f, "%d, %.1f, %.2f, %.2f, %.2f, %.2f, %.1f, %d\n",
+                ora, bench_uniforme(&seme, -2.0, 12.0), luci, mov,
+                bench_uniforme(&seme, 0.0, 8.0),
+                bench_uniforme(&seme, 0.3, 0.6),
+                bench_uniforme(&seme, 15.0, 22.0), classe);
+    }
+
+    return fclose(f);
+}
+
+static double dim_mb(const char *nome) {
+    struct stat st;
+    return stat(nome, &st) == 0 ? (double)st.st_size / 1e6 : 0.0;
+}
+
+/* ============================================================
+ * LETTORI
+ * ============================================================
+ *
+ * Ognuno ritorna una somma di controllo delle feature
+ * normalizzate e delle etichette, uguale per tutti i lettori.
+ */
+
+static double leggi_fscanf(const char *nome, long *righe) {
+    FILE *f = fopen(nome, "r");
+    if (!f) return 0.0;
+
+    double raw[DATASET_N_FEATURE], x[DATASET_N_FEATURE], somma = 0.0;
+    int classe;
+    *righe = 0;
+
+    while (fscanf(f, "%lf, %lf, %lf, %lf, %lf, %lf, %lf, %d",
+                  &raw[0], &raw[1], &raw[2], &raw[3],
+                  &raw[4], &raw[5], &raw[6], &classe) == 8) {
+        norm_riga(raw, x);
+        for (int k = 0; k < DATASET_N_FEATURE; k++)
+            somma += x[k];
+        somma += classe;
+        (*righe)++;
+    }
+
+    fclose(f);
+    return somma;
+}
+
+/* Riga con strtod e strtol della libreria, senza diagnostica */
+static int analizza_strtod(const char *s, double raw[DATASET_N_FEATURE],
+                           int *classe) {
+    char *fine;
+    for (int k = 0; k < DATASET_N_FEATURE; k++) {
+        raw[k] = strtod(s, &fine);
+        if (fine == s) return 0;
+        while (*fine == ' ') fine++;
+        if (*fine != ',') return 0;
+        s = fine + 1;
+    }
+    *classe = (int)strtol(s, &fine, 10);
+    return fine != s;
+}
+
+static double leggi_strtod(const char *nome, long *righe) {
+    FILE *f = fopen(nome, "r");
+    if (!f) return 0.0;
+
+    char buf[1024];
+    double raw[DATASET_N_FEATURE], x[DATASET_N_FEATURE], somma = 0.0;
+    int classe;
+    *righe = 0;
+
+    while (fgets(buf, sizeof(buf), f)) {
+        if (!analizza_strtod(buf, raw, &classe))
+            continue;
+        norm_riga(raw, x);
+        for (int k = 0; k < DATASET_N_FEATURE; k++)
+            somma += x[k];
+        somma += classe;
+        (*righe)++;
+    }
+
+    fclose(f);
+    return somma;
+}
+
+static double leggi_analizza(const char *nome, long *righe) {
+    FILE *f = fopen(nome, "r");
+    if (!f) return 0.0;
+
+    char buf[1024];
+    double raw[DATASET_N_FEATURE], x[DATASET_N_FEATURE], somma = 0.0;
+    int classe, colonna;
+    const char *errore;
+    *righe = 0;
+
+    while (fgets(buf, sizeof(buf), f)) {
+        if (dataset_analizza_riga(buf, raw, &classe, &colonna, &errore) != 1)
+            continue;
+        norm_riga(raw, x);
+        for (int k = 0; k < DATASET_N_FEATURE; k++)
+            somma += x[k];
+        somma += classe;
+        (*righe)++;
+    }
+
+    fclose(f);
+    return somma;
+}
+
+static double leggi_tokenizer(const char *nome, long *righe) {
+    enum { BLOCCO = 4096 };
+    static double X[BLOCCO * DATASET_N_FEATURE];
+    static int y[BLOCCO];
+
+    Dataset_Flusso *fl = dataset_apri_flusso(nome);
+    double somma = 0.0;
+    long n;
+    *righe = 0;
+    if (!fl) return 0.0;
+
+    while ((n = dataset_leggi_blocco(fl, X, y, BLOCCO)) > 0) {
+        for (long r = 0; r < n; r++) {
+            for (int k = 0; k < DATASET_N_FEATURE; k++)
+                somma += X[r * DATASET_N_FEATURE + k];
+            somma += y[r];
+        }
+        *righe += n;
+    }
+
+    dataset_chiudi_flusso(fl);
+    return somma;
+}
+
+/* ordine == NULL: righe in sequenza */
+static double leggi_colonne(const char *nome, const int *ordine, long *righe) {
+    Dataset_Colonne *dc = dataset_mappa_colonne(nome, NULL);
+    if (!dc) {
+        *righe = 0;
+        return 0.0;
+    }
+
+    double x[DATASET_N_FEATURE], somma = 0.0;
+    for (long k = 0; k < dc->n_righe; k++) {
+        const long r = ordine ? ordine[k] : k;
+        dataset_colonne_riga(dc, r, x);
+        for (int j = 0; j < DATASET_N_FEATURE; j++)
+            somma += x[j];
+        somma += dc->y[r];
+    }
+
+    *righe = dc->n_righe;
+    dataset_colonne_free(dc);
+    return somma;
+}
+
+/* ============================================================
+ * MAIN
+ * ============================================================ */
+
+/* mb: dimensione del CSV letto, 0 per le letture del colonnare */
+/* Ritorna 1 se la somma di controllo differisce */
+static int riga(const char *nome, long righe, double mb, double t,
+                int coincide) {
+    char banda[32] = "";
+    if (mb > 0.0) snprintf(banda, sizeof(banda), "%7.0f MB/s", mb / t);
+    printf("  %-12s %12.0f righe/s %12s %9.2f s   %s\n", nome, righe / t,
+           banda, t, coincide ? "" : "(somma diversa)");
+    return !coincide;
+}
+
+int main(int argc, char **argv) {
+    static const long predefinite[] = { 1000000L, 100000000L };
+    const int n_prove = (argc > 1) ? argc - 1 : 2;
+    int errori = 0;
+
+    for (int p = 0; p < n_prove; p++) {
+        const long n = (argc > 1) ? atol(argv[p + 1]) : predefinite[p];
+        if (n < 1) {
+            fprintf(stderr, "uso: %s [righe ...]\n", argv[0]);
+            return 2;
+        }
+
+        char csv[64], bin[72];
+        if (scrivi_csv(csv, n) != 0) {
+            fprintf(stderr, "impossibile scrivere il CSV temporaneo\n");
+            return 2;
+        }
+        snprintf(bin, sizeof(bin), "%s.col", csv);
+
+        long righe;
+        double t0 = orologio_secondi();
+        const double rif = leggi_fscanf(csv, &righe);
+        const double t_fscanf = orologio_secondi() - t0;
+
+        t0 = orologio_secondi();
+        const double s_strtod = leggi_strtod(csv, &righe);
+        const double t_strtod = orologio_secondi() - t0;
+
+        t0 = orologio_secondi();
+        const double s_analizza = leggi_analizza(csv, &righe);
+        const double t_analizza = orologio_secondi() - t0;
+
+        t0 = orologio_secondi();
+        const double s_tok = leggi_tokenizer(csv, &righe);
+        const double t_tok = orologio_secondi() - t0;
+
+        Dataset_Conversione st;
+        t0 = orologio_secondi();
+        const int conv = dataset_converti_colonne(csv, bin, &st);
+        const double t_conv = orologio_secondi() - t0;
+        if (conv != 0) {
+            fprintf(stderr, "conversione non riuscita\n");
+            unlink(csv);
+            return 2;
+        }
+
+        const double mb = dim_mb(csv);
+        printf("%ld righe | CSV %.0f MB | colonnare %.0f MB\n",
+               n, mb, dim_mb(bin));
+        errori += riga("fscanf", n, mb, t_fscanf, 1);
+        errori += riga("strtod", n, mb, t_strtod, s_strtod == rif);
+        errori += riga("analizza", n, mb, t_analizza, s_analizza == rif);
+        errori += riga("tokenizer", n, mb, t_tok, s_tok == rif);
+        errori += riga("conversione", n, mb, t_conv, st.righe == n);
+        unlink(csv);
+
+        t0 = orologio_secondi();
+        const double s_seq = leggi_colonne(bin, NULL, &righe);
+        errori += riga("mmap seq", n, 0.0, orologio_secondi() - t0, s_seq == rif);
+
+        /* Ordine rimescolato su un file più grande della metà
+         * della memoria: ogni accesso è un page fault su disco,
+         * la misura durerebbe ore (vedi il trainer a blocchi) */
+        const double memoria_mb = (double)sysconf(_SC_PHYS_PAGES) *
+                                  (double)sysconf(_SC_PAGESIZE) / 1e6;
+        int *ordine = NULL;
+        if (dim_mb(bin) > memoria_mb / 2)
+            printf("  %-12s saltato: file oltre metà della memoria (%.0f MB)\n",
+                   "mmap rand", memoria_mb);
+        else
+            ordine = (int*)malloc((size_t)n * sizeof(int));
+        if (ordine) {
+            unsigned long long seme = 7;
+            for (long r = 0; r < n; r++)
+                ordine[r] = (int)r;
+            for (long r = n - 1; r > 0; r--) {
+                const long j = (long)(bench_rand_u64(&seme) % (unsigned long long)(r + 1));
+                const int t = ordine[r];
+                ordine[r] = ordine[j];
+                ordine[j] = t;
+            }
+
+            t0 = orologio_secondi();
+            const double s_rand = leggi_colonne(bin, ordine, &righe);
+            const double t_rand = orologio_secondi() - t0;
+            /* Somma in altro ordine: differisce solo per arrotondamento */
+            errori += riga("mmap rand", n, 0.0, t_rand, fabs(s_rand - rif) <= 1e-9 * fabs(rif));
+            free(ordine);
+        }
+
+        unlink(bin);
+        printf("\n");
+    }
+
+    return errori ? 1 : 0;
+}
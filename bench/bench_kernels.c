@@ -0,0 +1,207 @@
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "NN_Kernels.h"
+#include "bench_comune.h"
+
+/* ============================================================
+ *        VERIFICA E BENCHMARK DEI KERNEL DENSI
+ * ============================================================
+ *
+ * Per ogni percorso supportato dalla CPU:
+ *  1) confronta dot, axpy, axpby, ger e ger_retro con il riferimento
+ *     scalare entro una tolleranza relativa fissata
+ *  2) misura il tempo per chiamata sulle dimensioni tipiche
+ *     della rete (7 input, 16 hidden) e su vettori lunghi
+ *
+ * Termina con codice 1 se un percorso supera la tolleranza.
+ */
+
+#define TOLLERANZA  1e-12   // Errore relativo massimo ammesso
+#define N_MAX       1024
+
+static const int lunghezze[] = {
+    1, 2, 3, 4, 5, 7, 8, 9, 15, 16, 17, 31, 64, 129, 1000
+};
+#define N_LUNGHEZZE ((int)(sizeof(lunghezze) / sizeof(lunghezze[0])))
+
+static double x[N_MAX], y[N_MAX], A[16 * N_MAX];
+static double rif[16 * N_MAX], out[16 * N_MAX];
+static double g_rif[N_MAX], g_out[N_MAX];
+
+static void riempi(double *v, int n, unsigned long long *seme) {
+    for (int i = 0; i < n; i++)
+        v[i] = bench_uniforme(seme, -1.0, 1.0);
+}
+
+/*
+ * Confronto elemento per elemento; 'scala' è il modulo
+ * tipico dei termini sommati in ciascun elemento.
+ */
+static int confronta(const double *a, const double *b, int n, double scala) {
+    for (int i = 0; i < n; i++)
+        if (fabs(a[i] - b[i]) > TOLLERANZA * scala)
+            return 0;
+    return 1;
+}
+
+/*
+ * Verifica un percorso contro il riferimento scalare.
+ * Ritorna il numero di confronti falliti.
+ */
+static int verifica(NNK_Percorso p) {
+    int errori = 0;
+    unsigned long long seme = 12345;
+
+    for (int k = 0; k < N_LUNGHEZZE; k++) {
+        const int n = lunghezze[k];
+        const int m = 16;
+        const double a = 0.37, b = 0.91;
+
+        riempi(x, n, &seme);
+        riempi(y, n, &seme);
+        riempi(A, m * n, &seme);
+
+        /* ---------- dot ---------- */
+        nnk_imposta_percorso(NNK_SCALARE);
+        double d_rif = nnk_dot(n, x, y);
+        nnk_imposta_percorso(p);
+        double d = nnk_dot(n, x, y);
+        if (fabs(d - d_rif) > TOLLERANZA * n) {
+            printf("  dot   n=%-5d FALLITO (%.3g)\n", n, fabs(d - d_rif));
+            errori++;
+        }
+
+        /* ---------- axpy ---------- */
+        nnk_imposta_percorso(NNK_SCALARE);
+        memcpy(rif, y, n * sizeof(double));
+        nnk_axpy(n, a, x, rif);
+        nnk_imposta_percorso(p);
+        memcpy(out, y, n * sizeof(double));
+        nnk_axpy(n, a, x, out);
+        if (!confronta(out, rif, n, 2.0)) {
+            printf("  axpy  n=%-5d FALLITO\n", n);
+            errori++;
+        }
+
+        /* ---------- axpby ---------- */
+        nnk_imposta_percorso(NNK_SCALARE);
+        memcpy(rif, y, n * sizeof(double));
+        nnk_axpby(n, a, x, b, rif);
+        nnk_imposta_percorso(p);
+        memcpy(out, y, n * sizeof(double));
+        nnk_axpby(n, a, x, b, out);
+        if (!confronta(out, rif, n, 2.0)) {
+            printf("  axpby n=%-5d FALLITO\n", n);
+            errori++;
+        }
+
+        /* ---------- ger (m × n) ---------- */
+        nnk_imposta_percorso(NNK_SCALARE);
+        memcpy(rif, A, (size_t)m * n * sizeof(double));
+        nnk_ger(m, n, a, x, y, b, rif, n);
+        nnk_imposta_percorso(p);
+        memcpy(out, A, (size_t)m * n * sizeof(double));
+        nnk_ger(m, n, a, x, y, b, out, n);
+        if (!confronta(out, rif, m * n, 2.0)) {
+            printf("  ger   %dx%-3d FALLITO\n", m, n);
+            errori++;
+        }
+
+        /* ---------- ger_retro (m × n), g = Aᵀ·x ---------- */
+        nnk_imposta_percorso(NNK_SCALARE);
+        memcpy(rif, A, (size_t)m * n * sizeof(double));
+        memcpy(g_rif, y, n * sizeof(double));
+        nnk_ger_retro(m, n, a, x, y, b, rif, n, g_rif);
+        nnk_imposta_percorso(p);
+        memcpy(out, A, (size_t)m * n * sizeof(double));
+        memcpy(g_out, y, n * sizeof(double));
+        nnk_ger_retro(m, n, a, x, y, b, out, n, g_out);
+        if (!confronta(out, rif, m * n, 2.0) ||
+            !confronta(g_out, g_rif, n, (double)m)) {
+            printf("  ger_retro %dx%-3d FALLITO\n", m, n);
+            errori++;
+        }
+    }
+
+    return errori;
+}
+
+/*
+ * Tempo medio per chiamata (ns) dei kernel sul percorso p
+ */
+static void misura(NNK_Percorso p) {
+    const int ripetizioni = 2000000;
+    volatile double pozzo = 0.0;
+    unsigned long long seme = 777;
+
+    nnk_imposta_percorso(p);
+    riempi(x, N_MAX, &seme);
+    riempi(y, N_MAX, &seme);
+    riempi(A, 16 * 16, &seme);
+
+    double t0 = orologio_secondi();
+    for (int r = 0; r < ripetizioni; r++)
+        pozzo += nnk_dot(7, x, y);
+    double t_dot7 = orologio_secondi() - t0;
+
+    t0 = orologio_secondi();
+    for (int r = 0; r < ripetizioni; r++)
+        pozzo += nnk_dot(16, x, y);
+    double t_dot16 = orologio_secondi() - t0;
+
+    t0 = orologio_secondi();
+    for (int r = 0; r < ripetizioni / 10; r++)
+        nnk_axpy(256, 1e-9, x, y);
+    double t_axpy = orologio_secondi() - t0;
+
+    t0 = orologio_secondi();
+    for (int r = 0; r < ripetizioni / 10; r++)
+        nnk_ger(16, 7, 1e-9, x, y, 1.0, A, 7);
+    double t_ger = orologio_secondi() - t0;
+
+    t0 = orologio_secondi();
+    for (int r = 0; r < ripetizioni / 10; r++)
+        nnk_ger_retro(3, 16, 1e-9, x, y, 1.0, A, 16, &y[16]);
+    double t_retro = orologio_secondi() - t0;
+
+    printf("  dot[7] %6.2f ns | dot[16] %6.2f ns | "
+           "axpy[256] %7.2f ns | ger[16x7] %7.2f ns | "
+           "ger_retro[3x16] %7.2f ns\n",
+           t_dot7 / ripetizioni * 1e9,
+           t_dot16 / ripetizioni * 1e9,
+           t_axpy / (ripetizioni / 10) * 1e9,
+           t_ger / (ripetizioni / 10) * 1e9,
+           t_retro / (ripetizioni / 10) * 1e9);
+    (void)pozzo;
+}
+
+int main(void) {
+    int errori_totali = 0;
+
+    nnk_inizializza();
+    printf("Percorso selezionato automaticamente: %s\n\n",
+           nnk_nome_percorso(nnk_percorso_attivo()));
+
+    for (int p = 0; p < NNK_N_PERCORSI; p++) {
+        if (!nnk_supportato((NNK_Percorso)p)) {
+            printf("[%s] non supportato da questa CPU\n\n",
+                   nnk_nome_percorso((NNK_Percorso)p));
+            continue;
+        }
+
+        int errori = verifica((NNK_Percorso)p);
+        printf("[%s] verifica contro scalare: %s\n",
+               nnk_nome_percorso((NNK_Percorso)p),
+               errori ? "FALLITA" : "OK");
+        errori_totali += errori;
+
+        misura((NNK_Percorso)p);
+        printf("\n");
+    }
+
+    return errori_totali ? 1 : 0;
+}
@@ -0,0 +1,156 @@
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Normalizzazione.h"
+#include "bench_comune.h"
+
+/* ============================================================
+ *        VERIFICA E BENCHMARK DELLA NORMALIZZAZIONE
+ * ============================================================
+ *
+ * Su batch [n][NORM_N_FEATURE] di valori grezzi plausibili
+ * confronta, bit per bit, con il ciclo per divisori usato in
+ * precedenza (riferimento):
+ *   norm_riga          riga per riga, costanti dello schema
+ *   norm_batch         vettoriale, fuori posto e sul posto
+ *   norm_batch_generico larghezza e costanti a runtime
+ * per lunghezze che coprono code di 0..3 righe, poi misura
+ * le righe/s su batch piccoli (inferenza) e grandi (dataset).
+ *
+ * Uso: bench_normalizza [righe_grandi]      (default 1000000)
+ *
+ * Termina con codice 1 se un percorso differisce.
+ */
+
+#define RIPETIZIONI_MIN 0.2     // Secondi minimi per misura
+
+static void genera(double *raw, long n, unsigned long long *seme) {
+    for (long r = 0; r < n; r++) {
+        double *x = &raw[r * NORM_N_FEATURE];
+        x[NORM_ORA]       = (double)(bench_rand_u64(seme) % 24);
+        x[NORM_TEMP_EXT]  = bench_uniforme(seme, -2.0, 12.0);
+        x[NORM_LUCI]      = bench_uniforme(seme, 0.0, 1.0);
+        x[NORM_MOVIMENTO] = bench_uniforme(seme, 0.0, 1.0);
+        x[NORM_CONSUMO]   = bench_uniforme(seme, 0.0, 8.0);
+        x[NORM_PREZZO]    = bench_uniforme(seme, 0.3, 0.6);
+        x[NORM_TEMP_INT]  = bench_uniforme(seme, 15.0, 22.0);
+    }
+}
+
+/* Il ciclo generico per divisori, senza specializzazione */
+static void riferimento(const double *raw, double *out, long n) {
+    for (long i = 0; i < n * NORM_N_FEATURE; i++)
+        out[i] = (raw[i] - norm_traslazione[i % NORM_N_FEATURE]) /
+                 norm_scala[i % NORM_N_FEATURE];
+}
+
+static void righe(const double *raw, double *out, long n) {
+    for (long r = 0; r < n; r++)
+        norm_riga(&raw[r * NORM_N_FEATURE], &out[r * NORM_N_FEATURE]);
+}
+
+static void batch(const double *raw, double *out, long n) {
+    norm_batch(raw, out, n);
+}
+
+static void generico(const double *raw, double *out, long n) {
+    norm_batch_generico(raw, out, n, NORM_N_FEATURE,
+                        norm_scala, norm_traslazione);
+}
+
+typedef void (*Percorso)(const double *raw, double *out, long n);
+
+static const struct {
+    const char *nome;
+    Percorso f;
+} percorsi[] = {
+    { "riferimento", riferimento },
+    { "norm_riga",   righe },
+    { "norm_batch",  batch },
+    { "generico",    generico },
+};
+#define N_PERCORSI ((int)(sizeof(percorsi) / sizeof(percorsi[0])))
+
+/* Righe/s del percorso su batch di n righe, fuori posto */
+static double misura(Percorso f, const double *raw, double *out, long n) {
+    long chiamate = 0;
+    const double t0 = orologio_secondi();
+    double t;
+    do {
+        f(raw, out, n);
+        chiamate++;
+    } while ((t = orologio_secondi() - t0) < RIPETIZIONI_MIN);
+    return (double)chiamate * (double)n / t;
+}
+
+int main(int argc, char **argv) {
+    const long grandi = (argc > 1) ? atol(argv[1]) : 1000000;
+    if (grandi < 1) {
+        fprintf(stderr, "uso: %s [righe_grandi]\n", argv[0]);
+        return 2;
+    }
+
+    const size_t dim = (size_t)grandi * NORM_N_FEATURE;
+    double *raw = (double*)malloc(dim * sizeof(double));
+    double *rif = (double*)malloc(dim * sizeof(double));
+    double *out = (double*)malloc(dim * sizeof(double));
+    if (!raw || !rif || !out) {
+        fprintf(stderr, "memoria insufficiente\n");
+        return 2;
+    }
+
+    unsigned long long seme = 4242;
+    genera(raw, grandi, &seme);
+
+    printf("feature %d | righe per passo vettoriale %d\n\n",
+           NORM_N_FEATURE, norm_righe_per_passo());
+
+    /* ---------- Verifica bit per bit ---------- */
+    static const long lunghezze[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 13, 64, 1001 };
+    int errori = 0;
+
+    for (size_t l = 0; l < sizeof(lunghezze) / sizeof(lunghezze[0]); l++) {
+        const long n = lunghezze[l] < grandi ? lunghezze[l] : grandi;
+        const size_t byte = (size_t)n * NORM_N_FEATURE * sizeof(double);
+        riferimento(raw, rif, n);
+
+        for (int p = 1; p < N_PERCORSI; p++) {
+            memset(out, 0, byte);
+            percorsi[p].f(raw, out, n);
+            if (memcmp(out, rif, byte) != 0) {
+                printf("  %-12s n=%ld: DIFFERISCE\n", percorsi[p].nome, n);
+                errori++;
+            }
+        }
+
+        /* Sul posto */
+        memcpy(out, raw, byte);
+        norm_batch(out, out, n);
+        if (memcmp(out, rif, byte) != 0) {
+            printf("  %-12s n=%ld: DIFFERISCE sul posto\n", "norm_batch", n);
+            errori++;
+        }
+    }
+    printf("verifica bit per bit: %s\n\n", errori ? "FALLITA" : "ok");
+
+    /* ---------- Prestazioni ---------- */
+    const long taglie[] = { 4, 64, grandi };
+    printf("%-12s", "righe/s");
+    for (int t = 0; t < 3; t++)
+        printf(" %14ld", taglie[t]);
+    printf("\n");
+
+    for (int p = 0; p < N_PERCORSI; p++) {
+        printf("%-12s", percorsi[p].nome);
+        for (int t = 0; t < 3; t++)
+            printf(" %14.0f", misura(percorsi[p].f, raw, out, taglie[t]));
+        printf("\n");
+    }
+
+    free(raw);
+    free(rif);
+    free(out);
+    return errori ? 1 : 0;
+}
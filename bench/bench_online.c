@@ -0,0 +1,165 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include "NeuralNetwork.h"
+#include "NN_Online.h"
+#include "bench_comune.h"
+
+/* ============================================================
+ *         APPRENDIMENTO ONLINE DA UNA PIPE DI RIGHE CSV
+ * ============================================================
+ *
+ * Un thread produttore scrive righe sintetiche nel formato
+ * di dataset.csv su una pipe; il thread principale le
+ * consuma con nno_consuma mentre un thread lettore fissa
+ * continuamente lo snapshot pubblicato ed esegue l'inferenza.
+ *
+ * Riporta righe/s, pubblicazioni, inferenze del lettore e la
+ * memoria residente massima a un quarto e alla fine del
+ * flusso: con memoria costante i due valori coincidono.
+ *
+ * Uso: bench_online [n_righe] [batch] [pubblica_ogni]
+ *
+ * Termina con codice 1 se la memoria cresce durante il flusso.
+ */
+
+#define N_HIDDEN     16
+#define BLOCCO       4096    // Righe consumate tra due controlli
+
+typedef struct {
+    FILE *f;
+    long n_righe;
+} Produttore;
+
+/* Righe sintetiche: la classe dipende da ora, luci e movimento */
+static void *produci(void *arg) {
+    Produttore *p = (Produttore*)arg;
+    unsigned long long seme = 1618;
+
+    for (long r = 0; r < p->n_righe; r++) {
+        const int ora = (int)(bench_rand_u64(&seme) % 24);
+        const double luci = bench_uniforme(&seme, 0.0, 1.0);
+        const double mov  = bench_uniforme(&seme, 0.0, 1.0);
+        const int classe = (luci + mov < 0.4) ? ((ora < 7) ? 2 : 0) : 1;
+
+        fprintf(p->f, "%d, %.1f, %.2f, %.2f, %.2f, %.2f, %.1f, %d\n",
+                ora, bench_uniforme(&seme, -2.0, 12.0), luci, mov,
+                bench_uniforme(&seme, 0.0, 8.0),
+                bench_uniforme(&seme, 0.3, 0.6),
+                bench_uniforme(&seme, 15.0, 22.0), classe);
+    }
+    fclose(p->f);
+    return NULL;
+}
+
+typedef struct {
+    NN_Online *online;
+    atomic_int termina;
+    long inferenze;
+} Lettore;
+
+static void *leggi(void *arg) {
+    Lettore *l = (Lettore*)arg;
+    double x[DATASET_N_FEATURE] = { 0.8, 0.5, 0.3, 0.2, 0.3, 0.45, 0.6 };
+    double p[DATASET_N_CLASSI];
+
+    NN_Snapshot *pub = nno_snapshot(l->online);
+    const int lettore = nns_registra(pub);
+    NN_Workspace *ws = nn_workspace_create(nns_fissa(pub, lettore, NULL), 1);
+    nns_rilascia(pub, lettore);
+    if (!ws) return NULL;
+
+    while (!atomic_load(&l->termina)) {
+        const NeuralNetwork *snap = nns_fissa(pub, lettore, NULL);
+        const int esito = nn_forward_batch(snap, x, 1, p, ws);
+        nns_rilascia(pub, lettore);
+        if (esito != 0) break;
+        l->inferenze++;
+    }
+
+    nn_workspace_free(ws);
+    nns_deregistra(pub, lettore);
+    return NULL;
+}
+
+static long rss_massima_kb(void) {
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    return ru.ru_maxrss;
+}
+
+int main(int argc, char **argv) {
+    const long n_righe = (argc > 1) ? atol(argv[1]) : 2000000;
+    const int batch    = (argc > 2) ? atoi(argv[2]) : 8;
+    const int ogni     = (argc > 3) ? atoi(argv[3]) : 16;
+    if (n_righe < 4 || batch < 1 || ogni < 1) {
+        fprintf(stderr, "uso: %s [n_righe] [batch] [pubblica_ogni]\n", argv[0]);
+        return 2;
+    }
+
+    NeuralNetwork *net = nn_create(DATASET_N_FEATURE, N_HIDDEN,
+                                   DATASET_N_CLASSI, 0.01, 0.001, 42);
+    NN_Online *online = net ? nno_crea(net, batch, ogni, 1) : NULL;
+    int fd[2];
+    if (!online || pipe(fd) != 0) {
+        fprintf(stderr, "impossibile inizializzare il modo online\n");
+        return 2;
+    }
+
+    Produttore prod = { fdopen(fd[1], "w"), n_righe };
+    FILE *flusso = fdopen(fd[0], "r");
+    Lettore lett = { .online = online, .inferenze = 0 };
+    atomic_init(&lett.termina, 0);
+
+    pthread_t t_prod, t_lett;
+    if (!prod.f || !flusso ||
+        pthread_create(&t_prod, NULL, produci, &prod) != 0 ||
+        pthread_create(&t_lett, NULL, leggi, &lett) != 0) {
+        fprintf(stderr, "impossibile avviare i thread\n");
+        return 2;
+    }
+
+    long rss_quarto = 0, lette = 0, n;
+    const double t0 = orologio_secondi();
+
+    while ((n = nno_consuma(online, flusso, "pipe", BLOCCO)) > 0) {
+        lette += n;
+        if (rss_quarto == 0 && lette >= n_righe / 4)
+            rss_quarto = rss_massima_kb();
+    }
+
+    const double t = orologio_secondi() - t0;
+    const long rss_fine = rss_massima_kb();
+
+    atomic_store(&lett.termina, 1);
+    pthread_join(t_prod, NULL);
+    pthread_join(t_lett, NULL);
+    fclose(flusso);
+
+    NNO_Statistiche st;
+    nno_statistiche(online, &st);
+
+    printf("righe %ld | batch %d | pubblica ogni %d passi\n\n",
+           st.righe, batch, ogni);
+    printf("righe/s          %12.0f  (%.0f ns/riga)\n",
+           st.righe / t, t / st.righe * 1e9);
+    printf("aggiornamenti    %12ld\n", st.aggiornamenti);
+    if (st.falliti)
+        printf("passi falliti    %12ld\n", st.falliti);
+    printf("pubblicazioni    %12ld  (copie allocate %d)\n",
+           st.pubblicazioni, nns_copie(nno_snapshot(online)));
+    printf("inferenze        %12ld  (lettore concorrente)\n", lett.inferenze);
+    printf("scartate         %12ld\n", st.scartate);
+    printf("RSS max [KiB]    %12ld  a 1/4, %ld alla fine\n",
+           rss_quarto, rss_fine);
+
+    nno_free(online);
+    nn_free(net);
+
+    return (rss_fine > rss_quarto) ? 1 : 0;
+}
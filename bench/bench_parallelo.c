@@ -0,0 +1,151 @@
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "NeuralNetwork.h"
+#include "NN_Parallelo.h"
+#include "bench_comune.h"
+
+/* ============================================================
+ *        SCALABILITÀ DEL TRAINING DATA-PARALLELO
+ * ============================================================
+ *
+ * Su un dataset sintetico con le dimensioni della rete reale
+ * (7 input, 16 hidden, 3 classi):
+ *  1) misura i campioni/s a 1, 2, 4, 8 e N thread
+ *     (N = argomento, oppure il numero di core disponibili)
+ *  2) ripete ogni configurazione partendo dagli stessi pesi e
+ *     verifica che i parametri finali coincidano bit per bit
+ *
+ * Uso: bench_parallelo [n_thread_max] [n_campioni] [batch]
+ *
+ * Termina con codice 1 se una ripetizione non è riproducibile.
+ */
+
+#define N_INPUT     7
+#define N_HIDDEN    16
+#define N_OUTPUT    3
+#define EPOCHE      5
+
+/*
+ * Dataset sintetico: la classe dipende da due combinazioni
+ * lineari delle feature, così il gradiente non è banale.
+ */
+static void genera(double *X, double *Y, int n) {
+    unsigned long long seme = 2024;
+
+    for (int r = 0; r < n; r++) {
+        double *x = &X[(size_t)r * N_INPUT];
+        for (int i = 0; i < N_INPUT; i++)
+            x[i] = bench_uniforme(&seme, 0.0, 1.0);
+
+        int c = 0;
+        if (x[0] + x[3] > 1.2) c = 1;
+        else if (x[1] - x[5] > 0.3) c = 2;
+
+        double *y = &Y[(size_t)r * N_OUTPUT];
+        for (int o = 0; o < N_OUTPUT; o++)
+            y[o] = (o == c) ? 1.0 : 0.0;
+    }
+}
+
+/*
+ * Addestra 'net' per EPOCHE epoche con il pool dato.
+ * Ritorna i secondi impiegati.
+ */
+static double addestra(NN_Parallelo *pool, NeuralNetwork *net,
+                       const double *X, const double *Y,
+                       int n, int batch) {
+    double t0 = orologio_secondi();
+
+    for (int e = 0; e < EPOCHE; e++)
+        for (int r = 0; r < n; r += batch) {
+            int b = (n - r < batch) ? n - r : batch;
+            nnp_train_batch(pool, net,
+                            &X[(size_t)r * N_INPUT],
+                            &Y[(size_t)r * N_OUTPUT], b);
+        }
+
+    return orologio_secondi() - t0;
+}
+
+int main(int argc, char **argv) {
+    long core = sysconf(_SC_NPROCESSORS_ONLN);
+    int n_max   = (argc > 1) ? atoi(argv[1]) : (int)(core > 0 ? core : 1);
+    int n       = (argc > 2) ? atoi(argv[2]) : 200000;
+    int batch   = (argc > 3) ? atoi(argv[3]) : 256;
+
+    if (n_max < 1 || n < 1 || batch < 1) {
+        fprintf(stderr, "uso: %s [n_thread_max] [n_campioni] [batch]\n",
+                argv[0]);
+        return 2;
+    }
+
+    double *X = (double*)malloc((size_t)n * N_INPUT * sizeof(double));
+    double *Y = (double*)malloc((size_t)n * N_OUTPUT * sizeof(double));
+    if (!X || !Y) {
+        fprintf(stderr, "memoria insufficiente\n");
+        return 2;
+    }
+    genera(X, Y, n);
+
+    NeuralNetwork *iniziale = nn_create(N_INPUT, N_HIDDEN, N_OUTPUT,
+                                        0.01, 0.0001, 7);
+    NeuralNetwork *a = nn_clone(iniziale);
+    NeuralNetwork *b = nn_clone(iniziale);
+    if (!iniziale || !a || !b) {
+        fprintf(stderr, "memoria insufficiente\n");
+        return 2;
+    }
+
+    /* Configurazioni 1, 2, 4, 8 (fino a N) e infine N */
+    int thread[8], n_config = 0;
+    for (int t = 1; t <= 8 && t <= n_max; t *= 2)
+        thread[n_config++] = t;
+    if (thread[n_config - 1] != n_max)
+        thread[n_config++] = n_max;
+
+    printf("campioni %d | batch %d | epoche %d | core disponibili %ld\n\n",
+           n, batch, EPOCHE, core);
+    printf("thread   campioni/s   speedup   riproducibile\n");
+
+    int errori = 0;
+    double base = 0.0;
+
+    for (int c = 0; c < n_config; c++) {
+        NN_Parallelo *pool = nnp_crea(iniziale, thread[c], batch);
+        if (!pool) {
+            fprintf(stderr, "impossibile creare il pool a %d thread\n", thread[c]);
+            return 2;
+        }
+
+        nn_copia_parametri(a, iniziale);
+        nn_copia_parametri(b, iniziale);
+
+        double t = addestra(pool, a, X, Y, n, batch);
+        addestra(pool, b, X, Y, n, batch);
+
+        int uguali = memcmp(a->parametri, b->parametri,
+                            (size_t)a->num_parametri * sizeof(double)) == 0;
+        if (!uguali) errori++;
+
+        double velocita = (double)n * EPOCHE / t;
+        if (c == 0) base = velocita;
+
+        printf("%6d   %10.0f   %7.2fx   %s\n",
+               thread[c], velocita, velocita / base,
+               uguali ? "si" : "NO");
+
+        nnp_free(pool);
+    }
+
+    nn_free(iniziale);
+    nn_free(a);
+    nn_free(b);
+    free(X);
+    free(Y);
+
+    return errori ? 1 : 0;
+}
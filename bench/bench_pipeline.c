@@ -0,0 +1,343 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "Dataset.h"
+#include "NeuralNetwork.h"
+#include "Incertezza.h"
+#include "PL_Scheduler.h"
+#include "bench_comune.h"
+
+/* ============================================================
+ *       PIPELINE COMPLETA: TEMPI PER FASE (PARSE → PL)
+ * ============================================================
+ *
+ * Genera un dataset sintetico di 'righe' righe (file CSV
+ * temporaneo nel formato di dataset.csv) e un condominio di
+ * 'appartamenti' appartamenti, poi misura separatamente le
+ * fasi di main:
+ *
+ *   parse    caricamento e normalizzazione del CSV
+ *   train    un'epoca di nn_train in ordine rimescolato
+ *   infer    nn_forward_batch su tutti gli appartamenti
+ *   eu       utilita_attesa_batch su tutti gli appartamenti
+ *   pl       pl_risolvi sul piano del condominio
+ *   tick     infer + eu + pl (un aggiornamento completo)
+ *
+ * Ogni fase esegue 'riscaldamento' ripetizioni non misurate
+ * e 'ripetizioni' misurate; per ciascuna riporta throughput
+ * (elementi/s) e latenza p50/p95/p99 di una ripetizione, in
+ * JSON o CSV per confrontare versioni diverse.
+ *
+ * Uso: bench_pipeline [-r righe] [-a appartamenti]
+ *                     [-n ripetizioni] [-w riscaldamento]
+ *                     [-f json|csv] [-o file]
+ */
+
+#define N_HIDDEN    16
+#define SEME        42
+
+typedef struct {
+    int righe;
+    int appartamenti;
+
+    char csv[64];               // Dataset temporaneo
+    Dataset *ds;
+    int *ordine;
+    NeuralNetwork *net;
+    NN_Workspace *ws;
+    PL_Scheduler *pl;
+    PL_Risultato piano;
+
+    /* Condominio: input normalizzati e risultati per fase */
+    double *X;                  // [appartamenti][N_FEATURE]
+    double *t_int, *t_ext, *price;
+    double *P;                  // [appartamenti][N_CLASSI]
+    double *pa, *ph, *ps;       // P(stato) in formato SoA
+    double *eu, *occ, *risk;
+} Contesto;
+
+typedef struct {
+    const char *nome;
+    void (*esegui)(Contesto *c);
+    int elementi;               // Elementi elaborati per ripetizione
+} Fase;
+
+/* ============================================================
+ * DATI SINTETICI
+ * ============================================================ */
+
+static int scrivi_csv(Contesto *c, unsigned long long *seme) {
+    strcpy(c->csv, "/tmp/bench_pipeline_XXXXXX");
+    const int fd = mkstemp(c->csv);
+    if (fd < 0) return -1;
+    FILE *f = fdopen(fd, "w");
+    if (!f) {
+        close(fd);
+        return -1;
+    }
+
+    for (int r = 0; r < c->righe; r++) {
+        const int ora = (int)(bench_rand_u64(seme) % 24);
+        const double luci = bench_uniforme(seme, 0.0, 1.0);
+        const double mov  = bench_uniforme(seme, 0.0, 1.0);
+        const int classe = (luci + mov < 0.4) ? ((ora < 7) ? 2 : 0) : 1;
+
+        fprintf(f, "%d, %.1f, %.2f, %.2f, %.2f, %.2f, %.1f, %d\n",
+                ora, bench_uniforme(seme, -2.0, 12.0), luci, mov,
+                bench_uniforme(seme, 0.0, 8.0),
+                bench_uniforme(seme, 0.3, 0.6),
+                bench_uniforme(seme, 15.0, 22.0), classe);
+    }
+
+    return fclose(f);
+}
+
+static int genera_condominio(Contesto *c, unsigned long long *seme) {
+    const size_t n = (size_t)c->appartamenti;
+
+    c->X     = (double*)malloc(n * DATASET_N_FEATURE * sizeof(double));
+    c->P     = (double*)malloc(n * DATASET_N_CLASSI * sizeof(double));
+    c->t_int = (double*)malloc(n * sizeof(double));
+    c->t_ext = (double*)malloc(n * sizeof(double));
+    c->price = (double*)malloc(n * sizeof(double));
+    c->pa    = (double*)malloc(n * sizeof(double));
+    c->ph    = (double*)malloc(n * sizeof(double));
+    c->ps    = (double*)malloc(n * sizeof(double));
+    c->eu    = (double*)malloc(n * sizeof(double));
+    c->occ   = (double*)malloc(n * sizeof(double));
+    c->risk  = (double*)malloc(n * sizeof(double));
+    if (!c->X || !c->P || !c->t_int || !c->t_ext || !c->price || !c->pa ||
+        !c->ph || !c->ps || !c->eu || !c->occ || !c->risk) return -1;
+
+    for (size_t i = 0; i < n; i++) {
+        double raw[DATASET_N_FEATURE] = {
+            19.0,
+            bench_uniforme(seme, -2.0, 12.0),
+            bench_uniforme(seme, 0.0, 1.0),
+            bench_uniforme(seme, 0.0, 1.0),
+            bench_uniforme(seme, 0.0, 8.0),
+            bench_uniforme(seme, 0.3, 0.6),
+            bench_uniforme(seme, 15.0, 22.0)
+        };
+        norm_riga(raw, &c->X[i * DATASET_N_FEATURE]);
+        c->t_ext[i] = raw[1];
+        c->price[i] = raw[5];
+        c->t_int[i] = raw[6];
+    }
+    return 0;
+}
+
+/* ============================================================
+ * FASI
+ * ============================================================ */
+
+static void fase_parse(Contesto *c) {
+    Dataset *ds = dataset_carica_csv(c->csv);
+    dataset_free(ds);
+}
+
+static void fase_train(Contesto *c) {
+    nn_mescola(c->net, c->ordine, c->ds->n_righe);
+
+    for (int k = 0; k < c->ds->n_righe; k++) {
+        const int r = c->ordine[k];
+        double target[DATASET_N_CLASSI] = { 0, 0, 0 };
+        target[c->ds->y[r]] = 1.0;
+        nn_train(c->net, &c->ds->X[(size_t)r * DATASET_N_FEATURE], target);
+    }
+}
+
+/* Compatibilità di rete e workspace verificata in preparazione */
+static void fase_infer(Contesto *c) {
+    nn_forward_batch(c->net, c->X, c->appartamenti, c->P, c->ws);
+}
+
+static void fase_eu(Contesto *c) {
+    for (int i = 0; i < c->appartamenti; i++) {
+        c->pa[i] = c->P[i * DATASET_N_CLASSI + STATO_AWAY];
+        c->ph[i] = c->P[i * DATASET_N_CLASSI + STATO_HOME];
+        c->ps[i] = c->P[i * DATASET_N_CLASSI + STATO_SLEEP];
+    }
+    utilita_attesa_batch(c->pa, c->ph, c->ps, c->t_int, c->t_ext,
+                         c->appartamenti, c->eu);
+}
+
+static void fase_pl(Contesto *c) {
+    for (int i = 0; i < c->appartamenti; i++) {
+        c->occ[i]  = c->ph[i] + c->ps[i];
+        c->risk[i] = c->pa[i];
+    }
+
+    /* Vincoli proporzionali al condominio, come in main
+     * (budget 1.2 e rischio 0.1 per 4 appartamenti) */
+    pl_risolvi(c->pl, c->occ, c->price, c->eu, c->risk,
+               0.3 * c->appartamenti, 0.025 * c->appartamenti, &c->piano);
+}
+
+static void fase_tick(Contesto *c) {
+    fase_infer(c);
+    fase_eu(c);
+    fase_pl(c);
+}
+
+/* ============================================================
+ * MISURA E REPORT
+ * ============================================================ */
+
+static int confronta_double(const void *a, const void *b) {
+    const double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+/* Percentile per rango più vicino su un vettore ordinato */
+static double percentile(const double *v, int n, double p) {
+    int k = (int)(p * n + 0.999999) - 1;
+    if (k < 0) k = 0;
+    if (k >= n) k = n - 1;
+    return v[k];
+}
+
+int main(int argc, char **argv) {
+    Contesto c;
+    memset(&c, 0, sizeof(c));
+    c.righe = 20000;
+    c.appartamenti = 1000;
+    int ripetizioni = 30, riscaldamento = 3, csv = 0, errato = 0;
+    const char *uscita = NULL;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "r:a:n:w:f:o:")) != -1) {
+        switch (opt) {
+            case 'r': c.righe = atoi(optarg); break;
+            case 'a': c.appartamenti = atoi(optarg); break;
+            case 'n': ripetizioni = atoi(optarg); break;
+            case 'w': riscaldamento = atoi(optarg); break;
+            case 'f':
+                if (strcmp(optarg, "csv") == 0)       csv = 1;
+                else if (strcmp(optarg, "json") == 0) csv = 0;
+                else                                  errato = 1;
+                break;
+            case 'o': uscita = optarg; break;
+            default:  errato = 1;
+        }
+    }
+    if (errato || optind < argc ||
+        c.righe < 1 || c.appartamenti < 1 || ripetizioni < 1 ||
+        riscaldamento < 0) {
+        fprintf(stderr, "uso: %s [-r righe] [-a appartamenti] [-n ripetizioni] "
+                "[-w riscaldamento] [-f json|csv] [-o file]\n", argv[0]);
+        return 2;
+    }
+
+    /* ---------- Preparazione ---------- */
+    unsigned long long seme = 7;
+    if (scrivi_csv(&c, &seme) != 0 ||
+        !(c.ds = dataset_carica_csv(c.csv)) ||
+        !(c.ordine = (int*)malloc((size_t)c.ds->n_righe * sizeof(int))) ||
+        !(c.net = nn_create(DATASET_N_FEATURE, N_HIDDEN, DATASET_N_CLASSI,
+                            0.01, 0.001, SEME)) ||
+        !(c.ws = nn_workspace_create(c.net, 256)) ||
+        !(c.pl = pl_crea(c.appartamenti)) ||
+        pl_risultato_init(&c.piano, c.appartamenti) != 0 ||
+        genera_condominio(&c, &seme) != 0 ||
+        nn_forward_batch(c.net, c.X, c.appartamenti, c.P, c.ws) != 0) {
+        fprintf(stderr, "impossibile preparare la pipeline\n");
+        if (c.csv[0]) unlink(c.csv);
+        return 2;
+    }
+    for (int r = 0; r < c.ds->n_righe; r++)
+        c.ordine[r] = r;
+
+    FILE *out = uscita ? fopen(uscita, "w") : stdout;
+    double *tempi = (double*)malloc((size_t)ripetizioni * sizeof(double));
+    if (!out || !tempi) {
+        fprintf(stderr, "impossibile scrivere i risultati\n");
+        unlink(c.csv);
+        return 2;
+    }
+
+    const Fase fasi[] = {
+        { "parse", fase_parse, c.righe },
+        { "train", fase_train, c.ds->n_righe },
+        { "infer", fase_infer, c.appartamenti },
+        { "eu",    fase_eu,    c.appartamenti },
+        { "pl",    fase_pl,    c.appartamenti },
+        { "tick",  fase_tick,  c.appartamenti }
+    };
+    const int n_fasi = (int)(sizeof(fasi) / sizeof(fasi[0]));
+
+    if (csv) {
+        fprintf(out, "fase,elementi,ripetizioni,throughput_s,"
+                     "media_us,p50_us,p95_us,p99_us\n");
+    } else {
+        fprintf(out, "{\n  \"parametri\": { \"righe\": %d, \"appartamenti\": %d, "
+                     "\"ripetizioni\": %d, \"riscaldamento\": %d },\n"
+                     "  \"fasi\": [\n",
+                c.righe, c.appartamenti, ripetizioni, riscaldamento);
+    }
+
+    /* ---------- Misura ---------- */
+    for (int k = 0; k < n_fasi; k++) {
+        const Fase *f = &fasi[k];
+
+        for (int r = 0; r < riscaldamento; r++)
+            f->esegui(&c);
+
+        double totale = 0.0;
+        for (int r = 0; r < ripetizioni; r++) {
+            const double t0 = orologio_secondi();
+            f->esegui(&c);
+            tempi[r] = orologio_secondi() - t0;
+            totale += tempi[r];
+        }
+        qsort(tempi, (size_t)ripetizioni, sizeof(double), confronta_double);
+
+        const double thr = (double)f->elementi * ripetizioni / totale;
+        const double media = totale / ripetizioni * 1e6;
+        const double p50 = percentile(tempi, ripetizioni, 0.50) * 1e6;
+        const double p95 = percentile(tempi, ripetizioni, 0.95) * 1e6;
+        const double p99 = percentile(tempi, ripetizioni, 0.99) * 1e6;
+
+        if (csv)
+            fprintf(out, "%s,%d,%d,%.1f,%.3f,%.3f,%.3f,%.3f\n",
+                    f->nome, f->elementi, ripetizioni, thr,
+                    media, p50, p95, p99);
+        else
+            fprintf(out, "    { \"fase\": \"%s\", \"elementi\": %d, "
+                         "\"throughput_s\": %.1f, \"media_us\": %.3f, "
+                         "\"p50_us\": %.3f, \"p95_us\": %.3f, "
+                         "\"p99_us\": %.3f }%s\n",
+                    f->nome, f->elementi, thr, media, p50, p95, p99,
+                    (k + 1 < n_fasi) ? "," : "");
+    }
+
+    if (!csv)
+        fprintf(out, "  ]\n}\n");
+
+    if (uscita) fclose(out);
+    unlink(c.csv);
+
+    free(tempi);
+    free(c.ordine);
+    dataset_free(c.ds);
+    nn_workspace_free(c.ws);
+    nn_free(c.net);
+    pl_free(c.pl);
+    pl_risultato_libera(&c.piano);
+    free(c.X);
+    free(c.P);
+    free(c.t_int);
+    free(c.t_ext);
+    free(c.price);
+    free(c.pa);
+    free(c.ph);
+    free(c.ps);
+    free(c.eu);
+    free(c.occ);
+    free(c.risk);
+
+    return 0;
+}
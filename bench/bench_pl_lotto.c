@@ -0,0 +1,221 @@
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <unistd.h>
+#include "PL_Scheduler.h"
+#include "PL_Lotto.h"
+#include "bench_comune.h"
+
+/* ============================================================
+ *        PIANIFICAZIONE DI MOLTI EDIFICI SULLO STESSO TICK
+ * ============================================================
+ *
+ * n_edifici condomini da 8 a 64 appartamenti ripianificano
+ * per TICK volte, con piccole variazioni di prezzi e
+ * probabilità tra un tick e l'altro:
+ *  1) riferimento: un PL_Scheduler per edificio, risolti uno
+ *     dopo l'altro nel thread chiamante
+ *  2) PL_Lotto a 1, 2, 4, 8 e N thread
+ *     (N = argomento, oppure il numero di core disponibili)
+ *
+ * Per ogni configurazione stampa edifici/s, speedup sul
+ * lotto a un thread, intervalli rubati e se il valore
+ * dell'obiettivo di ogni edificio coincide con il riferimento.
+ *
+ * Uso: bench_pl_lotto [n_edifici] [n_thread_max] [simplex]
+ *      simplex = 1 disattiva il percorso rapido
+ *
+ * Termina con codice 1 se un obiettivo differisce.
+ */
+
+#define TICK        20
+#define N_MIN       8
+#define N_MAX       64
+#define TOLLERANZA  1e-7    // Sull'obiettivo, relativa
+
+typedef struct {
+    int n;
+    double *occ, *price, *gain, *risk;
+} Dati;
+
+static void genera(Dati *d, unsigned long long *seme) {
+    for (int i = 0; i < d->n; i++) {
+        d->occ[i]   = bench_uniforme(seme, 0.0, 1.0);
+        d->price[i] = bench_uniforme(seme, 0.30, 0.60);
+        d->gain[i]  = bench_uniforme(seme, 0.0, 2.0);
+        d->risk[i]  = 1.0 - d->occ[i];
+    }
+}
+
+static void perturba(Dati *d, unsigned long long *seme) {
+    for (int i = 0; i < d->n; i++) {
+        double p = d->occ[i] + bench_uniforme(seme, -0.05, 0.05);
+        d->occ[i]   = p < 0.0 ? 0.0 : (p > 1.0 ? 1.0 : p);
+        d->price[i] += bench_uniforme(seme, -0.01, 0.01);
+        d->risk[i]  = 1.0 - d->occ[i];
+    }
+}
+
+static double obiettivo(const Dati *d, const PL_Risultato *r) {
+    double f = 0.0;
+    for (int i = 0; i < d->n; i++)
+        f += r->power[i] * (d->occ[i] * d->gain[i] - d->price[i]);
+    return f;
+}
+
+/* Edifici con dati rigenerati dallo stesso seme a ogni chiamata */
+static void prepara(Dati *d, PL_Edificio *e, int n_edifici) {
+    unsigned long long seme = 31337;
+    for (int b = 0; b < n_edifici; b++) {
+        genera(&d[b], &seme);
+        e[b] = (PL_Edificio){
+            d[b].n, d[b].occ, d[b].price, d[b].gain, d[b].risk,
+            0.2 * d[b].n, 0.1 * d[b].n
+        };
+    }
+}
+
+static void avanza(Dati *d, int n_edifici, unsigned long long *seme) {
+    for (int b = 0; b < n_edifici; b++)
+        perturba(&d[b], seme);
+}
+
+int main(int argc, char **argv) {
+    long core = sysconf(_SC_NPROCESSORS_ONLN);
+    int n_edifici = (argc > 1) ? atoi(argv[1]) : 500;
+    int n_max     = (argc > 2) ? atoi(argv[2]) : (int)(core > 0 ? core : 1);
+    int simplex   = (argc > 3) ? atoi(argv[3]) : 0;
+
+    if (n_edifici < 1 || n_max < 1) {
+        fprintf(stderr, "uso: %s [n_edifici] [n_thread_max] [simplex]\n",
+                argv[0]);
+        return 2;
+    }
+
+    Dati *d = (Dati*)calloc((size_t)n_edifici, sizeof(Dati));
+    PL_Edificio *e = (PL_Edificio*)calloc((size_t)n_edifici, sizeof(PL_Edificio));
+    PL_Risultato *res = (PL_Risultato*)calloc((size_t)n_edifici, sizeof(PL_Risultato));
+    double *rif = (double*)malloc((size_t)n_edifici * sizeof(double));
+    if (!d || !e || !res || !rif) {
+        fprintf(stderr, "memoria insufficiente\n");
+        return 2;
+    }
+
+    unsigned long long seme = 99;
+    for (int b = 0; b < n_edifici; b++) {
+        Dati *x = &d[b];
+        x->n     = N_MIN + (int)(bench_rand_u64(&seme) % (N_MAX - N_MIN + 1));
+        x->occ   = (double*)malloc((size_t)x->n * sizeof(double));
+        x->price = (double*)malloc((size_t)x->n * sizeof(double));
+        x->gain  = (double*)malloc((size_t)x->n * sizeof(double));
+        x->risk  = (double*)malloc((size_t)x->n * sizeof(double));
+        if (!x->occ || !x->price || !x->gain || !x->risk ||
+            pl_risultato_init(&res[b], x->n) != 0) {
+            fprintf(stderr, "memoria insufficiente\n");
+            return 2;
+        }
+    }
+
+    /* ---------- 1) Riferimento sequenziale ---------- */
+    PL_Scheduler **s = (PL_Scheduler**)calloc((size_t)n_edifici, sizeof(PL_Scheduler*));
+    if (!s) {
+        fprintf(stderr, "memoria insufficiente\n");
+        return 2;
+    }
+    for (int b = 0; b < n_edifici; b++) {
+        if (!(s[b] = pl_crea(d[b].n))) {
+            fprintf(stderr, "impossibile creare il problema %d\n", b);
+            return 2;
+        }
+        pl_imposta_rapido(s[b], !simplex);
+    }
+
+    prepara(d, e, n_edifici);
+    seme = 7;
+    double t_seq = 0.0;
+    for (int t = 0; t < TICK; t++) {
+        const double t0 = orologio_secondi();
+        for (int b = 0; b < n_edifici; b++)
+            pl_risolvi(s[b], d[b].occ, d[b].price, d[b].gain, d[b].risk,
+                       e[b].budget, e[b].risk_max, &res[b]);
+        t_seq += orologio_secondi() - t0;
+        if (t + 1 < TICK) avanza(d, n_edifici, &seme);
+    }
+    for (int b = 0; b < n_edifici; b++) {
+        rif[b] = obiettivo(&d[b], &res[b]);
+        pl_free(s[b]);
+    }
+    free(s);
+
+    /* ---------- 2) Lotto ---------- */
+    int thread[8], n_config = 0;
+    for (int t = 1; t <= 8 && t <= n_max; t *= 2)
+        thread[n_config++] = t;
+    if (thread[n_config - 1] != n_max)
+        thread[n_config++] = n_max;
+
+    printf("edifici %d (%d-%d appartamenti) | tick %d | %s | core disponibili %ld\n\n",
+           n_edifici, N_MIN, N_MAX, TICK,
+           simplex ? "solo simplex" : "percorso rapido", core);
+    printf("%-12s %12s %9s %8s   %s\n",
+           "thread", "edifici/s", "speedup", "furti", "coincidenti");
+    printf("%-12s %12.0f %9s %8s   %s\n", "sequenziale",
+           (double)n_edifici * TICK / t_seq, "", "", "-");
+
+    int errori = 0;
+    double base = 0.0;
+
+    for (int c = 0; c < n_config; c++) {
+        PL_Lotto *l = pll_crea(thread[c]);
+        if (!l) {
+            fprintf(stderr, "impossibile creare il pool a %d thread\n", thread[c]);
+            return 2;
+        }
+        pll_imposta_rapido(l, !simplex);
+
+        prepara(d, e, n_edifici);
+        seme = 7;
+        double t_lotto = 0.0;
+        for (int t = 0; t < TICK; t++) {
+            const double t0 = orologio_secondi();
+            pll_risolvi(l, e, n_edifici, res, NULL);
+            t_lotto += orologio_secondi() - t0;
+            if (t + 1 < TICK) avanza(d, n_edifici, &seme);
+        }
+
+        int uguali = 1;
+        for (int b = 0; b < n_edifici; b++)
+            if (fabs(obiettivo(&d[b], &res[b]) - rif[b]) >
+                TOLLERANZA * (1.0 + fabs(rif[b])))
+                uguali = 0;
+        if (!uguali) errori++;
+
+        PLL_Statistiche st;
+        pll_statistiche(l, &st);
+
+        const double velocita = (double)n_edifici * TICK / t_lotto;
+        if (c == 0) base = velocita;
+
+        printf("%-12d %12.0f %8.2fx %8ld   %s\n",
+               thread[c], velocita, velocita / base, st.furti,
+               uguali ? "si" : "NO");
+
+        pll_free(l);
+    }
+
+    for (int b = 0; b < n_edifici; b++) {
+        free(d[b].occ);
+        free(d[b].price);
+        free(d[b].gain);
+        free(d[b].risk);
+        pl_risultato_libera(&res[b]);
+    }
+    free(d);
+    free(e);
+    free(res);
+    free(rif);
+
+    return errori ? 1 : 0;
+}
@@ -0,0 +1,182 @@
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "PL_Orizzonte.h"
+#include "bench_comune.h"
+
+/* ============================================================
+ *     LATENZA DELLA PL MULTI-PERIODO SU ORIZZONTE MOBILE
+ * ============================================================
+ *
+ * Per orizzonti di 4, 12, 24, 48 e 96 quarti d'ora (fino a
+ * un giorno) e n_app appartamenti misura:
+ *  - costruzione del problema
+ *  - prima risoluzione a freddo
+ *  - TICK risoluzioni successive sull'orizzonte mobile,
+ *    ciascuna ripartita dalla base traslata di un periodo
+ *
+ * I dati seguono un giorno tipico: prezzo con picco serale,
+ * temperatura esterna sinusoidale, occupazione notturna e
+ * serale con variazioni per appartamento.
+ *
+ * Uso: bench_pl_orizzonte [n_app]
+ */
+
+#define TICK            8
+#define DUE_PI          6.283185307179586
+#define QUARTI_GIORNO   96
+
+static const int orizzonti[] = { 4, 12, 24, 48, 96 };
+#define N_ORIZZONTI ((int)(sizeof(orizzonti) / sizeof(orizzonti[0])))
+
+/* Serie temporali lunghe quanto orizzonte + TICK */
+typedef struct {
+    double *price, *t_ext, *budget;
+    double *occ;            // [n_app][lunghezza]
+    int lunghezza;
+} Serie;
+
+static double ora_del_giorno(int q) {
+    return (double)(q % QUARTI_GIORNO) / 4.0;
+}
+
+static int genera_serie(Serie *s, int n_app, int lunghezza,
+                        unsigned long long *seme) {
+    s->lunghezza = lunghezza;
+    s->price  = (double*)malloc((size_t)lunghezza * sizeof(double));
+    s->t_ext  = (double*)malloc((size_t)lunghezza * sizeof(double));
+    s->budget = (double*)malloc((size_t)lunghezza * sizeof(double));
+    s->occ    = (double*)malloc((size_t)n_app * lunghezza * sizeof(double));
+    if (!s->price || !s->t_ext || !s->budget || !s->occ) return -1;
+
+    for (int q = 0; q < lunghezza; q++) {
+        const double h = ora_del_giorno(q);
+        const double picco = (h >= 17.0 && h < 21.0) ? 0.35 : 0.0;
+        s->price[q]  = 0.25 + picco + 0.05 * sin(h / 24.0 * DUE_PI);
+        s->t_ext[q]  = 5.0 + 4.0 * sin((h - 9.0) / 24.0 * DUE_PI);
+        s->budget[q] = 0.4 * n_app * 0.30;   // ~40% della flotta a prezzo medio
+    }
+
+    for (int a = 0; a < n_app; a++) {
+        const double anticipo = bench_uniforme(seme, -1.0, 1.0);
+        for (int q = 0; q < lunghezza; q++) {
+            const double h = ora_del_giorno(q) + anticipo;
+            double p = (h < 7.0 || h >= 18.0) ? 0.9 : 0.2;
+            p += bench_uniforme(seme, -0.1, 0.1);
+            s->occ[(size_t)a * lunghezza + q] = p < 0.0 ? 0.0 : (p > 1.0 ? 1.0 : p);
+        }
+    }
+
+    return 0;
+}
+
+static void libera_serie(Serie *s) {
+    free(s->price);
+    free(s->t_ext);
+    free(s->budget);
+    free(s->occ);
+}
+
+int main(int argc, char **argv) {
+    const int n_app = (argc > 1) ? atoi(argv[1]) : 300;
+    if (n_app < 1) {
+        fprintf(stderr, "uso: %s [n_app]\n", argv[0]);
+        return 2;
+    }
+
+    printf("appartamenti %d | tick per orizzonte %d\n\n", n_app, TICK);
+    printf("%8s %9s %10s %12s %8s %14s %8s\n",
+           "periodi", "colonne", "crea [ms]", "freddo [ms]", "pivot",
+           "mobile [ms]", "pivot");
+
+    unsigned long long seme = 2718;
+
+    for (int k = 0; k < N_ORIZZONTI; k++) {
+        const int T = orizzonti[k];
+
+        double *alpha  = (double*)malloc((size_t)n_app * sizeof(double));
+        double *beta   = (double*)malloc((size_t)n_app * sizeof(double));
+        double *t_int0 = (double*)malloc((size_t)n_app * sizeof(double));
+        double *occ    = (double*)malloc((size_t)n_app * T * sizeof(double));
+        double *power  = (double*)malloc((size_t)n_app * T * sizeof(double));
+        double *temp   = (double*)malloc((size_t)n_app * T * sizeof(double));
+        Serie s;
+
+        if (!alpha || !beta || !t_int0 || !occ || !power || !temp ||
+            genera_serie(&s, n_app, T + TICK, &seme) != 0) {
+            fprintf(stderr, "memoria insufficiente\n");
+            return 2;
+        }
+
+        for (int a = 0; a < n_app; a++) {
+            alpha[a]  = bench_uniforme(&seme, 0.90, 0.98);
+            beta[a]   = bench_uniforme(&seme, 0.6, 1.2);
+            t_int0[a] = bench_uniforme(&seme, 16.0, 19.0);
+        }
+
+        double t0 = orologio_secondi();
+        PL_Orizzonte *o = plo_crea(n_app, T, alpha, beta);
+        const double t_crea = orologio_secondi() - t0;
+        if (!o) {
+            fprintf(stderr, "impossibile creare il problema (T = %d)\n", T);
+            return 2;
+        }
+
+        PL_Statistiche freddo = {0}, st;
+        double t_mobile = 0.0;
+        long pivot_mobile = 0;
+        int falliti = 0;
+
+        for (int tick = 0; tick <= TICK; tick++) {
+            /* Finestra corrente delle serie */
+            for (int a = 0; a < n_app; a++)
+                for (int t = 0; t < T; t++)
+                    occ[a * T + t] = s.occ[(size_t)a * s.lunghezza + tick + t];
+
+            PLO_Dati d = {
+                .price     = &s.price[tick],
+                .t_ext     = &s.t_ext[tick],
+                .budget    = &s.budget[tick],
+                .occ_prob  = occ,
+                .t_int0    = t_int0,
+                .t_comfort = 20.0,
+                .penalita  = 1.0
+            };
+
+            if (plo_risolvi(o, &d, power, temp) != 0) falliti++;
+            plo_statistiche(o, &st);
+
+            if (tick == 0) {
+                freddo = st;
+            } else {
+                t_mobile += st.tempo;
+                pivot_mobile += st.iterazioni;
+            }
+
+            /* Il primo periodo viene eseguito: la temperatura
+             * prevista diventa quella misurata al tick successivo */
+            for (int a = 0; a < n_app; a++)
+                t_int0[a] = temp[a * T];
+            plo_avanza(o);
+        }
+
+        printf("%8d %9d %10.2f %12.2f %8d %14.2f %8.1f%s\n",
+               T, 3 * n_app * T, t_crea * 1e3,
+               freddo.tempo * 1e3, freddo.iterazioni,
+               t_mobile / TICK * 1e3, (double)pivot_mobile / TICK,
+               falliti ? "  (non ottimo)" : "");
+
+        plo_free(o);
+        libera_serie(&s);
+        free(alpha);
+        free(beta);
+        free(t_int0);
+        free(occ);
+        free(power);
+        free(temp);
+    }
+
+    return 0;
+}
@@ -0,0 +1,122 @@
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "PL_Scheduler.h"
+#include "bench_comune.h"
+
+/* ============================================================
+ *        SCALABILITÀ DELLA PL SUL NUMERO DI APPARTAMENTI
+ * ============================================================
+ *
+ * Per n = 10, 100, ..., n_max (default 100 000) misura:
+ *  - costruzione del problema (pl_crea)
+ *  - prima risoluzione a freddo con il simplex
+ *  - ri-risoluzione con warm start dopo una piccola
+ *    variazione di prezzi e probabilità
+ *  - la stessa ri-risoluzione con il percorso rapido
+ *
+ * Budget e rischio crescono con n, così la frazione di
+ * appartamenti riscaldati resta simile a tutte le scale.
+ *
+ * Uso: bench_pl_scala [n_max]
+ */
+
+typedef struct {
+    double *occ, *price, *gain, *risk;
+} Dati;
+
+static int alloca(Dati *d, int n) {
+    d->occ   = (double*)malloc((size_t)n * sizeof(double));
+    d->price = (double*)malloc((size_t)n * sizeof(double));
+    d->gain  = (double*)malloc((size_t)n * sizeof(double));
+    d->risk  = (double*)malloc((size_t)n * sizeof(double));
+    return (d->occ && d->price && d->gain && d->risk) ? 0 : -1;
+}
+
+static void libera(Dati *d) {
+    free(d->occ);
+    free(d->price);
+    free(d->gain);
+    free(d->risk);
+}
+
+static void genera(Dati *d, int n, unsigned long long *seme) {
+    for (int i = 0; i < n; i++) {
+        d->occ[i]   = bench_uniforme(seme, 0.0, 1.0);
+        d->price[i] = bench_uniforme(seme, 0.30, 0.60);
+        d->gain[i]  = bench_uniforme(seme, 0.0, 2.0);
+        d->risk[i]  = 1.0 - d->occ[i];
+    }
+}
+
+static void perturba(Dati *d, int n, unsigned long long *seme) {
+    for (int i = 0; i < n; i++) {
+        double p = d->occ[i] + bench_uniforme(seme, -0.05, 0.05);
+        d->occ[i]   = p < 0.0 ? 0.0 : (p > 1.0 ? 1.0 : p);
+        d->price[i] += bench_uniforme(seme, -0.01, 0.01);
+        d->risk[i]  = 1.0 - d->occ[i];
+    }
+}
+
+int main(int argc, char **argv) {
+    int n_max = (argc > 1) ? atoi(argv[1]) : 100000;
+    if (n_max < 10) {
+        fprintf(stderr, "uso: %s [n_max >= 10]\n", argv[0]);
+        return 2;
+    }
+
+    printf("%9s %12s %12s %8s %12s %8s %12s\n",
+           "n", "crea [ms]", "freddo [ms]", "pivot", "warm [ms]", "pivot",
+           "rapido [ms]");
+
+    for (long n = 10; n <= n_max; n *= 10) {
+        Dati d;
+        PL_Risultato res;
+        unsigned long long seme = 4242;
+
+        if (alloca(&d, (int)n) != 0 || pl_risultato_init(&res, (int)n) != 0) {
+            fprintf(stderr, "memoria insufficiente per n = %ld\n", n);
+            return 2;
+        }
+        genera(&d, (int)n, &seme);
+
+        const double budget  = 0.2 * (double)n;
+        const double rischio = 0.1 * (double)n;
+
+        double t0 = orologio_secondi();
+        PL_Scheduler *s = pl_crea((int)n);
+        double t_crea = orologio_secondi() - t0;
+        if (!s) {
+            fprintf(stderr, "impossibile creare il problema per n = %ld\n", n);
+            return 2;
+        }
+
+        PL_Statistiche freddo, warm, rapido;
+        pl_imposta_rapido(s, 0);
+        pl_risolvi(s, d.occ, d.price, d.gain, d.risk, budget, rischio, &res);
+        pl_statistiche(s, &freddo);
+
+        perturba(&d, (int)n, &seme);
+        pl_risolvi(s, d.occ, d.price, d.gain, d.risk, budget, rischio, &res);
+        pl_statistiche(s, &warm);
+
+        pl_imposta_rapido(s, 1);
+        pl_risolvi(s, d.occ, d.price, d.gain, d.risk, budget, rischio, &res);
+        pl_statistiche(s, &rapido);
+
+        printf("%9ld %12.3f %12.3f %8d %12.3f %8d %12.3f%s%s\n",
+               n, t_crea * 1e3,
+               freddo.tempo * 1e3, freddo.iterazioni,
+               warm.tempo * 1e3, warm.iterazioni,
+               rapido.tempo * 1e3,
+               rapido.rapido ? "" : " (simplex)",
+               (freddo.esito || warm.esito) ? "  (non ottimo)" : "");
+
+        pl_free(s);
+        pl_risultato_libera(&res);
+        libera(&d);
+    }
+
+    return 0;
+}
@@ -0,0 +1,130 @@
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "PL_Scheduler.h"
+#include "bench_comune.h"
+
+/* ============================================================
+ *        RISOLUZIONI RIPETUTE: A FREDDO E CON WARM START
+ * ============================================================
+ *
+ * Simula il ciclo di controllo: a ogni passo prezzi e
+ * probabilità variano di poco e il piano viene ricalcolato.
+ * Lo stesso flusso di dati viene risolto due volte:
+ *  - a freddo : base standard prima di ogni risoluzione
+ *  - warm     : si riparte dalla base ottima precedente
+ *
+ * Riporta pivot e tempo medi per risoluzione e verifica che
+ * i due modi trovino lo stesso valore dell'obiettivo.
+ * Il percorso rapido è disattivato: si misura solo GLPK.
+ *
+ * Uso: bench_pl_warm [n_slot] [passi]
+ */
+
+#define TOLLERANZA 1e-7
+
+typedef struct {
+    double *occ, *price, *gain, *risk;
+} Dati;
+
+static void alloca(Dati *d, int n) {
+    d->occ   = (double*)malloc((size_t)n * sizeof(double));
+    d->price = (double*)malloc((size_t)n * sizeof(double));
+    d->gain  = (double*)malloc((size_t)n * sizeof(double));
+    d->risk  = (double*)malloc((size_t)n * sizeof(double));
+}
+
+static void libera(Dati *d) {
+    free(d->occ);
+    free(d->price);
+    free(d->gain);
+    free(d->risk);
+}
+
+static double clamp01(double x) {
+    return x < 0.0 ? 0.0 : (x > 1.0 ? 1.0 : x);
+}
+
+/* Stato iniziale e piccola deriva a ogni passo */
+static void genera(Dati *d, int n, unsigned long long *seme, int passo) {
+    for (int i = 0; i < n; i++) {
+        if (passo == 0) {
+            d->occ[i]   = bench_uniforme(seme, 0.0, 1.0);
+            d->price[i] = bench_uniforme(seme, 0.30, 0.60);
+            d->gain[i]  = bench_uniforme(seme, 0.0, 2.0);
+        } else {
+            d->occ[i]   = clamp01(d->occ[i] + bench_uniforme(seme, -0.05, 0.05));
+            d->price[i] += bench_uniforme(seme, -0.01, 0.01);
+        }
+        d->risk[i] = 1.0 - d->occ[i];
+    }
+}
+
+static double obiettivo(const Dati *d, const PL_Risultato *r) {
+    double z = 0.0;
+    for (int i = 0; i < r->n; i++)
+        z += r->power[i] * (d->occ[i] * d->gain[i] - d->price[i]);
+    return z;
+}
+
+int main(int argc, char **argv) {
+    int n     = (argc > 1) ? atoi(argv[1]) : 10;
+    int passi = (argc > 2) ? atoi(argv[2]) : 1000;
+
+    PL_Scheduler *freddo = pl_crea(n);
+    PL_Scheduler *warm   = pl_crea(n);
+    if (!freddo || !warm || passi < 1) {
+        fprintf(stderr, "uso: %s [n_slot] [passi]\n", argv[0]);
+        return 2;
+    }
+    pl_imposta_rapido(freddo, 0);
+    pl_imposta_rapido(warm, 0);
+
+    Dati d;
+    alloca(&d, n);
+
+    PL_Risultato rf, rw;
+    if (!d.occ || !d.price || !d.gain || !d.risk ||
+        pl_risultato_init(&rf, n) != 0 || pl_risultato_init(&rw, n) != 0) {
+        fprintf(stderr, "memoria insufficiente\n");
+        return 2;
+    }
+    unsigned long long seme = 99;
+
+    const double budget   = 0.2 * n;
+    const double rischio  = 0.1 * n;
+    int discordanze = 0;
+
+    for (int p = 0; p < passi; p++) {
+        genera(&d, n, &seme, p);
+
+        pl_reimposta_base(freddo);
+        pl_risolvi(freddo, d.occ, d.price, d.gain, d.risk, budget, rischio, &rf);
+        pl_risolvi(warm, d.occ, d.price, d.gain, d.risk, budget, rischio, &rw);
+
+        double zf = obiettivo(&d, &rf), zw = obiettivo(&d, &rw);
+        if (zf - zw > TOLLERANZA || zw - zf > TOLLERANZA)
+            discordanze++;
+    }
+
+    PL_Statistiche sf, sw;
+    pl_statistiche(freddo, &sf);
+    pl_statistiche(warm, &sw);
+
+    printf("slot %d | passi %d\n\n", n, passi);
+    printf("modo      pivot/ris.   us/ris.\n");
+    printf("freddo    %10.2f   %7.2f\n",
+           (double)sf.iterazioni_totali / passi, sf.tempo_totale / passi * 1e6);
+    printf("warm      %10.2f   %7.2f\n",
+           (double)sw.iterazioni_totali / passi, sw.tempo_totale / passi * 1e6);
+    printf("\nobiettivi discordanti: %d\n", discordanze);
+
+    pl_free(freddo);
+    pl_free(warm);
+    pl_risultato_libera(&rf);
+    pl_risultato_libera(&rw);
+    libera(&d);
+
+    return discordanze ? 1 : 0;
+}
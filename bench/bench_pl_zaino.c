@@ -0,0 +1,141 @@
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "PL_Scheduler.h"
+#include "bench_comune.h"
+
+/* ============================================================
+ *     VALIDAZIONE INCROCIATA: PERCORSO RAPIDO CONTRO GLPK
+ * ============================================================
+ *
+ * Su istanze casuali di varie dimensioni risolve lo stesso
+ * problema con il percorso rapido e con il solo simplex e
+ * confronta il valore dell'obiettivo.
+ *
+ * Le istanze coprono i casi: nessun vincolo attivo, solo
+ * budget, solo rischio, entrambi; metà delle istanze usa
+ * valori discretizzati per generare rapporti pari merito.
+ *
+ * Riporta la frazione di istanze certificate dal percorso
+ * rapido e i tempi medi dei due metodi.
+ *
+ * Uso: bench_pl_zaino [istanze_per_dimensione]
+ *
+ * Termina con codice 1 se un obiettivo differisce.
+ */
+
+#define TOLLERANZA 1e-7
+
+static const int dimensioni[] = { 2, 5, 10, 100, 1000, 10000 };
+#define N_DIMENSIONI ((int)(sizeof(dimensioni) / sizeof(dimensioni[0])))
+
+/* Frazioni di budget e rischio sulla somma dei coefficienti */
+static const double vincoli[4][2] = {
+    { 2.0, 2.0 },   // nessuno attivo
+    { 0.2, 2.0 },   // solo budget
+    { 2.0, 0.1 },   // solo rischio
+    { 0.2, 0.1 }    // entrambi
+};
+
+static double obiettivo(const double *occ, const double *gain,
+                        const double *price, const PL_Risultato *r) {
+    double z = 0.0;
+    for (int i = 0; i < r->n; i++)
+        z += r->power[i] * (occ[i] * gain[i] - price[i]);
+    return z;
+}
+
+int main(int argc, char **argv) {
+    int istanze = (argc > 1) ? atoi(argv[1]) : 200;
+    if (istanze < 1) {
+        fprintf(stderr, "uso: %s [istanze_per_dimensione]\n", argv[0]);
+        return 2;
+    }
+
+    const int n_max = dimensioni[N_DIMENSIONI - 1];
+    double *occ   = (double*)malloc((size_t)n_max * sizeof(double));
+    double *price = (double*)malloc((size_t)n_max * sizeof(double));
+    double *gain  = (double*)malloc((size_t)n_max * sizeof(double));
+    double *risk  = (double*)malloc((size_t)n_max * sizeof(double));
+    if (!occ || !price || !gain || !risk) {
+        fprintf(stderr, "memoria insufficiente\n");
+        return 2;
+    }
+
+    unsigned long long seme = 31337;
+    int discordanze = 0;
+
+    printf("%7s %10s %14s %14s %9s\n",
+           "n", "certif.", "rapido [us]", "GLPK [us]", "speedup");
+
+    for (int k = 0; k < N_DIMENSIONI; k++) {
+        const int n = dimensioni[k];
+        const int ripetizioni = (n >= 10000) ? (istanze + 19) / 20 : istanze;
+
+        PL_Scheduler *rapido = pl_crea(n);
+        PL_Scheduler *glpk   = pl_crea(n);
+        PL_Risultato rr, rg;
+        if (!rapido || !glpk ||
+            pl_risultato_init(&rr, n) != 0 || pl_risultato_init(&rg, n) != 0) {
+            fprintf(stderr, "memoria insufficiente per n = %d\n", n);
+            return 2;
+        }
+        pl_imposta_rapido(glpk, 0);
+
+        for (int t = 0; t < ripetizioni; t++) {
+            const int discreto = t & 1;
+            double somma_p = 0.0, somma_r = 0.0;
+
+            for (int i = 0; i < n; i++) {
+                double o = bench_uniforme(&seme, 0.0, 1.0);
+                if (discreto) o = floor(o * 10.0) / 10.0;
+                occ[i]   = o;
+                gain[i]  = discreto ? 1.0 : bench_uniforme(&seme, 0.0, 2.0);
+                price[i] = discreto ? 0.4 : bench_uniforme(&seme, 0.30, 0.60);
+                risk[i]  = 1.0 - o;
+                somma_p += price[i];
+                somma_r += risk[i];
+            }
+
+            const double *v = vincoli[t % 4];
+            pl_risolvi(rapido, occ, price, gain, risk,
+                       v[0] * somma_p, v[1] * somma_r, &rr);
+            pl_risolvi(glpk, occ, price, gain, risk,
+                       v[0] * somma_p, v[1] * somma_r, &rg);
+
+            double zr = obiettivo(occ, gain, price, &rr);
+            double zg = obiettivo(occ, gain, price, &rg);
+            if (fabs(zr - zg) > TOLLERANZA * fmax(1.0, fabs(zg))) {
+                printf("  n=%d istanza %d: rapido %.12g, GLPK %.12g\n",
+                       n, t, zr, zg);
+                discordanze++;
+            }
+        }
+
+        PL_Statistiche sr, sg;
+        pl_statistiche(rapido, &sr);
+        pl_statistiche(glpk, &sg);
+
+        const double t_r = sr.tempo_totale / ripetizioni * 1e6;
+        const double t_g = sg.tempo_totale / ripetizioni * 1e6;
+        printf("%7d %6ld/%-3d %14.2f %14.2f %8.1fx\n",
+               n, sr.n_rapide, ripetizioni, t_r, t_g,
+               t_r > 0.0 ? t_g / t_r : 0.0);
+
+        pl_free(rapido);
+        pl_free(glpk);
+        pl_risultato_libera(&rr);
+        pl_risultato_libera(&rg);
+    }
+
+    printf("\nobiettivi discordanti: %d\n", discordanze);
+
+    free(occ);
+    free(price);
+    free(gain);
+    free(risk);
+
+    return discordanze ? 1 : 0;
+}
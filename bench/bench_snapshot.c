@@ -0,0 +1,318 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "NeuralNetwork.h"
+#include "NN_Snapshot.h"
+#include "bench_comune.h"
+
+/* ============================================================
+ *     PUBBLICAZIONE SENZA LOCK: STRESS E LATENZA DI INFERENZA
+ * ============================================================
+ *
+ * 1) Stress: SCRITTORI thread pubblicano di continuo copie in
+ *    cui tutti i parametri valgono lo stesso contrassegno;
+ *    n_lettori thread fissano gli snapshot e verificano che
+ *    nessuna copia sia letta a metà di una riscrittura e che
+ *    la versione vista da ciascun lettore non diminuisca.
+ *
+ * 2) Latenza: i lettori misurano fissa + forward + rilascia
+ *    di un campione, senza training, con un thread che
+ *    addestra e pubblica a ogni passo, e per confronto con un
+ *    mutex che protegge la copia condivisa durante la scrittura.
+ *
+ * Uso: bench_snapshot [n_lettori] [secondi_per_fase]
+ *
+ * Termina con codice 1 se lo stress rileva un errore o se una
+ * fase di latenza non raccoglie misure.
+ */
+
+#define N_INPUT      7
+#define N_HIDDEN     16
+#define N_OUTPUT     3
+#define SCRITTORI    2
+#define BATCH        32
+#define MAX_MISURE   (1 << 20)   // Latenze registrate per lettore
+
+static NeuralNetwork *modello;      // Architettura di riferimento
+static NN_Snapshot *pub;
+static atomic_int termina;
+
+/* ============================================================
+ * 1) STRESS
+ * ============================================================ */
+
+typedef struct {
+    int indice;
+    long operazioni;
+    long errori;
+} Stress;
+
+static void *scrivi_stress(void *arg) {
+    Stress *st = (Stress*)arg;
+    NeuralNetwork *net = nn_clone(modello);
+    if (!net) return NULL;
+
+    for (long k = 0; !atomic_load(&termina); k++) {
+        /* Contrassegno univoco per scrittore e pubblicazione */
+        const double v = (double)(k * SCRITTORI + st->indice + 1);
+        for (int i = 0; i < net->num_parametri; i++)
+            net->parametri[i] = v;
+        if (nns_pubblica(pub, net) == 0) st->errori++;
+        st->operazioni++;
+    }
+
+    nn_free(net);
+    return NULL;
+}
+
+static void *leggi_stress(void *arg) {
+    Stress *st = (Stress*)arg;
+    const int lettore = nns_registra(pub);
+    if (lettore < 0) {
+        st->errori++;
+        return NULL;
+    }
+
+    unsigned long ultima = 0;
+    while (!atomic_load(&termina)) {
+        unsigned long versione;
+        const NeuralNetwork *snap = nns_fissa(pub, lettore, &versione);
+
+        const double v = snap->parametri[0];
+        for (int i = 1; i < snap->num_parametri; i++)
+            if (snap->parametri[i] != v) {
+                st->errori++;
+                break;
+            }
+        if (versione < ultima) st->errori++;
+        ultima = versione;
+
+        /* Lo snapshot non deve cambiare finché è fissato */
+        if (snap->parametri[snap->num_parametri - 1] != v) st->errori++;
+
+        nns_rilascia(pub, lettore);
+        st->operazioni++;
+    }
+
+    nns_deregistra(pub, lettore);
+    return NULL;
+}
+
+/* ============================================================
+ * 2) LATENZA
+ * ============================================================ */
+
+enum { SENZA_TRAINING, SNAPSHOT, MUTEX };
+
+static int modo;
+static NeuralNetwork *condivisa;        // Copia protetta dal mutex
+static pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+
+typedef struct {
+    double *misure;
+    long n;
+} Latenza;
+
+static void *addestra(void *arg) {
+    (void)arg;
+    NeuralNetwork *net = nn_clone(modello);
+    double *X = (double*)malloc(BATCH * N_INPUT * sizeof(double));
+    double *Y = (double*)calloc(BATCH * N_OUTPUT, sizeof(double));
+    if (!net || !X || !Y) return NULL;
+
+    unsigned long long seme = 99;
+    for (int r = 0; r < BATCH; r++) {
+        for (int i = 0; i < N_INPUT; i++)
+            X[r * N_INPUT + i] = bench_uniforme(&seme, 0.0, 1.0);
+        Y[r * N_OUTPUT + (int)(bench_rand_u64(&seme) % N_OUTPUT)] = 1.0;
+    }
+
+    while (!atomic_load(&termina)) {
+        nn_train_batch(net, X, Y, BATCH);
+        if (modo == SNAPSHOT) {
+            nns_pubblica(pub, net);
+        } else {
+            pthread_mutex_lock(&mutex);
+            nn_copia_parametri(condivisa, net);
+            pthread_mutex_unlock(&mutex);
+        }
+    }
+
+    nn_free(net);
+    free(X);
+    free(Y);
+    return NULL;
+}
+
+static void *leggi_latenza(void *arg) {
+    Latenza *l = (Latenza*)arg;
+    const double x[N_INPUT] = { 0.8, 0.5, 0.3, 0.2, 0.3, 0.45, 0.6 };
+    double p[N_OUTPUT];
+
+    /* Azzerato prima di tutto: un lettore che non parte non
+     * lascia le misure della fase precedente */
+    l->n = 0;
+
+    const int lettore = nns_registra(pub);
+    NN_Workspace *ws = nn_workspace_create(modello, 1);
+    if (lettore < 0 || !ws) {
+        nn_workspace_free(ws);
+        if (lettore >= 0) nns_deregistra(pub, lettore);
+        return NULL;
+    }
+
+    while (!atomic_load(&termina) && l->n < MAX_MISURE) {
+        const double t0 = orologio_secondi();
+        int esito;
+        if (modo == MUTEX) {
+            pthread_mutex_lock(&mutex);
+            esito = nn_forward_batch(condivisa, x, 1, p, ws);
+            pthread_mutex_unlock(&mutex);
+        } else {
+            esito = nn_forward_batch(nns_fissa(pub, lettore, NULL), x, 1, p, ws);
+            nns_rilascia(pub, lettore);
+        }
+        if (esito != 0) break;
+        l->misure[l->n++] = orologio_secondi() - t0;
+    }
+
+    nn_workspace_free(ws);
+    nns_deregistra(pub, lettore);
+    return NULL;
+}
+
+static int confronta_double(const void *a, const void *b) {
+    const double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+/*
+ * Esegue una fase di latenza e stampa p50, p99, p99.9 e
+ * massimo. Ritorna -1 se nessun lettore ha misurato.
+ */
+static int fase_latenza(const char *nome, int m, int n_lettori,
+                         double secondi, Latenza *lat, double *tutte) {
+    pthread_t t_train, t_lett[n_lettori];
+
+    modo = m;
+    atomic_store(&termina, 0);
+    if (m != SENZA_TRAINING)
+        pthread_create(&t_train, NULL, addestra, NULL);
+    for (int r = 0; r < n_lettori; r++)
+        pthread_create(&t_lett[r], NULL, leggi_latenza, &lat[r]);
+
+    const double t0 = orologio_secondi();
+    while (orologio_secondi() - t0 < secondi) {
+        struct timespec ts = { 0, 10000000 };
+        nanosleep(&ts, NULL);
+    }
+    atomic_store(&termina, 1);
+
+    for (int r = 0; r < n_lettori; r++)
+        pthread_join(t_lett[r], NULL);
+    if (m != SENZA_TRAINING)
+        pthread_join(t_train, NULL);
+
+    long n = 0;
+    for (int r = 0; r < n_lettori; r++) {
+        memcpy(&tutte[n], lat[r].misure, (size_t)lat[r].n * sizeof(double));
+        n += lat[r].n;
+    }
+    if (n == 0) {
+        printf("%-18s nessuna misura\n", nome);
+        return -1;
+    }
+    qsort(tutte, (size_t)n, sizeof(double), confronta_double);
+
+    printf("%-18s %10ld %9.0f %9.0f %9.0f %10.0f\n", nome, n,
+           tutte[n / 2] * 1e9, tutte[(long)(n * 0.99)] * 1e9,
+           tutte[(long)(n * 0.999)] * 1e9, tutte[n - 1] * 1e9);
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    const int n_lettori = (argc > 1) ? atoi(argv[1]) : 4;
+    const double secondi = (argc > 2) ? atof(argv[2]) : 1.0;
+    if (n_lettori < 1 || secondi <= 0.0) {
+        fprintf(stderr, "uso: %s [n_lettori] [secondi_per_fase]\n", argv[0]);
+        return 2;
+    }
+
+    modello = nn_create(N_INPUT, N_HIDDEN, N_OUTPUT, 0.01, 0.001, 42);
+    condivisa = modello ? nn_clone(modello) : NULL;
+    pub = modello ? nns_crea(modello, n_lettori) : NULL;
+    Latenza *lat = (Latenza*)calloc((size_t)n_lettori, sizeof(Latenza));
+    double *tutte = (double*)malloc((size_t)n_lettori * MAX_MISURE * sizeof(double));
+    if (!condivisa || !pub || !lat || !tutte) {
+        fprintf(stderr, "memoria insufficiente\n");
+        return 2;
+    }
+    for (int r = 0; r < n_lettori; r++)
+        if (!(lat[r].misure = (double*)malloc(MAX_MISURE * sizeof(double)))) {
+            fprintf(stderr, "memoria insufficiente\n");
+            return 2;
+        }
+
+    /* ---------- 1) Stress ---------- */
+    pthread_t t_scr[SCRITTORI], t_lett[n_lettori];
+    Stress s_scr[SCRITTORI], s_lett[n_lettori];
+
+    atomic_init(&termina, 0);
+    for (int w = 0; w < SCRITTORI; w++) {
+        s_scr[w] = (Stress){ w, 0, 0 };
+        pthread_create(&t_scr[w], NULL, scrivi_stress, &s_scr[w]);
+    }
+    for (int r = 0; r < n_lettori; r++) {
+        s_lett[r] = (Stress){ r, 0, 0 };
+        pthread_create(&t_lett[r], NULL, leggi_stress, &s_lett[r]);
+    }
+
+    const double t0 = orologio_secondi();
+    while (orologio_secondi() - t0 < secondi) {
+        struct timespec ts = { 0, 10000000 };
+        nanosleep(&ts, NULL);
+    }
+    atomic_store(&termina, 1);
+
+    long pubblicazioni = 0, letture = 0, errori = 0;
+    for (int w = 0; w < SCRITTORI; w++) {
+        pthread_join(t_scr[w], NULL);
+        pubblicazioni += s_scr[w].operazioni;
+        errori += s_scr[w].errori;
+    }
+    for (int r = 0; r < n_lettori; r++) {
+        pthread_join(t_lett[r], NULL);
+        letture += s_lett[r].operazioni;
+        errori += s_lett[r].errori;
+    }
+
+    const int copie = nns_copie(pub);
+    if (copie > n_lettori + 2) errori++;
+
+    printf("stress: %d scrittori, %d lettori, %.1f s\n", SCRITTORI, n_lettori, secondi);
+    printf("  pubblicazioni %ld | snapshot letti %ld | copie allocate %d (max %d)\n",
+           pubblicazioni, letture, copie, n_lettori + 2);
+    printf("  errori %ld\n\n", errori);
+
+    /* ---------- 2) Latenza ---------- */
+    printf("latenza fissa + forward + rilascia di un campione [ns]\n");
+    printf("%-18s %10s %9s %9s %9s %10s\n",
+           "", "misure", "p50", "p99", "p99.9", "max");
+    errori += fase_latenza("senza training", SENZA_TRAINING, n_lettori, secondi, lat, tutte) != 0;
+    errori += fase_latenza("snapshot", SNAPSHOT, n_lettori, secondi, lat, tutte) != 0;
+    errori += fase_latenza("mutex", MUTEX, n_lettori, secondi, lat, tutte) != 0;
+
+    for (int r = 0; r < n_lettori; r++)
+        free(lat[r].misure);
+    free(lat);
+    free(tutte);
+    nns_free(pub);
+    nn_free(condivisa);
+    nn_free(modello);
+
+    return errori ? 1 : 0;
+}
@@ -0,0 +1,178 @@
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "Incertezza.h"
+#include "Utilita_Tabella.h"
+#include "bench_comune.h"
+
+/* ============================================================
+ *   UTILITÀ ATTESA: CATENA DI CONFRONTI CONTRO TABELLA
+ * ============================================================
+ *
+ * Le temperature sono estratte a caso attorno alle soglie
+ * predefinite (interna 14–22 °C, esterna 2–10 °C): ogni ramo
+ * è imprevedibile e la catena di confronti paga le previsioni
+ * sbagliate.
+ *
+ * Confronta la funzione di utilità cablata nel codice (la
+ * catena di if originale) con la tabella compilata, valutata
+ * per singolo appartamento e a batch. Verifica che i tre
+ * metodi diano risultati identici bit per bit, anche con la
+ * tabella letta da utilita.cfg e con temperature NaN o
+ * infinite, e ne misura il tempo per appartamento.
+ *
+ * Uso: bench_utilita [n_appartamenti] [utilita.cfg]
+ *
+ * Termina con codice 1 se un risultato differisce.
+ */
+
+#define RIPETIZIONI 20
+
+/* Funzione di utilità originale, cablata nel codice */
+static double utilita_catena(int stato, double ti, double te) {
+    double u = 0.0;
+    switch (stato) {
+        case STATO_AWAY:
+            u = (ti > 16.0) ? -0.5 : 0.0;
+            break;
+        case STATO_HOME:
+            if (ti < 19.5) u = 1.2;
+            else           u = 0.4;
+            if (te < 8.0 && ti < 20.0) u += 0.5;
+            break;
+        case STATO_SLEEP:
+            if (ti >= 19.5) u = -2.5;
+            else            u = 0.2;
+            if (te < 5.0 && ti < 17.0) u += 0.3;
+            break;
+    }
+    return u;
+}
+
+static double eu_catena(const double p[], double ti, double te) {
+    double eu = 0.0;
+    for (int s = 0; s < N_STATI; s++)
+        eu += p[s] * utilita_catena(s, ti, te);
+    return eu;
+}
+
+/* Conta e stampa i primi risultati diversi dal riferimento */
+static int confronta(const char *nome, const double *rif, const double *eu,
+                     const double *ti, const double *te, int n) {
+    int diversi = 0;
+    for (int i = 0; i < n; i++)
+        if (memcmp(&rif[i], &eu[i], sizeof(double)) != 0) {
+            if (diversi < 5)
+                printf("  %s i=%d ti=%.17g te=%.17g: catena %.17g, %.17g\n",
+                       nome, i, ti[i], te[i], rif[i], eu[i]);
+            diversi++;
+        }
+    return diversi;
+}
+
+int main(int argc, char **argv) {
+    const int n = (argc > 1) ? atoi(argv[1]) : 1000000;
+    const char *cfg = (argc > 2) ? argv[2] : "utilita.cfg";
+    if (n < 1) {
+        fprintf(stderr, "uso: %s [n_appartamenti] [utilita.cfg]\n", argv[0]);
+        return 2;
+    }
+
+    double *pa = (double*)malloc((size_t)n * sizeof(double));
+    double *ph = (double*)malloc((size_t)n * sizeof(double));
+    double *ps = (double*)malloc((size_t)n * sizeof(double));
+    double *ti = (double*)malloc((size_t)n * sizeof(double));
+    double *te = (double*)malloc((size_t)n * sizeof(double));
+    double *eu_c = (double*)malloc((size_t)n * sizeof(double));
+    double *eu_s = (double*)malloc((size_t)n * sizeof(double));
+    double *eu_b = (double*)malloc((size_t)n * sizeof(double));
+    if (!pa || !ph || !ps || !ti || !te || !eu_c || !eu_s || !eu_b) {
+        fprintf(stderr, "memoria insufficiente\n");
+        return 2;
+    }
+
+    unsigned long long seme = 8080;
+    for (int i = 0; i < n; i++) {
+        double a = bench_uniforme(&seme, 0.0, 1.0);
+        double h = bench_uniforme(&seme, 0.0, 1.0 - a);
+        pa[i] = a;
+        ph[i] = h;
+        ps[i] = 1.0 - a - h;
+        ti[i] = bench_uniforme(&seme, 14.0, 22.0);
+        te[i] = bench_uniforme(&seme, 2.0, 10.0);
+    }
+
+    /* Soglie esatte incluse: verificano i confronti al bordo */
+    if (n >= 6) {
+        ti[0] = 16.0; ti[1] = 19.5; ti[2] = 20.0;
+        ti[3] = 17.0; te[4] = 8.0;  te[5] = 5.0;
+    }
+
+    /* Valori non finiti: NaN rende falso ogni confronto */
+    if (n >= 14) {
+        ti[6]  = NAN;       te[7]  = NAN;
+        ti[8]  = NAN;       te[8]  = NAN;
+        ti[9]  = INFINITY;  ti[10] = -INFINITY;
+        te[11] = INFINITY;  te[12] = -INFINITY;
+        ti[13] = -INFINITY; te[13] = NAN;
+    }
+
+    /* ---------- Catena di confronti ---------- */
+    double t0 = orologio_secondi();
+    for (int r = 0; r < RIPETIZIONI; r++)
+        for (int i = 0; i < n; i++) {
+            const double p[N_STATI] = { pa[i], ph[i], ps[i] };
+            eu_c[i] = eu_catena(p, ti[i], te[i]);
+        }
+    const double t_catena = (orologio_secondi() - t0) / RIPETIZIONI;
+
+    /* ---------- Tabella, scalare ---------- */
+    t0 = orologio_secondi();
+    for (int r = 0; r < RIPETIZIONI; r++)
+        for (int i = 0; i < n; i++) {
+            const double p[N_STATI] = { pa[i], ph[i], ps[i] };
+            eu_s[i] = utilita_attesa(p, ti[i], te[i]);
+        }
+    const double t_scalare = (orologio_secondi() - t0) / RIPETIZIONI;
+
+    /* ---------- Tabella, batch ---------- */
+    t0 = orologio_secondi();
+    for (int r = 0; r < RIPETIZIONI; r++)
+        utilita_attesa_batch(pa, ph, ps, ti, te, n, eu_b);
+    const double t_batch = (orologio_secondi() - t0) / RIPETIZIONI;
+
+    int diversi = confronta("scalare", eu_c, eu_s, ti, te, n)
+                + confronta("batch", eu_c, eu_b, ti, te, n);
+
+    /* ---------- Tabella da file, pubblicata ---------- */
+    Utilita_Tabella *da_file = ut_carica(cfg);
+    if (da_file) {
+        ut_free(ut_pubblica(da_file));
+        utilita_attesa_batch(pa, ph, ps, ti, te, n, eu_b);
+        diversi += confronta(cfg, eu_c, eu_b, ti, te, n);
+        ut_free(ut_pubblica(NULL));
+    }
+
+    printf("appartamenti %d\n\n", n);
+    printf("catena   %7.3f ns/app.\n", t_catena / n * 1e9);
+    printf("scalare  %7.3f ns/app.  (%.1fx)\n",
+           t_scalare / n * 1e9, t_catena / t_scalare);
+    printf("batch    %7.3f ns/app.  (%.1fx)\n",
+           t_batch / n * 1e9, t_catena / t_batch);
+    printf("\n%s: %s\n", cfg, da_file ? "verificato" : "non disponibile");
+    printf("risultati diversi: %d\n", diversi);
+
+    free(pa);
+    free(ph);
+    free(ps);
+    free(ti);
+    free(te);
+    free(eu_c);
+    free(eu_s);
+    free(eu_b);
+
+    return diversi ? 1 : 0;
+}
@@ -0,0 +1,877 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <stdint.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "Dataset.h"
+
+/* ============================================================
+ * ANALISI DI UNA RIGA CSV
+ * ============================================================ */
+
+/*
+ * Salta spazi e tabulazioni (non il fine riga).
+ */
+static const char *salta_spazi(const char *s) {
+    while (*s == ' ' || *s == '\t') s++;
+    return s;
+}
+
+static inline int cifra(char c) {
+    return c >= '0' && c <= '9';
+}
+
+/* Potenze di 10 rappresentate esattamente in double */
+static const double potenze10[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/*
+ * Percorso rapido (Clinger): la mantissa decimale m <= 2^53 e
+ * 10^|e| con |e| <= 22 sono esatti in double, quindi una sola
+ * moltiplicazione o divisione dà il valore arrotondato
+ * correttamente, identico a strtod. Tutto il resto (più di 19
+ * cifre, esponenti grandi, inf, nan, esadecimali, spazi
+ * iniziali) passa a strtod.
+ */
+static inline double leggi_decimale(const char *s, char **fine) {
+    const char *p = s;
+    const int negativo = (*p == '-');
+    if (*p == '-' || *p == '+') p++;
+
+    /* Con al più 19 cifre m non trabocca: il controllo è
+     * fatto una volta sola, dopo l'accumulo */
+    uint64_t m = 0;
+    const char *cifre = p;
+    for (; cifra(*p); p++)
+        m = m * 10 + (uint64_t)(*p - '0');
+    long viste = p - cifre;
+
+    int esp = 0;
+    if (*p == '.') {
+        const char *dec = ++p;
+        for (; cifra(*p); p++)
+            m = m * 10 + (uint64_t)(*p - '0');
+        esp = -(int)(p - dec);
+        viste += p - dec;
+    }
+    if (viste == 0 || viste > 19) goto lento;
+
+    /* Esponente solo se seguito da cifre, come strtod */
+    if ((*p | 0x20) == 'e') {
+        const char *q = p + 1;
+        const int neg_esp = (*q == '-');
+        if (*q == '-' || *q == '+') q++;
+        if (cifra(*q)) {
+            int e = 0;
+            for (; cifra(*q); q++)
+                if (e < 10000) e = e * 10 + (*q - '0');
+            esp += neg_esp ? -e : e;
+            p = q;
+        }
+    }
+
+    /* Una lettera che strtod potrebbe ancora consumare ("0x") */
+    if ((unsigned)((*p | 0x20) - 'a') < 26u) goto lento;
+    if (m > ((uint64_t)1 << 53) || esp < -22 || esp > 22) goto lento;
+
+    double v = (double)m;
+    v = (esp < 0) ? v / potenze10[-esp] : v * potenze10[esp];
+    if (fine) *fine = (char*)p;
+    return negativo ? -v : v;
+
+lento:
+    return strtod(s, fine);
+}
+
+double dataset_strtod(const char *s, char **fine) {
+    return leggi_decimale(s, fine);
+}
+
+int dataset_analizza_riga(const char *riga,
+                          double raw[DATASET_N_FEATURE],
+                          int *classe,
+                          int *colonna,
+                          const char **errore) {
+
+    const char *s = salta_spazi(riga);
+
+    /* Righe vuote (o con soli spazi) vengono ignorate */
+    if (*s == '\0' || *s == '\n' || *s == '\r')
+        return 0;
+
+    /* ---------- Feature numeriche ---------- */
+    for (int k = 0; k < DATASET_N_FEATURE; k++) {
+        char *fine;
+        raw[k] = leggi_decimale(s, &fine);
+
+        if (fine == s) {
+            *colonna = (int)(s - riga) + 1;
+            *errore = "valore numerico atteso";
+            return -1;
+        }
+
+        s = salta_spazi(fine);
+        if (*s != ',') {
+            *colonna = (int)(s - riga) + 1;
+            *errore = "separatore ',' atteso";
+            return -1;
+        }
+        s = salta_spazi(s + 1);
+    }
+
+    /* ---------- Etichetta di classe ---------- */
+    char *fine;
+    long c = 0;
+    if (cifra(*s) && !cifra(s[1])) {
+        c = *s - '0';       // Caso comune: una cifra
+        fine = (char*)s + 1;
+    } else {
+        c = strtol(s, &fine, 10);
+    }
+
+    if (fine == s) {
+        *colonna = (int)(s - riga) + 1;
+        *errore = "classe intera attesa";
+        return -1;
+    }
+    if (c < 0 || c >= DATASET_N_CLASSI) {
+        *colonna = (int)(s - riga) + 1;
+        *errore = "classe fuori intervallo";
+        return -1;
+    }
+
+    /* Dopo l'etichetta sono ammessi solo spazi e fine riga */
+    s = fine;
+    while (*s && isspace((unsigned char)*s)) s++;
+    if (*s != '\0') {
+        *colonna = (int)(s - riga) + 1;
+        *errore = "caratteri inattesi a fine riga";
+        return -1;
+    }
+
+    *classe = (int)c;
+    return 1;
+}
+
+/* ============================================================
+ * CARICAMENTO DEL DATASET
+ * ============================================================ */
+
+#define RIGHE_DIM_LETTURA   (1 << 20)   // Byte per fread
+#define RIGHE_MAX           1024        // Lunghezza massima di una riga
+
+/*
+ * Lettore di righe su un buffer grande: una fread ogni
+ * RIGHE_DIM_LETTURA byte e righe terminate sul posto, senza
+ * copie né passaggi per stdio riga per riga.
+ */
+typedef struct {
+    FILE *f;
+    char *buf;              // RIGHE_DIM_LETTURA + 1 (terminatore)
+    size_t pos;             // Primo byte non ancora consegnato
+    size_t fine;            // Byte validi nel buffer
+    int eof;
+} Righe;
+
+static int righe_apri(Righe *r, FILE *f) {
+    *r = (Righe){ .f = f };
+    r->buf = (char*)malloc(RIGHE_DIM_LETTURA + 1);
+    return r->buf ? 0 : -1;
+}
+
+static void righe_chiudi(Righe *r) {
+    free(r->buf);
+    r->buf = NULL;
+}
+
+/* Da chiamare dopo aver riposizionato il file */
+static void righe_azzera(Righe *r) {
+    r->pos = r->fine = 0;
+    r->eof = 0;
+}
+
+/*
+ * Prossima riga, con il '\n' sostituito da '\0'. *len è la
+ * lunghezza originale, anche se la riga non entrava nel buffer
+ * (in quel caso il contenuto restituito è solo la coda).
+ * Ritorna NULL a fine file.
+ */
+static char *righe_prossima(Righe *r, size_t *len) {
+    size_t cerca = r->pos;
+    size_t scartati = 0;
+
+    for (;;) {
+        char *nl = (char*)memchr(r->buf + cerca, '\n', r->fine - cerca);
+        if (nl) {
+            char *riga = r->buf + r->pos;
+            *nl = '\0';
+            *len = scartati + (size_t)(nl - riga);
+            r->pos = (size_t)(nl - r->buf) + 1;
+            return riga;
+        }
+
+        if (r->eof) {
+            /* Ultima riga senza '\n' */
+            if (r->pos == r->fine) return NULL;
+            char *riga = r->buf + r->pos;
+            r->buf[r->fine] = '\0';
+            *len = scartati + (r->fine - r->pos);
+            r->pos = r->fine;
+            return riga;
+        }
+
+        /* Riga incompleta: portata in testa e completata dal file */
+        size_t resto = r->fine - r->pos;
+        if (resto == RIGHE_DIM_LETTURA) {
+            scartati += resto;      // Più lunga del buffer intero
+            resto = 0;
+        } else {
+            memmove(r->buf, r->buf + r->pos, resto);
+        }
+        r->pos = 0;
+        r->fine = cerca = resto;
+
+        const size_t n = fread(r->buf + r->fine, 1,
+                               RIGHE_DIM_LETTURA - r->fine, r->f);
+        r->fine += n;
+        if (n == 0) r->eof = 1;
+    }
+}
+
+/*
+ * Legge la prossima riga valida. Le righe malformate vengono
+ * segnalate su stderr come nome:riga:colonna e contate in
+ * *n_errori.
+ *
+ * Ritorna 1 se raw e classe sono validi, 0 a fine file.
+ */
+static int dataset_prossima_riga(Righe *r, const char *nome,
+                                 int *num_riga, int *n_errori,
+                                 double raw[DATASET_N_FEATURE],
+                                 int *classe) {
+    char *buf;
+    size_t len;
+
+    while ((buf = righe_prossima(r, &len)) != NULL) {
+        (*num_riga)++;
+
+        /* Riga troppo lunga: scartata per intero */
+        if (len >= RIGHE_MAX - 1) {
+            fprintf(stderr, "%s:%d:%d: riga troppo lunga\n",
+                    nome, *num_riga, RIGHE_MAX);
+            (*n_errori)++;
+            continue;
+        }
+
+        int colonna;
+        const char *errore;
+
+        int esito = dataset_analizza_riga(buf, raw, classe,
+                                          &colonna, &errore);
+        if (esito == 0) continue;
+        if (esito < 0) {
+            fprintf(stderr, "%s:%d:%d: %s\n",
+                    nome, *num_riga, colonna, errore);
+            (*n_errori)++;
+            continue;
+        }
+        return 1;
+    }
+    return 0;
+}
+
+/*
+ * Garantisce spazio per almeno 'richieste' righe,
+ * raddoppiando la capacità quando necessario.
+ */
+static int dataset_riserva(Dataset *ds, int *capacita, int richieste) {
+    if (richieste <= *capacita) return 0;
+
+    int nuova = *capacita ? *capacita * 2 : 256;
+    while (nuova < richieste) nuova *= 2;
+
+    double *X = (double*)realloc(
+        ds->X, (size_t)nuova * ds->n_feature * sizeof(double));
+    if (!X) return -1;
+    ds->X = X;
+
+    int *y = (int*)realloc(ds->y, (size_t)nuova * sizeof(int));
+    if (!y) return -1;
+    ds->y = y;
+
+    *capacita = nuova;
+    return 0;
+}
+
+Dataset *dataset_carica_csv(const char *filename) {
+    FILE *f = fopen(filename, "r");
+    if (!f) return NULL;
+
+    Dataset *ds = (Dataset*)calloc(1, sizeof(Dataset));
+    if (!ds) {
+        fclose(f);
+        return NULL;
+    }
+
+    ds->n_feature = DATASET_N_FEATURE;
+    ds->n_classi  = DATASET_N_CLASSI;
+
+    int capacita = 0;
+    int num_riga = 0;
+    int classe;
+
+    Righe r;
+    if (righe_apri(&r, f) != 0) {
+        dataset_free(ds);
+        fclose(f);
+        return NULL;
+    }
+
+    /* Valori grezzi letti direttamente nella matrice,
+     * normalizzata sul posto in un solo passaggio alla fine */
+    for (;;) {
+        if (dataset_riserva(ds, &capacita, ds->n_righe + 1) != 0) {
+            righe_chiudi(&r);
+            dataset_free(ds);
+            fclose(f);
+            return NULL;
+        }
+        if (!dataset_prossima_riga(&r, filename, &num_riga, &ds->n_errori,
+                                   &ds->X[(size_t)ds->n_righe * ds->n_feature],
+                                   &classe))
+            break;
+
+        ds->y[ds->n_righe] = classe;
+        ds->n_righe++;
+    }
+    norm_batch(ds->X, ds->X, ds->n_righe);
+
+    righe_chiudi(&r);
+    fclose(f);
+    return ds;
+}
+
+/* ============================================================
+ * DEALLOCAZIONE
+ * ============================================================ */
+
+void dataset_free(Dataset *ds) {
+    if (!ds) return;
+
+    free(ds->X);
+    free(ds->y);
+    free(ds);
+}
+
+/* ============================================================
+ * FORMATO BINARIO COLONNARE
+ * ============================================================ */
+
+#define DSC_MAGIC        0x4C4F4344u   // "DCOL"
+#define DSC_VERSIONE     2u
+#define DSC_ORDINE_BYTE  0x01020304u
+#define DSC_DIM_HEADER   512
+#define DSC_ALLINEA      64
+#define DSC_N_COLONNE    (DATASET_N_FEATURE + 1)   // Feature + etichetta
+#define DSC_BLOCCO       8192                      // Righe per scrittura
+
+enum { DSC_F64 = 1, DSC_U8 = 2 };
+
+typedef struct {
+    char     nome[16];
+    uint32_t tipo;          // DSC_F64 o DSC_U8
+    uint32_t riservato;
+    double   scala;         // Normalizzazione applicata (0 = etichetta)
+    double   traslazione;
+    uint64_t offset;        // Byte dall'inizio del file
+} DSC_Colonna;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t versione;
+    uint32_t ordine_byte;
+    uint32_t dim_header;
+
+    uint32_t n_colonne;
+    uint32_t n_classi;
+
+    uint64_t n_righe;
+    uint64_t capacita;      // Righe riservate per colonna (≥ n_righe)
+    uint64_t dim_file;
+
+    DSC_Colonna col[DSC_N_COLONNE];
+} DSC_Header;
+
+_Static_assert(sizeof(DSC_Header) <= DSC_DIM_HEADER,
+               "header del formato colonnare troppo grande");
+_Static_assert(DSC_DIM_HEADER % DSC_ALLINEA == 0,
+               "le colonne devono restare allineate");
+
+static uint64_t dsc_allinea(uint64_t byte) {
+    return (byte + DSC_ALLINEA - 1) & ~(uint64_t)(DSC_ALLINEA - 1);
+}
+
+/*
+ * Schema e offset delle colonne a partire da h->capacita:
+ * le feature, poi l'etichetta, ognuna su un confine di 64 byte
+ */
+static void dsc_layout(DSC_Header *h) {
+    uint64_t off = DSC_DIM_HEADER;
+
+    memset(h->col, 0, sizeof(h->col));
+    for (int k = 0; k < DATASET_N_FEATURE; k++) {
+        DSC_Colonna *c = &h->col[k];
+        strncpy(c->nome, norm_nomi[k], sizeof(c->nome) - 1);
+        c->tipo        = DSC_F64;
+        c->scala       = norm_scala[k];
+        c->traslazione = norm_traslazione[k];
+        c->offset      = off;
+        off += dsc_allinea(h->capacita * sizeof(double));
+    }
+
+    DSC_Colonna *c = &h->col[DATASET_N_FEATURE];
+    strncpy(c->nome, "classe", sizeof(c->nome) - 1);
+    c->tipo   = DSC_U8;
+    c->offset = off;
+    off += dsc_allinea(h->capacita);
+
+    h->dim_file = off;
+}
+
+/*
+ * Verifica l'header contro lo schema corrente (incluse le
+ * costanti di normalizzazione) e la dimensione del file.
+ * Ritorna 0 se valido, -1 con il motivo altrimenti.
+ */
+static int dsc_valida(const DSC_Header *h, uint64_t dim_file,
+                      const char **motivo) {
+    if (h->magic != DSC_MAGIC) {
+        *motivo = "non è un file colonnare";
+        return -1;
+    }
+    if (h->versione != DSC_VERSIONE) {
+        *motivo = "versione del formato diversa, va riconvertito";
+        return -1;
+    }
+    if (h->ordine_byte != DSC_ORDINE_BYTE) {
+        *motivo = "scritto con un ordine dei byte diverso";
+        return -1;
+    }
+    if (h->dim_header != DSC_DIM_HEADER ||
+        h->n_colonne != DSC_N_COLONNE ||
+        h->n_classi != DATASET_N_CLASSI ||
+        h->n_righe > h->capacita ||
+        h->capacita > (uint64_t)dim_file) {
+        *motivo = "header non valido";
+        return -1;
+    }
+
+    DSC_Header atteso = *h;
+    dsc_layout(&atteso);
+
+    if (memcmp(atteso.col, h->col, sizeof(h->col)) != 0) {
+        *motivo = "schema o normalizzazione diversi, va riconvertito";
+        return -1;
+    }
+    if (atteso.dim_file != h->dim_file || h->dim_file > dim_file) {
+        *motivo = "file troncato";
+        return -1;
+    }
+
+    return 0;
+}
+
+/* pwrite completa (le scritture possono essere parziali) */
+static int dsc_scrivi(int fd, const void *dati, size_t n, uint64_t off) {
+    const char *p = (const char*)dati;
+    while (n > 0) {
+        ssize_t k = pwrite(fd, p, n, (off_t)off);
+        if (k <= 0) return -1;
+        p += k;
+        n -= (size_t)k;
+        off += (uint64_t)k;
+    }
+    return 0;
+}
+
+/*
+ * Righe del file (fine riga contati a blocchi): limite
+ * superiore delle righe valide, fissa la capacità delle colonne
+ */
+static long dsc_conta_righe(FILE *f) {
+    const size_t dim = 1 << 16;
+    char *blocco = (char*)malloc(dim);
+    if (!blocco) return -1;
+
+    long righe = 0;
+    char ultimo = '\n';
+    size_t n;
+
+    while ((n = fread(blocco, 1, dim, f)) > 0) {
+        for (const char *p = blocco, *fine = blocco + n;
+             (p = memchr(p, '\n', (size_t)(fine - p))) != NULL; p++)
+            righe++;
+        ultimo = blocco[n - 1];
+    }
+    if (ultimo != '\n') righe++;
+
+    free(blocco);
+    return ferror(f) ? -1 : righe;
+}
+
+/* Scrive le prime n righe bufferizzate a partire dalla riga 'base' */
+static int dsc_svuota(int fd, const DSC_Header *h, double *const col[],
+                      const uint8_t *y, long base, int n) {
+    for (int k = 0; k < DATASET_N_FEATURE; k++)
+        if (dsc_scrivi(fd, col[k], (size_t)n * sizeof(double),
+                       h->col[k].offset + (uint64_t)base * sizeof(double)) != 0)
+            return -1;
+    return dsc_scrivi(fd, y, (size_t)n,
+                      h->col[DATASET_N_FEATURE].offset + (uint64_t)base);
+}
+
+int dataset_converti_colonne(const char *csv, const char *destinazione,
+                             Dataset_Conversione *st) {
+    st->righe = 0;
+    st->scartate = 0;
+
+    FILE *f = fopen(csv, "r");
+    if (!f) return -1;
+
+    const long capacita = dsc_conta_righe(f);
+    if (capacita < 0 || fseek(f, 0, SEEK_SET) != 0) {
+        fclose(f);
+        return -1;
+    }
+
+    DSC_Header h;
+    memset(&h, 0, sizeof(h));
+    h.magic       = DSC_MAGIC;
+    h.versione    = DSC_VERSIONE;
+    h.ordine_byte = DSC_ORDINE_BYTE;
+    h.dim_header  = DSC_DIM_HEADER;
+    h.n_colonne   = DSC_N_COLONNE;
+    h.n_classi    = DATASET_N_CLASSI;
+    h.capacita    = (uint64_t)capacita;
+    dsc_layout(&h);
+
+    /* Temporaneo e rename atomico, come per il checkpoint */
+    size_t len = strlen(destinazione);
+    char *tmp = (char*)malloc(len + 5);
+    double *col[DATASET_N_FEATURE] = { NULL };
+    uint8_t *y = (uint8_t*)malloc(DSC_BLOCCO);
+    Righe r = { 0 };
+    int ok = tmp && y && righe_apri(&r, f) == 0;
+    for (int k = 0; k < DATASET_N_FEATURE && ok; k++)
+        ok = (col[k] = (double*)malloc(DSC_BLOCCO * sizeof(double))) != NULL;
+
+    int fd = -1;
+    if (ok) {
+        memcpy(tmp, destinazione, len);
+        memcpy(tmp + len, ".tmp", 5);
+        fd = open(tmp, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        ok = fd >= 0 && ftruncate(fd, (off_t)h.dim_file) == 0;
+    }
+
+    /* ---------- Righe, a blocchi di DSC_BLOCCO per colonna ---------- */
+    int num_riga = 0, nel_blocco = 0;
+    double raw[DATASET_N_FEATURE], x[DATASET_N_FEATURE];
+    int classe;
+
+    while (ok && dataset_prossima_riga(&r, csv, &num_riga, &st->scartate,
+                                       raw, &classe)) {
+        /* Le colonne sono dimensionate dal primo passaggio: un
+         * CSV cresciuto nel frattempo scriverebbe nella colonna
+         * successiva */
+        if (st->righe + nel_blocco >= capacita) {
+            fprintf(stderr, "%s: modificato durante la conversione\n", csv);
+            ok = 0;
+            break;
+        }
+
+        norm_riga(raw, x);
+        for (int k = 0; k < DATASET_N_FEATURE; k++)
+            col[k][nel_blocco] = x[k];
+        y[nel_blocco] = (uint8_t)classe;
+
+        if (++nel_blocco == DSC_BLOCCO) {
+            ok = dsc_svuota(fd, &h, col, y, st->righe, nel_blocco) == 0;
+            st->righe += nel_blocco;
+            nel_blocco = 0;
+        }
+    }
+
+    if (ok && nel_blocco > 0) {
+        ok = dsc_svuota(fd, &h, col, y, st->righe, nel_blocco) == 0;
+        st->righe += nel_blocco;
+    }
+    if (ferror(f)) ok = 0;
+
+    /* ---------- Header per ultimo: righe effettive ---------- */
+    h.n_righe = (uint64_t)st->righe;
+    char blocco_header[DSC_DIM_HEADER] = {0};
+    memcpy(blocco_header, &h, sizeof(h));
+    if (ok) ok = dsc_scrivi(fd, blocco_header, sizeof(blocco_header), 0) == 0;
+
+    if (fd >= 0 && close(fd) != 0) ok = 0;
+    if (ok && rename(tmp, destinazione) != 0) ok = 0;
+    if (!ok && fd >= 0) remove(tmp);
+
+    righe_chiudi(&r);
+    fclose(f);
+    for (int k = 0; k < DATASET_N_FEATURE; k++)
+        free(col[k]);
+    free(y);
+    free(tmp);
+    return ok ? 0 : -1;
+}
+
+/*
+ * Le colonne puntano direttamente nella mappatura: nessuna
+ * analisi e nessuna copia. Le etichette vengono verificate
+ * una volta (un byte per riga), perché indicizzano il target.
+ *
+ * Il training in memoria permuta i campioni con indici int:
+ * file con più di INT_MAX righe sono rifiutati qui e vanno
+ * letti a blocchi (dataset_apri_flusso).
+ */
+Dataset_Colonne *dataset_mappa_colonne(const char *path,
+                                       const char **motivo) {
+    const char *scarto;
+    if (!motivo) motivo = &scarto;
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        *motivo = "file non leggibile";
+        return NULL;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (uint64_t)st.st_size < DSC_DIM_HEADER) {
+        *motivo = "file più corto dell'header";
+        close(fd);
+        return NULL;
+    }
+
+    size_t dim = (size_t)st.st_size;
+    void *mappa = mmap(NULL, dim, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mappa == MAP_FAILED) {
+        *motivo = "mappatura non riuscita";
+        return NULL;
+    }
+
+    const DSC_Header *h = (const DSC_Header*)mappa;
+    Dataset_Colonne *dc = NULL;
+
+    if (dsc_valida(h, (uint64_t)dim, motivo) != 0)
+        ;
+    else if (h->n_righe > (uint64_t)INT_MAX)
+        *motivo = "più di INT_MAX righe, va letto a blocchi";
+    else if (!(dc = (Dataset_Colonne*)calloc(1, sizeof(Dataset_Colonne))))
+        *motivo = "memoria insufficiente";
+    else {
+
+        const char *base = (const char*)mappa;
+        dc->n_righe   = (long)h->n_righe;
+        dc->n_feature = DATASET_N_FEATURE;
+        dc->n_classi  = DATASET_N_CLASSI;
+        for (int k = 0; k < DATASET_N_FEATURE; k++)
+            dc->col[k] = (const double*)(base + h->col[k].offset);
+        dc->y = (const uint8_t*)(base + h->col[DATASET_N_FEATURE].offset);
+        dc->mappa = mappa;
+        dc->mappa_dim = dim;
+
+        uint8_t fuori = 0;
+        for (long r = 0; r < dc->n_righe; r++)
+            fuori |= dc->y[r] >= DATASET_N_CLASSI;
+        if (fuori) {
+            *motivo = "etichette fuori intervallo";
+            free(dc);
+            dc = NULL;
+        }
+    }
+
+    if (!dc) munmap(mappa, dim);
+    return dc;
+}
+
+void dataset_colonne_free(Dataset_Colonne *dc) {
+    if (!dc) return;
+    munmap(dc->mappa, dc->mappa_dim);
+    free(dc);
+}
+
+/* ============================================================
+ * LETTURA A BLOCCHI
+ * ============================================================ */
+
+struct Dataset_Flusso {
+    const char *nome;       // Per i messaggi (stringa del chiamante)
+
+    /* CSV */
+    FILE *f;
+    Righe righe;
+    int num_riga;
+    int n_errori;
+
+    /* Colonnare */
+    int fd;
+    DSC_Header h;
+    long prossima;          // Prima riga non ancora letta
+    double *colonna;        // Appoggio per una colonna del blocco
+    uint8_t *etichette;
+    long capacita;          // Righe allocate negli appoggi
+};
+
+Dataset_Flusso *dataset_apri_flusso(const char *path) {
+    Dataset_Flusso *fl = (Dataset_Flusso*)calloc(1, sizeof(Dataset_Flusso));
+    if (!fl) return NULL;
+    fl->nome = path;
+    fl->fd = -1;
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        free(fl);
+        return NULL;
+    }
+
+    /* Formato riconosciuto dal magic dell'header */
+    struct stat st;
+    uint32_t magic = 0;
+    const char *motivo;
+    if (pread(fd, &magic, sizeof(magic), 0) == (ssize_t)sizeof(magic) &&
+        magic == DSC_MAGIC) {
+        if (fstat(fd, &st) != 0 ||
+            pread(fd, &fl->h, sizeof(fl->h), 0) != (ssize_t)sizeof(fl->h) ||
+            dsc_valida(&fl->h, (uint64_t)st.st_size, &motivo) != 0) {
+            close(fd);
+            free(fl);
+            return NULL;
+        }
+        fl->fd = fd;
+        return fl;
+    }
+
+    close(fd);
+    fl->f = fopen(path, "r");
+    if (!fl->f || righe_apri(&fl->righe, fl->f) != 0) {
+        if (fl->f) fclose(fl->f);
+        free(fl);
+        return NULL;
+    }
+    return fl;
+}
+
+void dataset_chiudi_flusso(Dataset_Flusso *fl) {
+    if (!fl) return;
+    if (fl->f) {
+        righe_chiudi(&fl->righe);
+        fclose(fl->f);
+    }
+    if (fl->fd >= 0) close(fl->fd);
+    free(fl->colonna);
+    free(fl->etichette);
+    free(fl);
+}
+
+/* pread completa; ritorna -1 anche se il file è più corto */
+static int dsc_leggi(int fd, void *dati, size_t n, uint64_t off) {
+    char *p = (char*)dati;
+    while (n > 0) {
+        ssize_t k = pread(fd, p, n, (off_t)off);
+        if (k <= 0) return -1;
+        p += k;
+        n -= (size_t)k;
+        off += (uint64_t)k;
+    }
+    return 0;
+}
+
+/*
+ * Blocco dal file colonnare: una pread per colonna, poi
+ * trasposizione nel layout per righe usato dal training
+ */
+static long dsc_leggi_blocco(Dataset_Flusso *fl, double *X, int *y,
+                             long max_righe) {
+    long n = (long)fl->h.n_righe - fl->prossima;
+    if (n > max_righe) n = max_righe;
+    if (n <= 0) return 0;
+
+    if (n > fl->capacita) {
+        free(fl->colonna);
+        free(fl->etichette);
+        fl->colonna   = (double*)malloc((size_t)n * sizeof(double));
+        fl->etichette = (uint8_t*)malloc((size_t)n);
+        fl->capacita  = (fl->colonna && fl->etichette) ? n : 0;
+        if (!fl->capacita) return -1;
+    }
+
+    for (int k = 0; k < DATASET_N_FEATURE; k++) {
+        if (dsc_leggi(fl->fd, fl->colonna, (size_t)n * sizeof(double),
+                      fl->h.col[k].offset +
+                      (uint64_t)fl->prossima * sizeof(double)) != 0)
+            return -1;
+        for (long r = 0; r < n; r++)
+            X[r * DATASET_N_FEATURE + k] = fl->colonna[r];
+    }
+
+    if (dsc_leggi(fl->fd, fl->etichette, (size_t)n,
+                  fl->h.col[DATASET_N_FEATURE].offset +
+                  (uint64_t)fl->prossima) != 0)
+        return -1;
+    for (long r = 0; r < n; r++) {
+        if (fl->etichette[r] >= DATASET_N_CLASSI) return -1;
+        y[r] = fl->etichette[r];
+    }
+
+    fl->prossima += n;
+    return n;
+}
+
+long dataset_leggi_blocco(Dataset_Flusso *fl, double *X, int *y,
+                          long max_righe) {
+    if (fl->fd >= 0)
+        return dsc_leggi_blocco(fl, X, y, max_righe);
+
+    long n = 0;
+    while (n < max_righe &&
+           dataset_prossima_riga(&fl->righe, fl->nome, &fl->num_riga,
+                                 &fl->n_errori, &X[n * DATASET_N_FEATURE], &y[n]))
+        n++;
+    norm_batch(X, X, n);
+
+    return ferror(fl->f) ? -1 : n;
+}
+
+int dataset_riavvolgi_flusso(Dataset_Flusso *fl) {
+    if (fl->fd >= 0) {
+        fl->prossima = 0;
+        return 0;
+    }
+    fl->num_riga = 0;
+    fl->n_errori = 0;
+    righe_azzera(&fl->righe);
+    return fseek(fl->f, 0, SEEK_SET);
+}
+
+int dataset_flusso_scartate(const Dataset_Flusso *fl) {
+    return fl->n_errori;
+}
+
+size_t dataset_flusso_memoria(const Dataset_Flusso *fl, long max_righe) {
+    if (fl->fd < 0)
+        return RIGHE_DIM_LETTURA + 1;
+
+    const long n = max_righe < (long)fl->h.n_righe ? max_righe : (long)fl->h.n_righe;
+    return (size_t)n * (sizeof(double) + sizeof(uint8_t));
+}
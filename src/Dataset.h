@@ -0,0 +1,221 @@
+#ifndef DATASET_H
+#define DATASET_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "Normalizzazione.h"
+
+/* ============================================================
+ *              DATASET DI ADDESTRAMENTO
+ * ============================================================
+ *
+ * Il file CSV viene letto UNA sola volta e trasformato in:
+ *  - una matrice contigua di feature già normalizzate
+ *    (schema e costanti in Normalizzazione.h)
+ *  - un vettore di etichette (classe di occupazione)
+ *
+ * Il ciclo delle epoche scorre direttamente queste strutture
+ * in memoria, senza riaprire né ri-analizzare il file.
+ *
+ * Formato di ogni riga (8 campi separati da ", "):
+ *   ora, temp_ext, luci, movimento, consumo, prezzo, temp_int, classe
+ */
+
+#define DATASET_N_FEATURE  NORM_N_FEATURE   // Feature di input per riga (schema)
+#define DATASET_N_CLASSI   3                // Classi: Away, Home, Sleep
+
+typedef struct {
+
+    int n_righe;        // Numero di campioni validi caricati
+    int n_feature;      // Numero di feature per campione
+    int n_classi;       // Numero di classi di output
+
+    double *X;
+    // Matrice delle feature normalizzate
+    // Dimensione: [n_righe][n_feature], memorizzata per righe
+
+    int *y;
+    // Etichette di classe
+    // Dimensione: [n_righe], valori in [0, n_classi)
+
+    int n_errori;       // Righe scartate perché malformate
+
+} Dataset;
+
+/*
+ * Carica e normalizza un dataset CSV.
+ *
+ * Le righe malformate non interrompono il caricamento:
+ * vengono segnalate su stderr con numero di riga e colonna
+ * e conteggiate in n_errori.
+ *
+ * Ritorna NULL se il file non è leggibile o in caso di
+ * memoria insufficiente.
+ */
+Dataset *dataset_carica_csv(const char *filename);
+
+/*
+ * Dealloca il dataset e tutti i suoi buffer
+ */
+void dataset_free(Dataset *ds);
+
+/*
+ * Analizza una singola riga testuale del dataset.
+ *
+ * raw[]   : feature grezze (non normalizzate) lette dalla riga
+ * classe  : etichetta di classe
+ * colonna : in caso di errore, colonna (1-based) del carattere
+ *           in cui l'analisi si è fermata
+ *
+ * Ritorna:
+ *   1  riga valida
+ *   0  riga vuota (da ignorare)
+ *  -1  riga malformata (*errore descrive il problema)
+ */
+int dataset_analizza_riga(
+    const char *riga,
+    double raw[DATASET_N_FEATURE],
+    int *classe,
+    int *colonna,
+    const char **errore
+);
+
+/*
+ * Conversione di un numero decimale come strtod, ma senza
+ * passare dalla libreria nel caso comune (al più 19 cifre ed
+ * esponente decimale entro ±22): il risultato è comunque
+ * identico bit per bit a quello di strtod.
+ */
+double dataset_strtod(const char *s, char **fine);
+
+/* ============================================================
+ *              FORMATO BINARIO COLONNARE
+ * ============================================================
+ *
+ * Conversione una tantum del CSV in un file pronto per il
+ * training, letto senza analisi né copie tramite mmap:
+ *
+ *   [0, 512)   header: schema delle colonne (nome, tipo,
+ *              scala e traslazione di normalizzazione,
+ *              offset) e numero di righe
+ *   colonne    7 feature double già normalizzate e
+ *              l'etichetta (uint8), ciascuna contigua e
+ *              allineata a 64 byte
+ *
+ * Byte order nativo, verificato in lettura come per il
+ * checkpoint della rete. Un file scritto con costanti di
+ * normalizzazione diverse da quelle dello schema corrente
+ * viene rifiutato: va riconvertito.
+ */
+
+typedef struct {
+
+    long n_righe;
+    int n_feature;
+    int n_classi;
+
+    const double *col[DATASET_N_FEATURE];
+    // Feature normalizzate, una colonna per feature
+    // Dimensione: [n_righe] ciascuna, nella mappatura
+
+    const uint8_t *y;
+    // Etichette, [n_righe], valori in [0, n_classi)
+
+    void *mappa;
+    size_t mappa_dim;
+
+} Dataset_Colonne;
+
+typedef struct {
+    long righe;             // Righe valide scritte
+    int  scartate;          // Righe malformate
+} Dataset_Conversione;
+
+/*
+ * Converte il CSV nel formato colonnare. Le righe malformate
+ * sono segnalate e saltate come in dataset_carica_csv.
+ *
+ * Il file viene scritto a blocchi (memoria costante) su un
+ * temporaneo e rinominato a conversione completata.
+ *
+ * Ritorna 0 se ok, -1 in caso di errore di I/O o se il CSV
+ * cresce durante la conversione (il file non viene scritto).
+ */
+int dataset_converti_colonne(
+    const char *csv,
+    const char *destinazione,
+    Dataset_Conversione *st
+);
+
+/*
+ * Mappa in memoria un file colonnare (sola lettura).
+ * Ritorna NULL se il file non è leggibile, non è valido,
+ * usa costanti di normalizzazione diverse o ha più di
+ * INT_MAX righe (da leggere a blocchi, vedi sotto); se
+ * motivo non è NULL vi scrive la causa, per i messaggi.
+ */
+Dataset_Colonne *dataset_mappa_colonne(const char *path, const char **motivo);
+
+void dataset_colonne_free(Dataset_Colonne *dc);
+
+/* ============================================================
+ *              LETTURA A BLOCCHI
+ * ============================================================
+ *
+ * Lettura sequenziale di un dataset di dimensione arbitraria
+ * (CSV o colonnare, riconosciuto dall'header) a blocchi di
+ * righe normalizzate, con memoria indipendente dal file: il
+ * colonnare è letto con pread colonna per colonna, senza
+ * mappare il file.
+ */
+typedef struct Dataset_Flusso Dataset_Flusso;
+
+/*
+ * Apre il file. Ritorna NULL se non è leggibile o se è un
+ * file colonnare non valido.
+ */
+Dataset_Flusso *dataset_apri_flusso(const char *path);
+
+void dataset_chiudi_flusso(Dataset_Flusso *fl);
+
+/*
+ * Legge fino a max_righe righe valide:
+ *   X : feature normalizzate, [max_righe][DATASET_N_FEATURE]
+ *   y : etichette, [max_righe]
+ * Le righe CSV malformate sono segnalate e saltate.
+ *
+ * Ritorna il numero di righe lette, 0 a fine file, -1 in
+ * caso di errore di I/O.
+ */
+long dataset_leggi_blocco(Dataset_Flusso *fl, double *X, int *y,
+                          long max_righe);
+
+/*
+ * Torna all'inizio del file (nuova epoca).
+ * Ritorna 0 se ok, -1 altrimenti.
+ */
+int dataset_riavvolgi_flusso(Dataset_Flusso *fl);
+
+/*
+ * Righe malformate incontrate dall'ultimo riavvolgimento
+ * (solo CSV)
+ */
+int dataset_flusso_scartate(const Dataset_Flusso *fl);
+
+/*
+ * Byte di appoggio allocati dal flusso per blocchi di
+ * max_righe righe: il buffer di lettura per il CSV, una
+ * colonna e le etichette per il colonnare
+ */
+size_t dataset_flusso_memoria(const Dataset_Flusso *fl, long max_righe);
+
+/*
+ * Raccoglie le feature della riga r in un vettore contiguo
+ */
+static inline void dataset_colonne_riga(const Dataset_Colonne *dc, long r,
+                                        double x[DATASET_N_FEATURE]) {
+    for (int k = 0; k < DATASET_N_FEATURE; k++)
+        x[k] = dc->col[k][r];
+}
+
+#endif
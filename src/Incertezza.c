@@ -1,4 +1,6 @@
 #include "Incertezza.h"
+#include "Utilita_Tabella.h"
+#include "Metriche.h"
 
 /* ============================================================
  *                MACROAREA INCERTEZZA (ICON9)
@@ -15,6 +17,10 @@
  * Questo modulo assegna un valore di utilità a ciascuno stato
  * in funzione delle condizioni ambientali (temperatura interna
  * ed esterna) e combina tali valori tramite l'utilità attesa.
+ *
+ * Soglie e valori non sono cablati nel codice: provengono dalla
+ * tabella attiva (Utilita_Tabella.h), caricata da file e
+ * sostituibile tra un tick e l'altro.
  */
 
 /* ============================================================
@@ -29,81 +35,15 @@
  *
  * Ritorna:
  *   Valore numerico che rappresenta il "beneficio" o "costo"
- *   di riscaldare in quello stato.
+ *   di riscaldare in quello stato (0 per stati non validi).
  * ============================================================ */
 double calcola_utilita(
     int stato,
     double temp_int,
     double temp_ext
 ) {
-    double u = 0.0;
-
-    switch (stato) {
-
-        case STATO_AWAY:
-            /*
-             * Stato AWAY:
-             * - Nessuna presenza in casa
-             * - Obiettivo principale: risparmio energetico
-             * - Penalità se si spreca energia mantenendo
-             *   una temperatura interna elevata
-             */
-            if (temp_int > 16.0)
-                u = -0.5;
-            else
-                u = 0.0;
-            break;
-
-        case STATO_HOME:
-            /*
-             * Stato HOME:
-             * - Presenza attiva in casa
-             * - Comfort prioritario
-             * - Alta utilità se la temperatura è sotto
-             *   la soglia di comfort
-             */
-            if (temp_int < 19.5)
-                u = 1.2;
-            else
-                u = 0.4;
-
-            /*
-             * Bonus contestuale:
-             * Se fuori fa freddo, il valore del comfort
-             * interno aumenta ulteriormente
-             */
-            if (temp_ext < 8.0 && temp_int < 20.0)
-                u += 0.5;
-            break;
-
-        case STATO_SLEEP:
-            /*
-             * Stato SLEEP:
-             * - Comfort moderato
-             * - Penalità forte se la casa è troppo calda
-             * - Leggera utilità se la temperatura è bassa
-             *   in condizioni di freddo esterno
-             */
-            if (temp_int >= 19.5)
-                u = -2.5;
-            else
-                u = 0.2;
-
-            /*
-             * Bonus notturno:
-             * Se fuori e dentro fa molto freddo,
-             * mantenere un minimo di tepore è utile
-             */
-            if (temp_ext < 5.0 && temp_int < 17.0)
-                u += 0.3;
-            break;
-
-        default:
-            // Stato non valido → utilità nulla
-            u = 0.0;
-    }
-
-    return u;
+    const Utilita_Tabella *t = ut_attiva();
+    return t ? ut_utilita(t, stato, temp_int, temp_ext) : 0.0;
 }
 
 /* ============================================================
@@ -124,16 +64,45 @@ double utilita_attesa(
     double temp_int,
     double temp_ext
 ) {
-    double eu = 0.0;
-
     /*
      * Combinazione probabilistica:
      * ogni utilità viene pesata con la probabilità
      * stimata dalla rete neurale
      */
-    for (int s = 0; s < N_STATI; s++) {
-        eu += p[s] * calcola_utilita(s, temp_int, temp_ext);
+    MET_CONTA(EU_VALUTAZIONI, 1);
+
+    const Utilita_Tabella *t = ut_attiva();
+    return t ? ut_utilita_attesa(t, p, temp_int, temp_ext) : 0.0;
+}
+
+/* ============================================================
+ * UTILITÀ ATTESA A BATCH
+ *
+ * La tabella attiva viene letta una sola volta: tutto il
+ * batch è valutato sulla stessa tabella anche se nel
+ * frattempo ne viene pubblicata un'altra.
+ * ============================================================ */
+void utilita_attesa_batch(
+    const double p_away[],
+    const double p_home[],
+    const double p_sleep[],
+    const double temp_int[],
+    const double temp_ext[],
+    int n,
+    double eu[]
+) {
+    const Utilita_Tabella *t = ut_attiva();
+
+    MET_CONTA(EU_VALUTAZIONI, n);
+
+    if (!t) {
+        for (int i = 0; i < n; i++)
+            eu[i] = 0.0;
+        return;
     }
 
-    return eu;
+    MET_INIZIO(t0);
+    ut_utilita_attesa_batch(t, p_away, p_home, p_sleep,
+                            temp_int, temp_ext, n, eu);
+    MET_FINE(EU_BATCH, t0);
 }
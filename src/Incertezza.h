@@ -15,6 +15,7 @@
  * temp_ext  : temperatura esterna (°C)
  *
  * Ritorna il valore di utilità associato allo stato
+ * secondo la tabella attiva (Utilita_Tabella.h)
  * -------------------------------------------------- */
 double calcola_utilita(
     int stato,
@@ -37,4 +38,29 @@ double utilita_attesa(
     double temp_ext
 );
 
+/* --------------------------------------------------
+ * Utilità Attesa a batch
+ *
+ * Calcola l'utilità attesa di n appartamenti con
+ * dati in formato structure-of-arrays:
+ *
+ * p_away, p_home, p_sleep : P(stato | evidenze), [n]
+ * temp_int, temp_ext      : temperature (°C), [n]
+ * eu                      : utilità attese, [n]
+ *
+ * Senza salti condizionali (conteggio delle soglie):
+ * il costo non dipende dalla distribuzione delle
+ * temperature. Il risultato coincide bit per bit
+ * con utilita_attesa sullo stesso appartamento.
+ * -------------------------------------------------- */
+void utilita_attesa_batch(
+    const double p_away[],
+    const double p_home[],
+    const double p_sleep[],
+    const double temp_int[],
+    const double temp_ext[],
+    int n,
+    double eu[]
+);
+
 #endif
@@ -0,0 +1,261 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "Metriche.h"
+#include "Orologio.h"
+
+/* ============================================================
+ * BLOCCHI PER THREAD
+ * ============================================================
+ *
+ * Ogni blocco ha un solo scrittore (il thread proprietario),
+ * che aggiorna con load + store rilassati: nessun lock e nessun
+ * fetch_add sui percorsi misurati. L'aggregazione legge gli
+ * stessi campi in modo rilassato; un'istantanea può quindi
+ * mancare gli aggiornamenti in corso, mai corromperli.
+ *
+ * I blocchi restano nella lista globale per tutta la vita del
+ * processo: quando un thread termina il suo blocco viene
+ * marcato libero e riusato dal prossimo thread, senza perdere
+ * i valori accumulati. I blocchi sono al più quanti i thread
+ * attivi contemporaneamente.
+ *
+ * Ogni blocco è allineato a 64 byte e ne occupa un multiplo:
+ * i contatori di due thread non condividono linee di cache.
+ */
+
+typedef struct Met_Blocco {
+    _Alignas(64) _Atomic uint64_t contatori[MET_N_CONTATORI];
+    _Atomic uint64_t conteggio[MET_N_TEMPI];
+    _Atomic uint64_t somma_ns[MET_N_TEMPI];
+    _Atomic uint64_t bucket[MET_N_TEMPI][MET_N_BUCKET];
+
+    atomic_int libero;
+    struct Met_Blocco *succ;        // Immutabile dopo l'inserimento
+} Met_Blocco;
+
+static _Atomic(Met_Blocco *) blocchi;
+static atomic_int n_blocchi;
+static uint64_t inizio_ns;
+
+static _Thread_local Met_Blocco *mio;
+
+static pthread_once_t chiave_una_volta = PTHREAD_ONCE_INIT;
+static pthread_key_t chiave;
+
+static const char *const nomi_contatori[] = {
+#define MET_NOME(id, nome) nome,
+    METRICHE_CONTATORI(MET_NOME)
+};
+static const char *const nomi_tempi[] = {
+    METRICHE_TEMPI(MET_NOME)
+#undef MET_NOME
+};
+
+uint64_t met_adesso_ns(void) {
+    return orologio_ns();
+}
+
+/* Alla fine del thread il blocco torna disponibile */
+static void met_rilascia_blocco(void *b) {
+    atomic_store(&((Met_Blocco*)b)->libero, 1);
+}
+
+static void met_crea_chiave(void) {
+    pthread_key_create(&chiave, met_rilascia_blocco);
+    inizio_ns = met_adesso_ns();
+}
+
+/* Percorso lento: prima registrazione del thread */
+static Met_Blocco *met_blocco_nuovo(void) {
+    pthread_once(&chiave_una_volta, met_crea_chiave);
+
+    Met_Blocco *b;
+    for (b = atomic_load(&blocchi); b; b = b->succ) {
+        int libero = 1;
+        if (atomic_compare_exchange_strong(&b->libero, &libero, 0))
+            break;
+    }
+
+    if (!b) {
+        b = (Met_Blocco*)aligned_alloc(_Alignof(Met_Blocco), sizeof(Met_Blocco));
+        if (!b) return NULL;
+        memset(b, 0, sizeof(*b));
+        b->succ = atomic_load(&blocchi);
+        while (!atomic_compare_exchange_weak(&blocchi, &b->succ, b))
+            ;
+        atomic_fetch_add(&n_blocchi, 1);
+    }
+
+    pthread_setspecific(chiave, b);
+    mio = b;
+    return b;
+}
+
+static inline Met_Blocco *met_blocco(void) {
+    return mio ? mio : met_blocco_nuovo();
+}
+
+static inline void met_aggiungi(_Atomic uint64_t *c, uint64_t n) {
+    atomic_store_explicit(c,
+        atomic_load_explicit(c, memory_order_relaxed) + n,
+        memory_order_relaxed);
+}
+
+/* ============================================================
+ * REGISTRAZIONE
+ * ============================================================ */
+
+void met_conta(int contatore, uint64_t n) {
+    Met_Blocco *b = met_blocco();
+    if (b) met_aggiungi(&b->contatori[contatore], n);
+}
+
+void met_durata_ns(int tempo, uint64_t ns) {
+    Met_Blocco *b = met_blocco();
+    if (!b) return;
+
+    /* Bucket k: [2^(k-1), 2^k) ns; lo 0 nel bucket 0 */
+    int k = ns ? 64 - __builtin_clzll(ns) : 0;
+    if (k >= MET_N_BUCKET) k = MET_N_BUCKET - 1;
+
+    met_aggiungi(&b->conteggio[tempo], 1);
+    met_aggiungi(&b->somma_ns[tempo], ns);
+    met_aggiungi(&b->bucket[tempo][k], 1);
+}
+
+/* ============================================================
+ * LETTURA
+ * ============================================================ */
+
+void met_aggrega(Met_Istantanea *ist) {
+    memset(ist, 0, sizeof(*ist));
+
+    for (Met_Blocco *b = atomic_load(&blocchi); b; b = b->succ) {
+        for (int c = 0; c < MET_N_CONTATORI; c++)
+            ist->contatori[c] += atomic_load_explicit(&b->contatori[c], memory_order_relaxed);
+        for (int t = 0; t < MET_N_TEMPI; t++) {
+            ist->conteggio[t] += atomic_load_explicit(&b->conteggio[t], memory_order_relaxed);
+            ist->somma_ns[t] += atomic_load_explicit(&b->somma_ns[t], memory_order_relaxed);
+            for (int k = 0; k < MET_N_BUCKET; k++)
+                ist->bucket[t][k] += atomic_load_explicit(&b->bucket[t][k], memory_order_relaxed);
+        }
+    }
+
+    ist->n_thread = atomic_load(&n_blocchi);
+    if (ist->n_thread > 0)
+        ist->secondi = (double)(met_adesso_ns() - inizio_ns) * 1e-9;
+}
+
+uint64_t met_quantile_ns(const Met_Istantanea *ist, int tempo, double q) {
+    /* Il conteggio può precedere i bucket di un aggiornamento
+     * in corso: si usa la somma dei bucket */
+    uint64_t totale = 0;
+    for (int k = 0; k < MET_N_BUCKET; k++)
+        totale += ist->bucket[tempo][k];
+    if (totale == 0) return 0;
+
+    const uint64_t soglia = (uint64_t)(q * (double)(totale - 1)) + 1;
+    uint64_t cumulato = 0;
+    for (int k = 0; k < MET_N_BUCKET; k++) {
+        cumulato += ist->bucket[tempo][k];
+        if (cumulato >= soglia)
+            return k ? (uint64_t)1 << k : 0;
+    }
+    return (uint64_t)1 << (MET_N_BUCKET - 1);
+}
+
+int met_scrivi(FILE *f) {
+    Met_Istantanea ist;
+    met_aggrega(&ist);
+
+    fprintf(f, "secondi %.3f\n", ist.secondi);
+    fprintf(f, "thread %d\n", ist.n_thread);
+
+    for (int c = 0; c < MET_N_CONTATORI; c++)
+        fprintf(f, "%s %llu\n", nomi_contatori[c],
+                (unsigned long long)ist.contatori[c]);
+
+    if (ist.secondi > 0.0)
+        fprintf(f, "nn_campioni_al_secondo %.1f\n",
+                (double)ist.contatori[MET_C_NN_CAMPIONI] / ist.secondi);
+
+    for (int t = 0; t < MET_N_TEMPI; t++) {
+        const char *n = nomi_tempi[t];
+        fprintf(f, "%s_conteggio %llu\n", n, (unsigned long long)ist.conteggio[t]);
+        fprintf(f, "%s_somma %llu\n", n, (unsigned long long)ist.somma_ns[t]);
+        fprintf(f, "%s_p50 %llu\n", n, (unsigned long long)met_quantile_ns(&ist, t, 0.50));
+        fprintf(f, "%s_p99 %llu\n", n, (unsigned long long)met_quantile_ns(&ist, t, 0.99));
+        for (int k = 0; k < MET_N_BUCKET; k++)
+            if (ist.bucket[t][k])
+                fprintf(f, "%s_bucket{le=%llu} %llu\n", n,
+                        k ? 1ULL << k : 0ULL,
+                        (unsigned long long)ist.bucket[t][k]);
+    }
+
+    return ferror(f) ? -1 : 0;
+}
+
+/* ============================================================
+ * DESTINAZIONI
+ * ============================================================ */
+
+/* File temporaneo nella stessa directory, poi rename: chi legge
+ * il file non vede mai un dump a metà */
+static int met_scrivi_file(const char *percorso) {
+    const size_t n = strlen(percorso);
+    char *tmp = (char*)malloc(n + 5);
+    if (!tmp) return -1;
+    memcpy(tmp, percorso, n);
+    memcpy(tmp + n, ".tmp", 5);
+
+    FILE *f = fopen(tmp, "w");
+    int esito = -1;
+    if (f) {
+        esito = met_scrivi(f);
+        if (fclose(f) != 0) esito = -1;
+        if (esito == 0 && rename(tmp, percorso) != 0) esito = -1;
+        if (esito != 0) remove(tmp);
+    }
+
+    free(tmp);
+    return esito;
+}
+
+/* Il dump viene inviato a un processo in ascolto sul socket */
+static int met_scrivi_socket(const char *percorso) {
+    struct sockaddr_un ind;
+    if (strlen(percorso) >= sizeof(ind.sun_path)) return -1;
+
+    memset(&ind, 0, sizeof(ind));
+    ind.sun_family = AF_UNIX;
+    strcpy(ind.sun_path, percorso);
+
+    const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    if (connect(fd, (struct sockaddr*)&ind, sizeof(ind)) != 0) {
+        close(fd);
+        return -1;
+    }
+
+    FILE *f = fdopen(fd, "w");
+    if (!f) {
+        close(fd);
+        return -1;
+    }
+    int esito = met_scrivi(f);
+    if (fclose(f) != 0) esito = -1;
+    return esito;
+}
+
+int met_scrivi_destinazione(const char *dest) {
+    if (strncmp(dest, "unix:", 5) == 0)
+        return met_scrivi_socket(dest + 5);
+    return met_scrivi_file(dest);
+}
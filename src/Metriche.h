@@ -0,0 +1,121 @@
+#ifndef METRICHE_H
+#define METRICHE_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+/* ============================================================
+ *          METRICHE DI ESERCIZIO SUI PERCORSI CRITICI
+ * ============================================================
+ *
+ * Contatori e istogrammi di latenza aggiornati dal processo
+ * in produzione (rete neurale, utilità attesa, PL).
+ *
+ * Ogni thread scrive in un proprio blocco, senza operazioni
+ * atomiche di lettura-modifica-scrittura né condivisione di
+ * linee di cache; i blocchi vengono sommati solo quando si
+ * chiede un'istantanea (met_aggrega, met_scrivi*).
+ *
+ * Istogrammi a bucket fissi in potenze di 2 di nanosecondi:
+ * il bucket k contiene le durate in [2^(k-1), 2^k) ns.
+ *
+ * Abilitazione a compilazione: -DMETRICHE_ABILITATE
+ * (make CON_METRICHE=1). Senza il flag le macro MET_* non
+ * generano codice: nessuna chiamata, lettura dell'orologio
+ * o accesso a memoria nei percorsi misurati.
+ */
+
+/* --------------------------------------------------
+ * Elenco delle metriche (X-macro): identificatore e
+ * nome nel dump
+ * -------------------------------------------------- */
+#define METRICHE_CONTATORI(X)                              \
+    X(NN_CAMPIONI,          "nn_campioni_addestrati")      \
+    X(NN_AGGIORNAMENTI,     "nn_aggiornamenti_pesi")       \
+    X(NN_FORWARD,           "nn_forward_chiamate")         \
+    X(NN_FORWARD_CAMPIONI,  "nn_forward_campioni")         \
+    X(EU_VALUTAZIONI,       "eu_valutazioni")              \
+    X(PL_RISOLUZIONI,       "pl_risoluzioni")              \
+    X(PL_RAPIDE,            "pl_risoluzioni_rapide")       \
+    X(PL_ITERAZIONI,        "pl_iterazioni_simplex")       \
+    X(PL_RIPARTENZE,        "pl_ripartenze_base")          \
+    X(PL_ERRORI_SIMPLEX,    "pl_errori_glp_simplex")       \
+    X(PL_NON_OTTIME,        "pl_soluzioni_non_ottime")
+
+#define METRICHE_TEMPI(X)                                  \
+    X(NN_TRAIN,             "nn_train_ns")                 \
+    X(NN_FORWARD,           "nn_forward_ns")               \
+    X(EU_BATCH,             "eu_batch_ns")                 \
+    X(PL_RISOLVI,           "pl_risolvi_ns")
+
+#define MET_ENUM_C(id, nome) MET_C_##id,
+#define MET_ENUM_T(id, nome) MET_T_##id,
+enum { METRICHE_CONTATORI(MET_ENUM_C) MET_N_CONTATORI };
+enum { METRICHE_TEMPI(MET_ENUM_T) MET_N_TEMPI };
+#undef MET_ENUM_C
+#undef MET_ENUM_T
+
+#define MET_N_BUCKET 40     // Fino a 2^39 ns ≈ 9 minuti
+
+/* Somma su tutti i thread */
+typedef struct {
+    uint64_t contatori[MET_N_CONTATORI];
+    uint64_t conteggio[MET_N_TEMPI];
+    uint64_t somma_ns[MET_N_TEMPI];
+    uint64_t bucket[MET_N_TEMPI][MET_N_BUCKET];
+    double secondi;         // Dalla prima registrazione
+    int n_thread;           // Blocchi per thread allocati
+} Met_Istantanea;
+
+/* --------------------------------------------------
+ * Registrazione (usare le macro MET_*)
+ * -------------------------------------------------- */
+void met_conta(int contatore, uint64_t n);
+void met_durata_ns(int tempo, uint64_t ns);
+uint64_t met_adesso_ns(void);
+
+/* --------------------------------------------------
+ * Lettura
+ * -------------------------------------------------- */
+void met_aggrega(Met_Istantanea *ist);
+
+/*
+ * Quantile q ∈ [0,1] stimato dall'istogramma: limite
+ * superiore del bucket che lo contiene (ns)
+ */
+uint64_t met_quantile_ns(const Met_Istantanea *ist, int tempo, double q);
+
+/*
+ * Dump testuale, una metrica per riga ("nome valore"),
+ * con conteggio, somma, p50/p99 e bucket non vuoti per
+ * ogni istogramma. Ritorna 0 se ok, -1 in caso di errore.
+ */
+int met_scrivi(FILE *f);
+
+/*
+ * Dump verso una destinazione:
+ *   "unix:<percorso>"  socket locale (SOCK_STREAM) in ascolto
+ *   altro              file, sostituito atomicamente
+ */
+int met_scrivi_destinazione(const char *dest);
+
+/* --------------------------------------------------
+ * Punti di misura
+ * -------------------------------------------------- */
+#ifdef METRICHE_ABILITATE
+
+#define MET_CONTA(id, n)        met_conta(MET_C_##id, (uint64_t)(n))
+#define MET_INIZIO(var)         const uint64_t var = met_adesso_ns()
+#define MET_FINE(id, var)       met_durata_ns(MET_T_##id, met_adesso_ns() - (var))
+#define MET_DURATA(id, secondi) met_durata_ns(MET_T_##id, (uint64_t)((secondi) * 1e9))
+
+#else
+
+#define MET_CONTA(id, n)        ((void)0)
+#define MET_INIZIO(var)
+#define MET_FINE(id, var)       ((void)0)
+#define MET_DURATA(id, secondi) ((void)0)
+
+#endif
+
+#endif
@@ -0,0 +1,271 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <pthread.h>
+#include "Dataset.h"
+#include "NN_Blocchi.h"
+#include "Orologio.h"
+
+/* ============================================================
+ * STRUTTURA
+ * ============================================================ */
+
+typedef struct {
+    double *X;              // [righe_blocco][DATASET_N_FEATURE]
+    int *y;                 // [righe_blocco]
+    long righe;             // Righe valide; 0 = fine file, -1 = errore
+} NNB_Buffer;
+
+struct NN_Blocchi {
+
+    Dataset_Flusso *flusso; // Usato solo dal lettore durante l'epoca
+    long righe_blocco;
+    int n_blocchi;
+    int batch;
+
+    NNB_Buffer *anello;
+
+    /* Solo il thread di training */
+    int *ordine;            // [righe_blocco]
+    double *Xb, *Yb;        // Mini-batch raccolto, se batch > 1
+
+    /* Anello: il buffer k % n_blocchi è il k-esimo prodotto */
+    pthread_mutex_t mutex;
+    pthread_cond_t  libero;
+    pthread_cond_t  pronto;
+    long prodotti;
+    long consumati;
+    int ferma;              // Il training ha smesso di consumare
+
+    NNB_Statistiche st;
+};
+
+/* ============================================================
+ * THREAD LETTORE
+ * ============================================================
+ *
+ * Riempie i buffer liberi nell'ordine dell'anello. L'ultimo
+ * buffer prodotto ha righe <= 0 (fine file o errore): il
+ * training si ferma lì e il lettore è già uscito.
+ */
+
+static void *nnb_lettore(void *arg) {
+    NN_Blocchi *b = (NN_Blocchi*)arg;
+    double attesa = 0.0;
+    long n;
+
+    do {
+        pthread_mutex_lock(&b->mutex);
+        if (b->prodotti - b->consumati == b->n_blocchi) {
+            const double t0 = orologio_secondi();
+            while (!b->ferma && b->prodotti - b->consumati == b->n_blocchi)
+                pthread_cond_wait(&b->libero, &b->mutex);
+            attesa += orologio_secondi() - t0;
+        }
+        if (b->ferma) {
+            pthread_mutex_unlock(&b->mutex);
+            break;
+        }
+        NNB_Buffer *buf = &b->anello[b->prodotti % b->n_blocchi];
+        pthread_mutex_unlock(&b->mutex);
+
+        n = dataset_leggi_blocco(b->flusso, buf->X, buf->y, b->righe_blocco);
+        buf->righe = n;
+
+        pthread_mutex_lock(&b->mutex);
+        b->prodotti++;
+        pthread_cond_signal(&b->pronto);
+        pthread_mutex_unlock(&b->mutex);
+    } while (n > 0);
+
+    /* Letto dal chiamante dopo il join */
+    b->st.attesa_lettura = attesa;
+    return NULL;
+}
+
+/* ============================================================
+ * TRAINING DI UN BLOCCO
+ * ============================================================ */
+
+/* Ritorna 0 se ok, -1 se un passo a mini-batch non riesce */
+static int nnb_addestra(NN_Blocchi *b, NeuralNetwork *net,
+                        const NNB_Buffer *buf) {
+    const int n = (int)buf->righe;
+
+    /* Permutazione ripartendo dall'identità: l'ultimo blocco
+     * può essere più corto */
+    for (int k = 0; k < n; k++)
+        b->ordine[k] = k;
+    nn_mescola(net, b->ordine, n);
+
+    if (b->batch <= 1) {
+        for (int k = 0; k < n; k++) {
+            const int r = b->ordine[k];
+            double target[DATASET_N_CLASSI] = { 0 };
+            target[buf->y[r]] = 1.0;
+            nn_train(net, &buf->X[(size_t)r * DATASET_N_FEATURE], target);
+        }
+        return 0;
+    }
+
+    for (int k = 0; k < n; k += b->batch) {
+        const int m = (n - k < b->batch) ? n - k : b->batch;
+
+        memset(b->Yb, 0, (size_t)m * DATASET_N_CLASSI * sizeof(double));
+        for (int i = 0; i < m; i++) {
+            const int r = b->ordine[k + i];
+            memcpy(&b->Xb[(size_t)i * DATASET_N_FEATURE],
+                   &buf->X[(size_t)r * DATASET_N_FEATURE],
+                   DATASET_N_FEATURE * sizeof(double));
+            b->Yb[(size_t)i * DATASET_N_CLASSI + buf->y[r]] = 1.0;
+        }
+
+        if (nn_train_batch(net, b->Xb, b->Yb, m) != 0)
+            return -1;
+    }
+    return 0;
+}
+
+/* ============================================================
+ * CREAZIONE E DISTRUZIONE
+ * ============================================================ */
+
+NN_Blocchi *nnb_crea(const char *sorgente, long righe_blocco,
+                     int n_blocchi, int batch) {
+
+    /* nn_mescola lavora su indici int */
+    if (righe_blocco < 1 || righe_blocco > INT_MAX || n_blocchi < 2)
+        return NULL;
+    if (batch < 1) batch = 1;
+    if (batch > righe_blocco) batch = (int)righe_blocco;
+
+    NN_Blocchi *b = (NN_Blocchi*)calloc(1, sizeof(NN_Blocchi));
+    if (!b) return NULL;
+
+    b->righe_blocco = righe_blocco;
+    b->n_blocchi = n_blocchi;
+    b->batch = batch;
+
+    const size_t r = (size_t)righe_blocco;
+    b->flusso = dataset_apri_flusso(sorgente);
+    b->anello = (NNB_Buffer*)calloc((size_t)n_blocchi, sizeof(NNB_Buffer));
+    b->ordine = (int*)malloc(r * sizeof(int));
+    if (batch > 1) {
+        b->Xb = (double*)malloc((size_t)batch * DATASET_N_FEATURE * sizeof(double));
+        b->Yb = (double*)malloc((size_t)batch * DATASET_N_CLASSI * sizeof(double));
+    }
+
+    int ok = b->flusso && b->anello && b->ordine &&
+             (batch == 1 || (b->Xb && b->Yb));
+    for (int k = 0; ok && k < n_blocchi; k++) {
+        b->anello[k].X = (double*)malloc(r * DATASET_N_FEATURE * sizeof(double));
+        b->anello[k].y = (int*)malloc(r * sizeof(int));
+        ok = b->anello[k].X && b->anello[k].y;
+    }
+    if (!ok) {
+        nnb_free(b);
+        return NULL;
+    }
+
+    b->st.memoria = (size_t)n_blocchi * r * (DATASET_N_FEATURE * sizeof(double) + sizeof(int))
+                  + r * sizeof(int)
+                  + (batch > 1 ? (size_t)batch * (DATASET_N_FEATURE + DATASET_N_CLASSI) * sizeof(double) : 0)
+                  + dataset_flusso_memoria(b->flusso, righe_blocco);
+
+    pthread_mutex_init(&b->mutex, NULL);
+    pthread_cond_init(&b->libero, NULL);
+    pthread_cond_init(&b->pronto, NULL);
+    return b;
+}
+
+void nnb_free(NN_Blocchi *b) {
+    if (!b) return;
+
+    /* Mutex e condizioni esistono solo se l'anello è completo */
+    if (b->st.memoria) {
+        pthread_mutex_destroy(&b->mutex);
+        pthread_cond_destroy(&b->libero);
+        pthread_cond_destroy(&b->pronto);
+    }
+
+    if (b->anello)
+        for (int k = 0; k < b->n_blocchi; k++) {
+            free(b->anello[k].X);
+            free(b->anello[k].y);
+        }
+    free(b->anello);
+    free(b->ordine);
+    free(b->Xb);
+    free(b->Yb);
+    dataset_chiudi_flusso(b->flusso);
+    free(b);
+}
+
+/* ============================================================
+ * EPOCA
+ * ============================================================ */
+
+long nnb_epoca(NN_Blocchi *b, NeuralNetwork *net) {
+    if (net->num_inputs != DATASET_N_FEATURE ||
+        net->num_outputs != DATASET_N_CLASSI)
+        return -1;
+    if (dataset_riavvolgi_flusso(b->flusso) != 0)
+        return -1;
+
+    const size_t memoria = b->st.memoria;
+    b->st = (NNB_Statistiche){ .memoria = memoria };
+    b->prodotti = b->consumati = 0;
+    b->ferma = 0;
+
+    pthread_t lettore;
+    if (pthread_create(&lettore, NULL, nnb_lettore, b) != 0)
+        return -1;
+
+    long esito;
+    for (;;) {
+        pthread_mutex_lock(&b->mutex);
+        if (b->consumati == b->prodotti) {
+            const double t0 = orologio_secondi();
+            while (b->consumati == b->prodotti)
+                pthread_cond_wait(&b->pronto, &b->mutex);
+            b->st.attesa_training += orologio_secondi() - t0;
+        }
+        const NNB_Buffer *buf = &b->anello[b->consumati % b->n_blocchi];
+        pthread_mutex_unlock(&b->mutex);
+
+        if (buf->righe <= 0) {
+            esito = buf->righe;
+            break;
+        }
+
+        /* Passo non riuscito: il lettore viene fermato prima
+         * del join */
+        if (nnb_addestra(b, net, buf) != 0) {
+            pthread_mutex_lock(&b->mutex);
+            b->ferma = 1;
+            pthread_cond_signal(&b->libero);
+            pthread_mutex_unlock(&b->mutex);
+            esito = -1;
+            break;
+        }
+        b->st.righe += buf->righe;
+        b->st.blocchi++;
+
+        /* Il buffer torna al lettore solo dopo il training */
+        pthread_mutex_lock(&b->mutex);
+        b->consumati++;
+        pthread_cond_signal(&b->libero);
+        pthread_mutex_unlock(&b->mutex);
+    }
+
+    pthread_join(lettore, NULL);
+    b->st.scartate = dataset_flusso_scartate(b->flusso);
+
+    return esito < 0 ? -1 : b->st.righe;
+}
+
+void nnb_statistiche(const NN_Blocchi *b, NNB_Statistiche *st) {
+    *st = b->st;
+}
@@ -0,0 +1,68 @@
+#ifndef NN_BLOCCHI_H
+#define NN_BLOCCHI_H
+
+#include "NeuralNetwork.h"
+
+/* ============================================================
+ *        TRAINING A BLOCCHI SU DATASET FUORI MEMORIA
+ * ============================================================
+ *
+ * Il dataset (CSV o colonnare, vedi dataset_apri_flusso) non
+ * viene mai caricato per intero. Durante un'epoca un thread
+ * lettore legge e normalizza il blocco successivo in un anello
+ * di n_blocchi buffer di dimensione fissa, mentre il thread
+ * chiamante addestra la rete sul blocco corrente: la lettura
+ * si sovrappone al calcolo e la memoria di picco dipende solo
+ * da righe_blocco e n_blocchi, non dalla dimensione del file.
+ *
+ * I campioni sono rimescolati solo all'interno di ciascun
+ * blocco (dal generatore della rete); l'ordine dei blocchi è
+ * quello del file. Con un CSV ordinato per tempo conviene
+ * quindi usare blocchi grandi.
+ */
+
+typedef struct NN_Blocchi NN_Blocchi;
+
+typedef struct {
+    long righe;             // Righe addestrate nell'ultima epoca
+    long scartate;          // Righe CSV malformate nell'ultima epoca
+    long blocchi;           // Blocchi consumati nell'ultima epoca
+    double attesa_training; // Secondi del training fermo in attesa di dati
+    double attesa_lettura;  // Secondi del lettore fermo ad anello pieno
+    size_t memoria;         // Byte allocati: anello, batch e appoggi del flusso
+} NNB_Statistiche;
+
+/*
+ * Apre 'sorgente' e alloca l'anello.
+ *
+ * righe_blocco : righe per buffer
+ * n_blocchi    : buffer dell'anello (almeno 2)
+ * batch        : campioni per aggiornamento; 1 = nn_train
+ *                campione per campione, altrimenti
+ *                nn_train_batch su mini-batch interni al blocco
+ *
+ * Ritorna NULL se il file non è leggibile o in caso di errore.
+ */
+NN_Blocchi *nnb_crea(
+    const char *sorgente,
+    long righe_blocco,
+    int n_blocchi,
+    int batch
+);
+
+void nnb_free(NN_Blocchi *b);
+
+/*
+ * Un'epoca sull'intero file. La rete deve avere
+ * DATASET_N_FEATURE input e DATASET_N_CLASSI output.
+ *
+ * Ritorna le righe addestrate, -1 in caso di errore di
+ * lettura, di un passo di training non riuscito (memoria
+ * insufficiente; le righe già addestrate restano applicate)
+ * o di architettura incompatibile.
+ */
+long nnb_epoca(NN_Blocchi *b, NeuralNetwork *net);
+
+void nnb_statistiche(const NN_Blocchi *b, NNB_Statistiche *st);
+
+#endif
@@ -0,0 +1,354 @@
+#include <stdatomic.h>
+#include <pthread.h>
+#include "NN_Kernels.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define NNK_X86 1
+#include <immintrin.h>
+#endif
+
+/* ============================================================
+ * TABELLA DEI KERNEL
+ * ============================================================
+ *
+ * Ogni percorso (scalare, SSE2, AVX2) fornisce una tabella
+ * di puntatori a funzione; le funzioni pubbliche delegano
+ * alla tabella attiva.
+ */
+typedef struct {
+    double (*dot)(int n, const double *x, const double *y);
+    void (*axpy)(int n, double a, const double *x, double *y);
+    void (*axpby)(int n, double a, const double *x, double b, double *y);
+    void (*axpby_retro)(int n, double a, const double *x, double b,
+                        double *y, double c, double *g);
+} NNK_Tabella;
+
+/* ============================================================
+ * PERCORSO SCALARE (RIFERIMENTO PORTABILE)
+ * ============================================================ */
+
+static double dot_scalare(int n, const double *x, const double *y) {
+    double s = 0.0;
+    for (const double *fine = x + n; x < fine; x++, y++)
+        s += *x * *y;
+    return s;
+}
+
+static void axpy_scalare(int n, double a, const double *x, double *y) {
+    for (const double *fine = x + n; x < fine; x++, y++)
+        *y += a * *x;
+}
+
+static void axpby_scalare(int n, double a, const double *x,
+                          double b, double *y) {
+    for (const double *fine = x + n; x < fine; x++, y++)
+        *y = a * *x + b * *y;
+}
+
+static void axpby_retro_scalare(int n, double a, const double *x, double b,
+                                double *y, double c, double *g) {
+    for (int i = 0; i < n; i++) {
+        const double v = y[i];
+        g[i] += c * v;
+        y[i] = a * x[i] + b * v;
+    }
+}
+
+static const NNK_Tabella tab_scalare = {
+    dot_scalare, axpy_scalare, axpby_scalare, axpby_retro_scalare
+};
+
+#ifdef NNK_X86
+
+/* ============================================================
+ * PERCORSO SSE2 (2 double per registro)
+ * ============================================================ */
+
+static double dot_sse2(int n, const double *x, const double *y) {
+    __m128d s0 = _mm_setzero_pd();
+    __m128d s1 = _mm_setzero_pd();
+    int i = 0;
+
+    for (; i + 4 <= n; i += 4) {
+        s0 = _mm_add_pd(s0, _mm_mul_pd(_mm_loadu_pd(x + i),
+                                       _mm_loadu_pd(y + i)));
+        s1 = _mm_add_pd(s1, _mm_mul_pd(_mm_loadu_pd(x + i + 2),
+                                       _mm_loadu_pd(y + i + 2)));
+    }
+    for (; i + 2 <= n; i += 2)
+        s0 = _mm_add_pd(s0, _mm_mul_pd(_mm_loadu_pd(x + i),
+                                       _mm_loadu_pd(y + i)));
+
+    s0 = _mm_add_pd(s0, s1);
+    double s = _mm_cvtsd_f64(_mm_add_sd(s0, _mm_unpackhi_pd(s0, s0)));
+
+    for (; i < n; i++)
+        s += x[i] * y[i];
+    return s;
+}
+
+static void axpy_sse2(int n, double a, const double *x, double *y) {
+    const __m128d va = _mm_set1_pd(a);
+    int i = 0;
+
+    for (; i + 2 <= n; i += 2)
+        _mm_storeu_pd(y + i, _mm_add_pd(_mm_loadu_pd(y + i),
+                                        _mm_mul_pd(va, _mm_loadu_pd(x + i))));
+    for (; i < n; i++)
+        y[i] += a * x[i];
+}
+
+static void axpby_sse2(int n, double a, const double *x,
+                       double b, double *y) {
+    const __m128d va = _mm_set1_pd(a);
+    const __m128d vb = _mm_set1_pd(b);
+    int i = 0;
+
+    for (; i + 2 <= n; i += 2)
+        _mm_storeu_pd(y + i,
+            _mm_add_pd(_mm_mul_pd(va, _mm_loadu_pd(x + i)),
+                       _mm_mul_pd(vb, _mm_loadu_pd(y + i))));
+    for (; i < n; i++)
+        y[i] = a * x[i] + b * y[i];
+}
+
+static void axpby_retro_sse2(int n, double a, const double *x, double b,
+                             double *y, double c, double *g) {
+    const __m128d va = _mm_set1_pd(a);
+    const __m128d vb = _mm_set1_pd(b);
+    const __m128d vc = _mm_set1_pd(c);
+    int i = 0;
+
+    for (; i + 2 <= n; i += 2) {
+        const __m128d v = _mm_loadu_pd(y + i);
+        _mm_storeu_pd(g + i, _mm_add_pd(_mm_loadu_pd(g + i),
+                                        _mm_mul_pd(vc, v)));
+        _mm_storeu_pd(y + i,
+            _mm_add_pd(_mm_mul_pd(va, _mm_loadu_pd(x + i)),
+                       _mm_mul_pd(vb, v)));
+    }
+    for (; i < n; i++) {
+        const double v = y[i];
+        g[i] += c * v;
+        y[i] = a * x[i] + b * v;
+    }
+}
+
+static const NNK_Tabella tab_sse2 = {
+    dot_sse2, axpy_sse2, axpby_sse2, axpby_retro_sse2
+};
+
+/* ============================================================
+ * PERCORSO AVX2 + FMA (4 double per registro)
+ * ============================================================
+ *
+ * Compilato con l'attributo target: il resto del programma
+ * resta eseguibile su CPU prive di AVX2.
+ */
+
+#define NNK_AVX2_FN __attribute__((target("avx2,fma")))
+
+NNK_AVX2_FN
+static double dot_avx2(int n, const double *x, const double *y) {
+    __m256d s0 = _mm256_setzero_pd();
+    __m256d s1 = _mm256_setzero_pd();
+    int i = 0;
+
+    for (; i + 8 <= n; i += 8) {
+        s0 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i),
+                             _mm256_loadu_pd(y + i), s0);
+        s1 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i + 4),
+                             _mm256_loadu_pd(y + i + 4), s1);
+    }
+    for (; i + 4 <= n; i += 4)
+        s0 = _mm256_fmadd_pd(_mm256_loadu_pd(x + i),
+                             _mm256_loadu_pd(y + i), s0);
+
+    s0 = _mm256_add_pd(s0, s1);
+    __m128d r = _mm_add_pd(_mm256_castpd256_pd128(s0),
+                           _mm256_extractf128_pd(s0, 1));
+    double s = _mm_cvtsd_f64(_mm_add_sd(r, _mm_unpackhi_pd(r, r)));
+
+    for (; i < n; i++)
+        s += x[i] * y[i];
+    return s;
+}
+
+NNK_AVX2_FN
+static void axpy_avx2(int n, double a, const double *x, double *y) {
+    const __m256d va = _mm256_set1_pd(a);
+    int i = 0;
+
+    for (; i + 4 <= n; i += 4)
+        _mm256_storeu_pd(y + i, _mm256_fmadd_pd(va, _mm256_loadu_pd(x + i),
+                                                _mm256_loadu_pd(y + i)));
+    for (; i < n; i++)
+        y[i] += a * x[i];
+}
+
+NNK_AVX2_FN
+static void axpby_avx2(int n, double a, const double *x,
+                       double b, double *y) {
+    const __m256d va = _mm256_set1_pd(a);
+    const __m256d vb = _mm256_set1_pd(b);
+    int i = 0;
+
+    for (; i + 4 <= n; i += 4)
+        _mm256_storeu_pd(y + i,
+            _mm256_fmadd_pd(va, _mm256_loadu_pd(x + i),
+                            _mm256_mul_pd(vb, _mm256_loadu_pd(y + i))));
+    for (; i < n; i++)
+        y[i] = a * x[i] + b * y[i];
+}
+
+NNK_AVX2_FN
+static void axpby_retro_avx2(int n, double a, const double *x, double b,
+                             double *y, double c, double *g) {
+    const __m256d va = _mm256_set1_pd(a);
+    const __m256d vb = _mm256_set1_pd(b);
+    const __m256d vc = _mm256_set1_pd(c);
+    int i = 0;
+
+    for (; i + 4 <= n; i += 4) {
+        const __m256d v = _mm256_loadu_pd(y + i);
+        _mm256_storeu_pd(g + i, _mm256_fmadd_pd(vc, v, _mm256_loadu_pd(g + i)));
+        _mm256_storeu_pd(y + i,
+            _mm256_fmadd_pd(va, _mm256_loadu_pd(x + i),
+                            _mm256_mul_pd(vb, v)));
+    }
+    for (; i < n; i++) {
+        const double v = y[i];
+        g[i] += c * v;
+        y[i] = a * x[i] + b * v;
+    }
+}
+
+static const NNK_Tabella tab_avx2 = {
+    dot_avx2, axpy_avx2, axpby_avx2, axpby_retro_avx2
+};
+
+#endif /* NNK_X86 */
+
+/* ============================================================
+ * SELEZIONE DEL PERCORSO A RUNTIME
+ * ============================================================ */
+
+/*
+ * nnk_inizializza può essere raggiunta da più thread (ogni
+ * nn_clone passa da nn_alloca): la selezione avviene una volta
+ * sola con pthread_once, e la tabella è pubblicata con una
+ * store di rilascio letta dai kernel con una load di
+ * acquisizione.
+ */
+static _Atomic(const NNK_Tabella *) attiva = &tab_scalare;
+static atomic_int percorso = NNK_SCALARE;
+static pthread_once_t una_volta = PTHREAD_ONCE_INIT;
+
+static inline const NNK_Tabella *tabella(void) {
+    return atomic_load_explicit(&attiva, memory_order_acquire);
+}
+
+int nnk_supportato(NNK_Percorso p) {
+    switch (p) {
+        case NNK_SCALARE:
+            return 1;
+#ifdef NNK_X86
+        case NNK_SSE2:
+            return __builtin_cpu_supports("sse2");
+        case NNK_AVX2:
+            return __builtin_cpu_supports("avx2") &&
+                   __builtin_cpu_supports("fma");
+#endif
+        default:
+            return 0;
+    }
+}
+
+int nnk_imposta_percorso(NNK_Percorso p) {
+    if (!nnk_supportato(p)) return -1;
+
+    const NNK_Tabella *t;
+    switch (p) {
+#ifdef NNK_X86
+        case NNK_SSE2: t = &tab_sse2; break;
+        case NNK_AVX2: t = &tab_avx2; break;
+#endif
+        default:       t = &tab_scalare; break;
+    }
+    atomic_store_explicit(&percorso, p, memory_order_relaxed);
+    atomic_store_explicit(&attiva, t, memory_order_release);
+    return 0;
+}
+
+static void nnk_seleziona(void) {
+#ifdef NNK_X86
+    __builtin_cpu_init();
+#endif
+
+    /* Dal percorso più ampio al riferimento scalare */
+    for (int p = NNK_N_PERCORSI - 1; p >= 0; p--)
+        if (nnk_imposta_percorso((NNK_Percorso)p) == 0)
+            break;
+}
+
+void nnk_inizializza(void) {
+    pthread_once(&una_volta, nnk_seleziona);
+}
+
+NNK_Percorso nnk_percorso_attivo(void) {
+    return (NNK_Percorso)atomic_load_explicit(&percorso, memory_order_relaxed);
+}
+
+const char *nnk_nome_percorso(NNK_Percorso p) {
+    switch (p) {
+        case NNK_SCALARE: return "scalare";
+        case NNK_SSE2:    return "sse2";
+        case NNK_AVX2:    return "avx2+fma";
+        default:          return "sconosciuto";
+    }
+}
+
+/* ============================================================
+ * INTERFACCIA PUBBLICA
+ * ============================================================ */
+
+double nnk_dot(int n, const double *x, const double *y) {
+    return tabella()->dot(n, x, y);
+}
+
+void nnk_axpy(int n, double a, const double *x, double *y) {
+    tabella()->axpy(n, a, x, y);
+}
+
+void nnk_axpby(int n, double a, const double *x, double b, double *y) {
+    tabella()->axpby(n, a, x, b, y);
+}
+
+/*
+ * Il prodotto esterno è una sequenza di axpby sulle righe
+ * di A: eredita così la vettorizzazione del percorso attivo.
+ */
+void nnk_ger(int m, int n, double a,
+             const double *x, const double *y,
+             double b, double *A, int lda) {
+    const NNK_Tabella *t = tabella();
+    for (int i = 0; i < m; i++)
+        t->axpby(n, a * x[i], y, b, &A[(long)i * lda]);
+}
+
+void nnk_axpby_retro(int n, double a, const double *x, double b,
+                     double *y, double c, double *g) {
+    tabella()->axpby_retro(n, a, x, b, y, c, g);
+}
+
+/*
+ * Come nnk_ger, riga per riga: ogni riga di A viene letta una
+ * volta sola, sia per il contributo a g sia per l'aggiornamento.
+ */
+void nnk_ger_retro(int m, int n, double a,
+                   const double *x, const double *y,
+                   double b, double *A, int lda, double *g) {
+    const NNK_Tabella *t = tabella();
+    for (int i = 0; i < m; i++)
+        t->axpby_retro(n, a * x[i], y, b, &A[(long)i * lda], x[i], g);
+}
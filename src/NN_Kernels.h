@@ -0,0 +1,101 @@
+#ifndef NN_KERNELS_H
+#define NN_KERNELS_H
+
+/* ============================================================
+ *              KERNEL DENSI DELLA RETE NEURALE
+ * ============================================================
+ *
+ * Operazioni di algebra lineare usate dagli strati
+ * Input → Hidden e Hidden → Output:
+ *
+ *   dot   : Σ x[i] * y[i]
+ *   axpy  : y = a·x + y
+ *   axpby : y = a·x + b·y
+ *   ger   : A = b·A + a·x·yᵀ   (aggiornamento a prodotto esterno)
+ *   retro : varianti di axpby e ger che, nella stessa passata,
+ *           accumulano Aᵀ·x con i valori precedenti di A
+ *
+ * Ogni kernel ha più implementazioni:
+ *  - scalare portabile (riferimento)
+ *  - SSE2
+ *  - AVX2 + FMA
+ *
+ * Il percorso migliore viene scelto a runtime in base alle
+ * caratteristiche della CPU. I percorsi vettoriali possono
+ * differire dallo scalare solo per l'ordine di accumulo e
+ * per l'arrotondamento della FMA.
+ */
+
+typedef enum {
+    NNK_SCALARE = 0,    // Implementazione portabile di riferimento
+    NNK_SSE2,           // Vettori a 128 bit (2 double)
+    NNK_AVX2,           // Vettori a 256 bit (4 double) con FMA
+    NNK_N_PERCORSI
+} NNK_Percorso;
+
+/*
+ * Seleziona il percorso più veloce supportato dalla CPU.
+ * Idempotente e sicura tra thread: la selezione avviene una
+ * volta sola.
+ */
+void nnk_inizializza(void);
+
+/*
+ * Forza un percorso specifico (verifiche e benchmark).
+ * Ritorna 0 se il percorso è supportato, -1 altrimenti.
+ */
+int nnk_imposta_percorso(NNK_Percorso p);
+
+/*
+ * Ritorna 1 se il percorso è disponibile su questa CPU
+ */
+int nnk_supportato(NNK_Percorso p);
+
+/*
+ * Percorso attualmente in uso e relativo nome leggibile
+ */
+NNK_Percorso nnk_percorso_attivo(void);
+const char *nnk_nome_percorso(NNK_Percorso p);
+
+/* ------------------------------------------------------------
+ * KERNEL
+ * ------------------------------------------------------------ */
+
+/* Prodotto scalare: Σ x[i] * y[i] */
+double nnk_dot(int n, const double *x, const double *y);
+
+/* y[i] += a * x[i] */
+void nnk_axpy(int n, double a, const double *x, double *y);
+
+/* y[i] = a * x[i] + b * y[i] */
+void nnk_axpby(int n, double a, const double *x, double b, double *y);
+
+/*
+ * Aggiornamento a prodotto esterno su una matrice m × n
+ * memorizzata per righe con passo lda:
+ *   A[i][j] = b * A[i][j] + a * x[i] * y[j]
+ */
+void nnk_ger(int m, int n, double a,
+             const double *x, const double *y,
+             double b, double *A, int lda);
+
+/*
+ * axpby che accumula in g il vettore prima dell'aggiornamento:
+ *   g[i] += c * y[i];   y[i] = a * x[i] + b * y[i]
+ */
+void nnk_axpby_retro(int n, double a, const double *x, double b,
+                     double *y, double c, double *g);
+
+/*
+ * ger fuso con la retropropagazione attraverso A: in una sola
+ * passata sulle righe
+ *   g[j]   += Σ_i x[i] * A[i][j]                (A precedente)
+ *   A[i][j] = b * A[i][j] + a * x[i] * y[j]
+ * Evita la lettura per colonne di Aᵀ·x e una seconda passata
+ * sulla matrice.
+ */
+void nnk_ger_retro(int m, int n, double a,
+                   const double *x, const double *y,
+                   double b, double *A, int lda, double *g);
+
+#endif
@@ -0,0 +1,167 @@
+#include <stdlib.h>
+#include <string.h>
+#include "NN_Online.h"
+
+/* ============================================================
+ * STRUTTURA
+ * ============================================================ */
+
+struct NN_Online {
+
+    NeuralNetwork *net;         // Modello in addestramento (solo scrittore)
+    NN_Snapshot *pub;           // Snapshot per l'inferenza
+
+    int batch;
+    int pubblica_ogni;
+
+    double *X;                  // Batch corrente [batch][num_inputs]
+    double *Y;                  // Target one-hot [batch][num_outputs]
+    int n_batch;
+
+    int da_pubblicare;          // Passi dall'ultima pubblicazione
+    long num_riga;              // Righe lette dal flusso
+
+    NNO_Statistiche stat;
+
+    char riga[1024];
+};
+
+/* ============================================================
+ * CREAZIONE E DEALLOCAZIONE
+ * ============================================================ */
+
+NN_Online *nno_crea(const NeuralNetwork *iniziale,
+                    int batch, int pubblica_ogni, int max_lettori) {
+    if (batch < 1 || pubblica_ogni < 1) return NULL;
+    if (iniziale->num_outputs != DATASET_N_CLASSI ||
+        iniziale->num_inputs != DATASET_N_FEATURE) return NULL;
+
+    NN_Online *o = (NN_Online*)calloc(1, sizeof(NN_Online));
+    if (!o) return NULL;
+
+    o->batch = batch;
+    o->pubblica_ogni = pubblica_ogni;
+    o->net = nn_clone(iniziale);
+    o->pub = nns_crea(iniziale, max_lettori);
+    o->X = (double*)malloc((size_t)batch * DATASET_N_FEATURE * sizeof(double));
+    o->Y = (double*)calloc((size_t)batch * DATASET_N_CLASSI, sizeof(double));
+
+    if (!o->net || !o->pub || !o->X || !o->Y) {
+        nno_free(o);
+        return NULL;
+    }
+    return o;
+}
+
+void nno_free(NN_Online *o) {
+    if (!o) return;
+    nns_free(o->pub);
+    nn_free(o->net);
+    free(o->X);
+    free(o->Y);
+    free(o);
+}
+
+/* ============================================================
+ * PUBBLICAZIONE
+ * ============================================================ */
+
+int nno_pubblica(NN_Online *o) {
+    if (nns_pubblica(o->pub, o->net) == 0) return -1;
+
+    o->da_pubblicare = 0;
+    o->stat.pubblicazioni++;
+    return 0;
+}
+
+NN_Snapshot *nno_snapshot(NN_Online *o) {
+    return o->pub;
+}
+
+unsigned long nno_versione(NN_Online *o) {
+    return nns_versione(o->pub);
+}
+
+void nno_statistiche(const NN_Online *o, NNO_Statistiche *st) {
+    *st = o->stat;
+}
+
+/* ============================================================
+ * AGGIORNAMENTO
+ * ============================================================ */
+
+int nno_aggiungi(NN_Online *o, const double raw[DATASET_N_FEATURE],
+                 int classe) {
+    if (classe < 0 || classe >= DATASET_N_CLASSI) return -1;
+
+    double *x = &o->X[(size_t)o->n_batch * DATASET_N_FEATURE];
+    double *y = &o->Y[(size_t)o->n_batch * DATASET_N_CLASSI];
+
+    norm_riga(raw, x);
+    for (int c = 0; c < DATASET_N_CLASSI; c++)
+        y[c] = (c == classe) ? 1.0 : 0.0;
+
+    o->stat.righe++;
+    if (++o->n_batch < o->batch) return 0;
+
+    /* ---------- Passo di training a costo costante ---------- */
+    o->n_batch = 0;
+    if (nn_train_batch(o->net, o->X, o->Y, o->batch) != 0) {
+        o->stat.falliti++;
+        return -2;
+    }
+    o->stat.aggiornamenti++;
+
+    /* Una pubblicazione fallita viene ritentata al passo
+     * successivo */
+    if (++o->da_pubblicare >= o->pubblica_ogni)
+        nno_pubblica(o);
+
+    return 1;
+}
+
+int nno_aggiungi_riga(NN_Online *o, const char *riga,
+                      int *colonna, const char **errore) {
+    double raw[DATASET_N_FEATURE];
+    int classe;
+
+    const int esito = dataset_analizza_riga(riga, raw, &classe,
+                                            colonna, errore);
+    if (esito <= 0) return esito;
+
+    nno_aggiungi(o, raw, classe);
+    return 1;
+}
+
+long nno_consuma(NN_Online *o, FILE *f, const char *nome, long max_righe) {
+    long lette = 0;
+
+    while ((max_righe <= 0 || lette < max_righe) &&
+           fgets(o->riga, sizeof(o->riga), f)) {
+        o->num_riga++;
+        lette++;
+
+        /* Riga più lunga del buffer: scartata per intero */
+        size_t len = strlen(o->riga);
+        if (len == sizeof(o->riga) - 1 && o->riga[len - 1] != '\n' &&
+            !feof(f)) {
+            int c;
+            while ((c = fgetc(f)) != EOF && c != '\n')
+                ;
+            fprintf(stderr, "%s:%ld:%d: riga troppo lunga\n",
+                    nome, o->num_riga, (int)sizeof(o->riga));
+            o->stat.scartate++;
+            continue;
+        }
+
+        int colonna;
+        const char *errore;
+        if (nno_aggiungi_riga(o, o->riga, &colonna, &errore) < 0) {
+            fprintf(stderr, "%s:%ld:%d: %s\n",
+                    nome, o->num_riga, colonna, errore);
+            o->stat.scartate++;
+        }
+    }
+
+    return lette;
+}
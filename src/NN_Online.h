@@ -0,0 +1,120 @@
+#ifndef NN_ONLINE_H
+#define NN_ONLINE_H
+
+#include <stdio.h>
+#include "NeuralNetwork.h"
+#include "Dataset.h"
+#include "NN_Snapshot.h"
+
+/* ============================================================
+ *          APPRENDIMENTO ONLINE DA FLUSSO DI SENSORI
+ * ============================================================
+ *
+ * Le righe arrivano una alla volta (file, pipe, stdin) nello
+ * stesso formato a 8 campi di dataset.csv. Ogni riga valida
+ * entra in un mini-batch di dimensione fissa; a batch pieno
+ * viene applicato un passo di nn_train_batch (nn_train se il
+ * batch è 1): il costo per riga è limitato e costante.
+ *
+ * Ogni 'pubblica_ogni' passi i parametri vengono pubblicati
+ * come nuovo snapshot (NN_Snapshot.h). L'inferenza usa sempre
+ * uno snapshot completo, mai il modello in addestramento.
+ *
+ * Batch e buffer di riga sono allocati alla creazione e le
+ * copie pubblicate sono al più max_lettori + 2: l'occupazione
+ * non cresce con la durata del flusso.
+ *
+ * Thread: un solo thread addestra (nno_aggiungi*,
+ * nno_consuma, nno_pubblica, nno_statistiche); fino a
+ * max_lettori thread leggono tramite nno_snapshot.
+ */
+
+typedef struct NN_Online NN_Online;
+
+typedef struct {
+    long righe;             // Righe valide consumate
+    long scartate;          // Righe malformate
+    long aggiornamenti;     // Passi di training applicati
+    long falliti;           // Batch scartati senza passo (memoria)
+    long pubblicazioni;     // Snapshot pubblicati
+} NNO_Statistiche;
+
+/*
+ * Crea il modo online a partire da una copia di 'iniziale',
+ * che viene pubblicata come versione 0.
+ *
+ * batch         : righe per passo di training (≥ 1)
+ * pubblica_ogni : passi tra due pubblicazioni (≥ 1)
+ * max_lettori   : thread lettori degli snapshot
+ *
+ * Ritorna NULL in caso di errore.
+ */
+NN_Online *nno_crea(
+    const NeuralNetwork *iniziale,
+    int batch,
+    int pubblica_ogni,
+    int max_lettori
+);
+
+void nno_free(NN_Online *o);
+
+/*
+ * Aggiunge un campione con feature grezze (non normalizzate).
+ * Ritorna 1 se è stato applicato un passo di training,
+ * 0 se il campione è in attesa nel batch, -1 se la classe
+ * non è valida, -2 se il passo di training non è riuscito
+ * (memoria insufficiente: il batch viene scartato e contato
+ * in 'falliti').
+ */
+int nno_aggiungi(
+    NN_Online *o,
+    const double raw[DATASET_N_FEATURE],
+    int classe
+);
+
+/*
+ * Aggiunge una riga testuale nel formato di dataset.csv.
+ * Stessi valori di ritorno di dataset_analizza_riga.
+ */
+int nno_aggiungi_riga(
+    NN_Online *o,
+    const char *riga,
+    int *colonna,
+    const char **errore
+);
+
+/*
+ * Legge fino a max_righe righe da f (tutte fino a EOF se
+ * max_righe ≤ 0) e le aggiunge. Le righe malformate sono
+ * segnalate su stderr come nome:riga:colonna.
+ *
+ * Ritorna il numero di righe lette, 0 a fine flusso.
+ */
+long nno_consuma(
+    NN_Online *o,
+    FILE *f,
+    const char *nome,
+    long max_righe
+);
+
+/*
+ * Pubblica subito i parametri correnti (le righe ancora nel
+ * batch non sono incluse). Ritorna 0 se ok, -1 se la memoria
+ * non è sufficiente.
+ */
+int nno_pubblica(NN_Online *o);
+
+/*
+ * Snapshot pubblicati: i lettori si registrano e fissano le
+ * versioni con nns_registra / nns_fissa / nns_rilascia
+ */
+NN_Snapshot *nno_snapshot(NN_Online *o);
+
+/*
+ * Numero di pubblicazioni effettuate (0 = modello iniziale)
+ */
+unsigned long nno_versione(NN_Online *o);
+
+void nno_statistiche(const NN_Online *o, NNO_Statistiche *st);
+
+#endif
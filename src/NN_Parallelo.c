@@ -0,0 +1,227 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "NN_Parallelo.h"
+#include "NN_Kernels.h"
+
+/* ============================================================
+ * STRUTTURA DEL POOL
+ * ============================================================ */
+
+typedef struct {
+    NN_Parallelo *pool;
+    int indice;             // Posizione del thread (0 = chiamante)
+    NN_Workspace *ws;       // Workspace privato
+    double *grad;           // Gradiente privato (layout dei parametri)
+    int esito;              // Di nn_calcola_gradiente, ultimo passo
+    pthread_t tid;
+} NNP_Lavoratore;
+
+struct NN_Parallelo {
+
+    int n_thread;
+    int n_avviati;          // Thread effettivamente avviati
+    int max_batch;
+    int num_parametri;
+
+    NNP_Lavoratore *lav;
+
+    /* Lavoro corrente, pubblicato sotto mutex */
+    const NeuralNetwork *net;
+    const double *X;
+    const double *Y;
+    int batch_size;
+
+    /* Sincronizzazione: ogni passo incrementa 'generazione' */
+    pthread_mutex_t mutex;
+    pthread_cond_t  avvio;
+    pthread_cond_t  fine;
+    unsigned long generazione;
+    int in_corso;           // Thread che non hanno ancora finito
+    int termina;
+};
+
+/* ============================================================
+ * CALCOLO DI UN BLOCCO
+ * ============================================================ */
+
+/*
+ * Blocco contiguo di campioni assegnato al thread k:
+ * [k·B/n, (k+1)·B/n). Dipende solo da B e n.
+ */
+static void nnp_calcola_blocco(NNP_Lavoratore *l) {
+    NN_Parallelo *p = l->pool;
+    const int B = p->batch_size;
+    const int n = p->n_thread;
+
+    const int inizio = (int)((long)l->indice * B / n);
+    const int fine   = (int)((long)(l->indice + 1) * B / n);
+
+    const int NI = p->net->num_inputs;
+    const int NO = p->net->num_outputs;
+
+    l->esito = nn_calcola_gradiente(p->net,
+                                    &p->X[(size_t)inizio * NI],
+                                    &p->Y[(size_t)inizio * NO],
+                                    fine - inizio, l->grad, l->ws);
+}
+
+static void *nnp_thread(void *arg) {
+    NNP_Lavoratore *l = (NNP_Lavoratore*)arg;
+    NN_Parallelo *p = l->pool;
+    unsigned long vista = 0;
+
+    for (;;) {
+        pthread_mutex_lock(&p->mutex);
+        while (!p->termina && p->generazione == vista)
+            pthread_cond_wait(&p->avvio, &p->mutex);
+        if (p->termina) {
+            pthread_mutex_unlock(&p->mutex);
+            return NULL;
+        }
+        vista = p->generazione;
+        pthread_mutex_unlock(&p->mutex);
+
+        nnp_calcola_blocco(l);
+
+        pthread_mutex_lock(&p->mutex);
+        if (--p->in_corso == 0)
+            pthread_cond_signal(&p->fine);
+        pthread_mutex_unlock(&p->mutex);
+    }
+}
+
+/* ============================================================
+ * CREAZIONE E DISTRUZIONE
+ * ============================================================ */
+
+NN_Parallelo *nnp_crea(const NeuralNetwork *net, int n_thread, int max_batch) {
+    if (n_thread < 1) n_thread = 1;
+    if (max_batch < 1) max_batch = 1;
+
+    NN_Parallelo *p = (NN_Parallelo*)calloc(1, sizeof(NN_Parallelo));
+    if (!p) return NULL;
+
+    p->n_thread      = n_thread;
+    p->max_batch     = max_batch;
+    p->num_parametri = net->num_parametri;
+
+    p->lav = (NNP_Lavoratore*)calloc(n_thread, sizeof(NNP_Lavoratore));
+    if (!p->lav) {
+        free(p);
+        return NULL;
+    }
+
+    pthread_mutex_init(&p->mutex, NULL);
+    pthread_cond_init(&p->avvio, NULL);
+    pthread_cond_init(&p->fine, NULL);
+
+    /* Ogni blocco ha al più ceil(max_batch / n_thread) campioni */
+    const int capacita = (max_batch + n_thread - 1) / n_thread;
+
+    for (int k = 0; k < n_thread; k++) {
+        NNP_Lavoratore *l = &p->lav[k];
+        l->pool   = p;
+        l->indice = k;
+        l->ws     = nn_workspace_create(net, capacita);
+        l->grad   = (double*)malloc(
+            (size_t)net->num_parametri * sizeof(double));
+
+        if (!l->ws || !l->grad) {
+            nnp_free(p);
+            return NULL;
+        }
+    }
+
+    /* Il thread 0 è il chiamante: si avviano solo gli altri */
+    for (int k = 1; k < n_thread; k++) {
+        if (pthread_create(&p->lav[k].tid, NULL, nnp_thread, &p->lav[k]) != 0) {
+            nnp_free(p);
+            return NULL;
+        }
+        p->n_avviati = k;
+    }
+
+    return p;
+}
+
+void nnp_free(NN_Parallelo *p) {
+    if (!p) return;
+
+    pthread_mutex_lock(&p->mutex);
+    p->termina = 1;
+    pthread_cond_broadcast(&p->avvio);
+    pthread_mutex_unlock(&p->mutex);
+
+    for (int k = 1; k <= p->n_avviati; k++)
+        pthread_join(p->lav[k].tid, NULL);
+
+    for (int k = 0; k < p->n_thread; k++) {
+        nn_workspace_free(p->lav[k].ws);
+        free(p->lav[k].grad);
+    }
+
+    pthread_mutex_destroy(&p->mutex);
+    pthread_cond_destroy(&p->avvio);
+    pthread_cond_destroy(&p->fine);
+
+    free(p->lav);
+    free(p);
+}
+
+int nnp_num_thread(const NN_Parallelo *p) {
+    return p->n_thread;
+}
+
+/* ============================================================
+ * PASSO DI TRAINING
+ * ============================================================ */
+
+int nnp_train_batch(NN_Parallelo *p, NeuralNetwork *net,
+                    const double *X, const double *Y,
+                    int batch_size) {
+
+    if (batch_size <= 0) return 0;
+    if (batch_size > p->max_batch ||
+        net->num_parametri != p->num_parametri)
+        return -1;
+
+    /* ---------- Pubblicazione del lavoro ---------- */
+    pthread_mutex_lock(&p->mutex);
+    p->net = net;
+    p->X = X;
+    p->Y = Y;
+    p->batch_size = batch_size;
+    p->in_corso = p->n_thread - 1;
+    p->generazione++;
+    pthread_cond_broadcast(&p->avvio);
+    pthread_mutex_unlock(&p->mutex);
+
+    /* Il chiamante elabora il blocco 0 */
+    nnp_calcola_blocco(&p->lav[0]);
+
+    pthread_mutex_lock(&p->mutex);
+    while (p->in_corso > 0)
+        pthread_cond_wait(&p->fine, &p->mutex);
+    pthread_mutex_unlock(&p->mutex);
+
+    /* Un blocco senza gradiente annulla il passo: nessun
+     * aggiornamento parziale */
+    for (int k = 0; k < p->n_thread; k++)
+        if (p->lav[k].esito != 0)
+            return -1;
+
+    /* ---------- Riduzione ad albero in ordine fisso ----------
+     * passo 1: g0+=g1, g2+=g3, ...   passo 2: g0+=g2, g4+=g6, ...
+     * L'ordine delle somme dipende solo dal numero di thread. */
+    const int n = p->n_thread;
+    for (int passo = 1; passo < n; passo *= 2)
+        for (int k = 0; k + passo < n; k += 2 * passo)
+            nnk_axpy(p->num_parametri, 1.0,
+                     p->lav[k + passo].grad, p->lav[k].grad);
+
+    nn_applica_gradiente(net, p->lav[0].grad, batch_size);
+    return 0;
+}
@@ -0,0 +1,65 @@
+#ifndef NN_PARALLELO_H
+#define NN_PARALLELO_H
+
+#include "NeuralNetwork.h"
+
+/* ============================================================
+ *        TRAINING DATA-PARALLELO SU PIÙ CORE
+ * ============================================================
+ *
+ * Ogni mini-batch viene suddiviso in blocchi contigui, uno
+ * per thread. Ciascun thread calcola il gradiente del proprio
+ * blocco in un buffer privato; i buffer vengono poi sommati
+ * secondo un albero binario dall'ordine fisso e applicati
+ * con un solo aggiornamento dei pesi.
+ *
+ * Poiché la suddivisione e l'ordine di riduzione dipendono
+ * solo dal numero di thread, il risultato è riproducibile bit
+ * per bit a parità di thread, dati e stato iniziale.
+ */
+
+typedef struct NN_Parallelo NN_Parallelo;
+
+/*
+ * Crea un pool di n_thread thread (il chiamante conta come
+ * thread 0) per reti con l'architettura di 'net'.
+ *
+ * max_batch : dimensione massima del mini-batch accettato
+ *
+ * Ritorna NULL in caso di errore.
+ */
+NN_Parallelo *nnp_crea(
+    const NeuralNetwork *net,
+    int n_thread,
+    int max_batch
+);
+
+/*
+ * Termina i thread e libera il pool
+ */
+void nnp_free(NN_Parallelo *pool);
+
+/*
+ * Numero di thread del pool
+ */
+int nnp_num_thread(const NN_Parallelo *pool);
+
+/*
+ * Un passo di training data-parallelo sul mini-batch.
+ *
+ * X : input,          [batch_size][num_inputs]
+ * Y : target one-hot, [batch_size][num_outputs]
+ *
+ * Ritorna 0 se ok, -1 se il batch supera max_batch o la
+ * rete ha un'architettura diversa da quella del pool (i
+ * pesi non vengono modificati).
+ */
+int nnp_train_batch(
+    NN_Parallelo *pool,
+    NeuralNetwork *net,
+    const double *X,
+    const double *Y,
+    int batch_size
+);
+
+#endif
@@ -0,0 +1,306 @@
+#include <stdlib.h>
+#include <math.h>
+#include "NN_Quantizzato.h"
+
+/* ============================================================
+ * LAYOUT IN UN UNICO BLOCCO
+ * ============================================================
+ *
+ * La struttura e tutti i suoi array vengono ricavati da una
+ * sola allocazione; ogni array parte da un offset allineato
+ * a 16 byte.
+ */
+
+#define NNQ_ALLINEA(x) (((x) + 15) & ~(size_t)15)
+
+/* Riserva 'byte' nel blocco e ritorna l'offset assegnato */
+static size_t riserva(size_t *offset, size_t byte) {
+    size_t inizio = NNQ_ALLINEA(*offset);
+    *offset = inizio + byte;
+    return inizio;
+}
+
+/* ============================================================
+ * FUNZIONI DI SUPPORTO
+ * ============================================================ */
+
+static inline float relu_f(float x) {
+    return x > 0.0f ? x : 0.0f;
+}
+
+/*
+ * Softmax in singola precisione (calcolata sul posto in z),
+ * con il risultato convertito in double per il chiamante.
+ */
+static void softmax_f(float *z, int n, double *p) {
+    float m = z[0];
+    for (int i = 1; i < n; i++)
+        if (z[i] > m) m = z[i];
+
+    float s = 0.0f;
+    for (int i = 0; i < n; i++) {
+        z[i] = expf(z[i] - m);
+        s += z[i];
+    }
+
+    if (s <= 0.0f) {
+        for (int i = 0; i < n; i++)
+            p[i] = 1.0 / (double)n;
+        return;
+    }
+
+    for (int i = 0; i < n; i++)
+        p[i] = (double)(z[i] / s);
+}
+
+/* ============================================================
+ * SINGOLA PRECISIONE
+ * ============================================================ */
+
+NN_Float *nn_esporta_float(const NeuralNetwork *net) {
+    const int NI = net->num_inputs;
+    const int NH = net->num_hidden;
+    const int NO = net->num_outputs;
+
+    size_t off = sizeof(NN_Float);
+    size_t o_w1 = riserva(&off, (size_t)NH * NI * sizeof(float));
+    size_t o_w2 = riserva(&off, (size_t)NO * NH * sizeof(float));
+    size_t o_b1 = riserva(&off, (size_t)NH * sizeof(float));
+    size_t o_b2 = riserva(&off, (size_t)NO * sizeof(float));
+
+    char *blocco = (char*)malloc(off);
+    if (!blocco) return NULL;
+
+    NN_Float *m = (NN_Float*)blocco;
+    m->num_inputs  = NI;
+    m->num_hidden  = NH;
+    m->num_outputs = NO;
+    m->weights_input_hidden  = (float*)(blocco + o_w1);
+    m->weights_hidden_output = (float*)(blocco + o_w2);
+    m->bias_hidden           = (float*)(blocco + o_b1);
+    m->bias_output           = (float*)(blocco + o_b2);
+
+    for (int k = 0; k < NH * NI; k++)
+        m->weights_input_hidden[k] = (float)net->weights_input_hidden[k];
+    for (int k = 0; k < NO * NH; k++)
+        m->weights_hidden_output[k] = (float)net->weights_hidden_output[k];
+    for (int h = 0; h < NH; h++)
+        m->bias_hidden[h] = (float)net->bias_hidden[h];
+    for (int o = 0; o < NO; o++)
+        m->bias_output[o] = (float)net->bias_output[o];
+
+    return m;
+}
+
+void nn_float_free(NN_Float *m) {
+    free(m);
+}
+
+void nn_forward_float(const NN_Float *m,
+                      const double *input,
+                      double *P_out,
+                      float *scratch) {
+
+    const int NI = m->num_inputs;
+    const int NH = m->num_hidden;
+    const int NO = m->num_outputs;
+
+    float *hid = scratch;
+    float *out = scratch + NH;
+
+    /* ---------- Input → Hidden ---------- */
+    for (int h = 0; h < NH; h++) {
+        const float *w = &m->weights_input_hidden[h * NI];
+        float sum = m->bias_hidden[h];
+        for (int i = 0; i < NI; i++)
+            sum += (float)input[i] * w[i];
+        hid[h] = relu_f(sum);
+    }
+
+    /* ---------- Hidden → Output (logits) ---------- */
+    for (int o = 0; o < NO; o++) {
+        const float *w = &m->weights_hidden_output[o * NH];
+        float sum = m->bias_output[o];
+        for (int h = 0; h < NH; h++)
+            sum += hid[h] * w[h];
+        out[o] = sum;
+    }
+
+    softmax_f(out, NO, P_out);
+}
+
+/* ============================================================
+ * INT8 SIMMETRICO
+ * ============================================================ */
+
+/*
+ * Quantizza una riga di pesi: q = round(w / s), s = max|w| / 127.
+ * Una riga tutta nulla usa scala 1 (tutti i q a zero).
+ */
+static float quantizza_riga(const double *w, int n, int8_t *q) {
+    double max_abs = 0.0;
+    for (int i = 0; i < n; i++)
+        if (fabs(w[i]) > max_abs) max_abs = fabs(w[i]);
+
+    double s = (max_abs > 0.0) ? max_abs / 127.0 : 1.0;
+
+    for (int i = 0; i < n; i++) {
+        long v = lround(w[i] / s);
+        if (v > 127)  v = 127;
+        if (v < -127) v = -127;
+        q[i] = (int8_t)v;
+    }
+
+    return (float)s;
+}
+
+NN_Int8 *nn_esporta_int8(const NeuralNetwork *net) {
+    const int NI = net->num_inputs;
+    const int NH = net->num_hidden;
+    const int NO = net->num_outputs;
+
+    size_t off = sizeof(NN_Int8);
+    size_t o_s1 = riserva(&off, (size_t)NH * sizeof(float));
+    size_t o_s2 = riserva(&off, (size_t)NO * sizeof(float));
+    size_t o_b1 = riserva(&off, (size_t)NH * sizeof(float));
+    size_t o_b2 = riserva(&off, (size_t)NO * sizeof(float));
+    size_t o_w1 = riserva(&off, (size_t)NH * NI);
+    size_t o_w2 = riserva(&off, (size_t)NO * NH);
+
+    char *blocco = (char*)malloc(off);
+    if (!blocco) return NULL;
+
+    NN_Int8 *m = (NN_Int8*)blocco;
+    m->num_inputs  = NI;
+    m->num_hidden  = NH;
+    m->num_outputs = NO;
+    m->scale_input_hidden    = (float*)(blocco + o_s1);
+    m->scale_hidden_output   = (float*)(blocco + o_s2);
+    m->bias_hidden           = (float*)(blocco + o_b1);
+    m->bias_output           = (float*)(blocco + o_b2);
+    m->weights_input_hidden  = (int8_t*)(blocco + o_w1);
+    m->weights_hidden_output = (int8_t*)(blocco + o_w2);
+
+    for (int h = 0; h < NH; h++)
+        m->scale_input_hidden[h] = quantizza_riga(
+            &net->weights_input_hidden[h * NI], NI,
+            &m->weights_input_hidden[h * NI]);
+
+    for (int o = 0; o < NO; o++)
+        m->scale_hidden_output[o] = quantizza_riga(
+            &net->weights_hidden_output[o * NH], NH,
+            &m->weights_hidden_output[o * NH]);
+
+    for (int h = 0; h < NH; h++)
+        m->bias_hidden[h] = (float)net->bias_hidden[h];
+    for (int o = 0; o < NO; o++)
+        m->bias_output[o] = (float)net->bias_output[o];
+
+    return m;
+}
+
+void nn_int8_free(NN_Int8 *m) {
+    free(m);
+}
+
+/*
+ * I pesi restano interi durante l'accumulo; la scala della
+ * riga viene applicata una sola volta alla somma finale.
+ */
+void nn_forward_int8(const NN_Int8 *m,
+                     const double *input,
+                     double *P_out,
+                     float *scratch) {
+
+    const int NI = m->num_inputs;
+    const int NH = m->num_hidden;
+    const int NO = m->num_outputs;
+
+    float *hid = scratch;
+    float *out = scratch + NH;
+
+    /* ---------- Input → Hidden ---------- */
+    for (int h = 0; h < NH; h++) {
+        const int8_t *q = &m->weights_input_hidden[h * NI];
+        float acc = 0.0f;
+        for (int i = 0; i < NI; i++)
+            acc += (float)input[i] * (float)q[i];
+        hid[h] = relu_f(acc * m->scale_input_hidden[h] + m->bias_hidden[h]);
+    }
+
+    /* ---------- Hidden → Output (logits) ---------- */
+    for (int o = 0; o < NO; o++) {
+        const int8_t *q = &m->weights_hidden_output[o * NH];
+        float acc = 0.0f;
+        for (int h = 0; h < NH; h++)
+            acc += hid[h] * (float)q[h];
+        out[o] = acc * m->scale_hidden_output[o] + m->bias_output[o];
+    }
+
+    softmax_f(out, NO, P_out);
+}
+
+/* ============================================================
+ * DERIVA RISPETTO AL MODELLO DOUBLE
+ * ============================================================ */
+
+int nn_deriva_quantizzazione(const NeuralNetwork *net,
+                             const NN_Float *mf,
+                             const NN_Int8 *mq,
+                             const double *X, int n,
+                             double *deriva_float,
+                             double *deriva_int8) {
+
+    const int NI = net->num_inputs;
+    const int NO = net->num_outputs;
+
+    NN_Workspace *ws = nn_workspace_create(net, 1);
+    double *p_rif = (double*)malloc((size_t)NO * sizeof(double));
+    double *p_q   = (double*)malloc((size_t)NO * sizeof(double));
+    float *scratch = (float*)malloc(
+        NNQ_SCRATCH(net->num_hidden, NO) * sizeof(float));
+
+    if (!ws || !p_rif || !p_q || !scratch) {
+        nn_workspace_free(ws);
+        free(p_rif);
+        free(p_q);
+        free(scratch);
+        return -1;
+    }
+
+    double df = 0.0, dq = 0.0;
+    int esito = 0;
+
+    for (int r = 0; r < n; r++) {
+        const double *x = &X[(size_t)r * NI];
+        if (nn_forward_batch(net, x, 1, p_rif, ws) != 0) {
+            esito = -1;
+            break;
+        }
+
+        if (mf) {
+            nn_forward_float(mf, x, p_q, scratch);
+            for (int o = 0; o < NO; o++)
+                if (fabs(p_q[o] - p_rif[o]) > df)
+                    df = fabs(p_q[o] - p_rif[o]);
+        }
+
+        if (mq) {
+            nn_forward_int8(mq, x, p_q, scratch);
+            for (int o = 0; o < NO; o++)
+                if (fabs(p_q[o] - p_rif[o]) > dq)
+                    dq = fabs(p_q[o] - p_rif[o]);
+        }
+    }
+
+    if (esito == 0) {
+        if (deriva_float) *deriva_float = df;
+        if (deriva_int8)  *deriva_int8  = dq;
+    }
+
+    nn_workspace_free(ws);
+    free(p_rif);
+    free(p_q);
+    free(scratch);
+    return esito;
+}
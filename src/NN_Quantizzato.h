@@ -0,0 +1,126 @@
+#ifndef NN_QUANTIZZATO_H
+#define NN_QUANTIZZATO_H
+
+#include <stdint.h>
+#include "NeuralNetwork.h"
+
+/* ============================================================
+ *        COPIE CONGELATE PER L'INFERENZA A BASSA PRECISIONE
+ * ============================================================
+ *
+ * Una rete addestrata in double può essere esportata in una
+ * copia di sola inferenza, più compatta:
+ *
+ *  - NN_Float : pesi e attivazioni in singola precisione
+ *  - NN_Int8  : pesi int8 simmetrici con una scala per riga,
+ *               bias e attivazioni in float
+ *
+ * Ogni copia occupa un unico blocco di memoria contiguo ed
+ * è immutabile: più thread possono usarla contemporaneamente,
+ * ciascuno con il proprio buffer di appoggio.
+ */
+
+typedef struct {
+
+    int num_inputs;
+    int num_hidden;
+    int num_outputs;
+
+    float *weights_input_hidden;    // [num_hidden][num_inputs]
+    float *weights_hidden_output;   // [num_outputs][num_hidden]
+    float *bias_hidden;             // [num_hidden]
+    float *bias_output;             // [num_outputs]
+
+} NN_Float;
+
+typedef struct {
+
+    int num_inputs;
+    int num_hidden;
+    int num_outputs;
+
+    int8_t *weights_input_hidden;   // [num_hidden][num_inputs]
+    float  *scale_input_hidden;     // [num_hidden]  w ≈ q * scala
+    int8_t *weights_hidden_output;  // [num_outputs][num_hidden]
+    float  *scale_hidden_output;    // [num_outputs]
+    float  *bias_hidden;            // [num_hidden]
+    float  *bias_output;            // [num_outputs]
+
+} NN_Int8;
+
+/*
+ * Dimensione (in float) del buffer di appoggio richiesto
+ * dalle funzioni di forward a bassa precisione
+ */
+#define NNQ_SCRATCH(num_hidden, num_outputs) ((num_hidden) + (num_outputs))
+
+/* ------------------------------------------------------------
+ * SINGOLA PRECISIONE
+ * ------------------------------------------------------------ */
+
+/*
+ * Esporta una copia float della rete (NULL se manca memoria)
+ */
+NN_Float *nn_esporta_float(const NeuralNetwork *net);
+
+void nn_float_free(NN_Float *m);
+
+/*
+ * Forward in singola precisione.
+ *
+ * input   : feature normalizzate, [num_inputs]
+ * P_out   : probabilità in uscita, [num_outputs]
+ * scratch : almeno NNQ_SCRATCH(num_hidden, num_outputs) float
+ */
+void nn_forward_float(
+    const NN_Float *m,
+    const double *input,
+    double *P_out,
+    float *scratch
+);
+
+/* ------------------------------------------------------------
+ * INT8 SIMMETRICO CON SCALA PER RIGA
+ * ------------------------------------------------------------ */
+
+/*
+ * Esporta una copia int8 della rete (NULL se manca memoria).
+ * Ogni riga di pesi usa la scala max|w| / 127.
+ */
+NN_Int8 *nn_esporta_int8(const NeuralNetwork *net);
+
+void nn_int8_free(NN_Int8 *m);
+
+/*
+ * Forward con pesi int8 (stessa convenzione di nn_forward_float)
+ */
+void nn_forward_int8(
+    const NN_Int8 *m,
+    const double *input,
+    double *P_out,
+    float *scratch
+);
+
+/* ------------------------------------------------------------
+ * DERIVA RISPETTO AL MODELLO DOUBLE
+ * ------------------------------------------------------------ */
+
+/*
+ * Massima differenza assoluta di probabilità tra la rete
+ * double e le copie a bassa precisione sugli n campioni X
+ * ([n][num_inputs], già normalizzati).
+ *
+ * Le copie possono essere NULL: la relativa deriva non
+ * viene calcolata. Ritorna 0 se ok, -1 se manca memoria.
+ */
+int nn_deriva_quantizzazione(
+    const NeuralNetwork *net,
+    const NN_Float *mf,
+    const NN_Int8 *mq,
+    const double *X,
+    int n,
+    double *deriva_float,
+    double *deriva_int8
+);
+
+#endif
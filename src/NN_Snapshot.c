@@ -0,0 +1,226 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "NN_Snapshot.h"
+
+/* ============================================================
+ * STRUTTURA
+ * ============================================================
+ *
+ * Lettore:   c = corrente; hazard[l] = c; se corrente ≠ c
+ *            riprova (la copia potrebbe essere già ritirata)
+ * Scrittore: vecchia = scambia(corrente, nuova); la ritira;
+ *            le ritirate non annunciate in nessuno slot
+ *            tornano libere per le pubblicazioni successive
+ *
+ * Con ordinamento sequenziale, se il lettore supera la
+ * verifica il suo annuncio precede lo scambio, quindi la
+ * scansione dello scrittore lo vede e non riusa la copia.
+ */
+
+typedef struct NNS_Copia {
+    NeuralNetwork *net;
+    unsigned long versione;
+    struct NNS_Copia *succ;     // Lista delle libere o delle ritirate
+} NNS_Copia;
+
+typedef struct {
+    _Alignas(64) _Atomic(NNS_Copia *) hazard;
+    atomic_int occupato;
+} NNS_Slot;
+
+struct NN_Snapshot {
+
+    _Atomic(NNS_Copia *) corrente;
+    atomic_ulong versione;
+
+    int max_lettori;
+    NNS_Slot *slot;                 // [max_lettori], una linea ciascuno
+
+    /* Solo scrittori, sotto mutex */
+    pthread_mutex_t scrittori;
+    NNS_Copia *libere;
+    NNS_Copia *ritirate;
+    atomic_int n_copie;
+};
+
+/* ============================================================
+ * COPIE
+ * ============================================================ */
+
+static NNS_Copia *nns_nuova_copia(const NeuralNetwork *modello) {
+    NNS_Copia *c = (NNS_Copia*)calloc(1, sizeof(NNS_Copia));
+    if (!c) return NULL;
+
+    c->net = nn_clone(modello);
+    if (!c->net) {
+        free(c);
+        return NULL;
+    }
+    return c;
+}
+
+static void nns_libera_lista(NNS_Copia *c) {
+    while (c) {
+        NNS_Copia *succ = c->succ;
+        nn_free(c->net);
+        free(c);
+        c = succ;
+    }
+}
+
+static int nns_annunciata(const NN_Snapshot *s, const NNS_Copia *c) {
+    for (int l = 0; l < s->max_lettori; l++)
+        if (atomic_load(&s->slot[l].hazard) == c)
+            return 1;
+    return 0;
+}
+
+/* Sposta tra le libere le ritirate che nessun lettore usa */
+static void nns_recupera(NN_Snapshot *s) {
+    NNS_Copia **p = &s->ritirate;
+    while (*p) {
+        NNS_Copia *c = *p;
+        if (nns_annunciata(s, c)) {
+            p = &c->succ;
+        } else {
+            *p = c->succ;
+            c->succ = s->libere;
+            s->libere = c;
+        }
+    }
+}
+
+/* ============================================================
+ * CREAZIONE E DEALLOCAZIONE
+ * ============================================================ */
+
+NN_Snapshot *nns_crea(const NeuralNetwork *iniziale, int max_lettori) {
+    if (max_lettori < 1) return NULL;
+
+    NN_Snapshot *s = (NN_Snapshot*)calloc(1, sizeof(NN_Snapshot));
+    if (!s) return NULL;
+
+    s->max_lettori = max_lettori;
+    s->slot = (NNS_Slot*)aligned_alloc(
+        _Alignof(NNS_Slot), (size_t)max_lettori * sizeof(NNS_Slot));
+    NNS_Copia *prima = nns_nuova_copia(iniziale);
+
+    if (!s->slot || !prima || pthread_mutex_init(&s->scrittori, NULL) != 0) {
+        nns_libera_lista(prima);
+        free(s->slot);
+        free(s);
+        return NULL;
+    }
+
+    for (int l = 0; l < max_lettori; l++) {
+        atomic_init(&s->slot[l].hazard, NULL);
+        atomic_init(&s->slot[l].occupato, 0);
+    }
+
+    atomic_init(&s->corrente, prima);
+    atomic_init(&s->versione, 0);
+    atomic_init(&s->n_copie, 1);
+    return s;
+}
+
+void nns_free(NN_Snapshot *s) {
+    if (!s) return;
+    nns_libera_lista(atomic_load(&s->corrente));
+    nns_libera_lista(s->libere);
+    nns_libera_lista(s->ritirate);
+    pthread_mutex_destroy(&s->scrittori);
+    free(s->slot);
+    free(s);
+}
+
+/* ============================================================
+ * SCRITTORI
+ * ============================================================ */
+
+unsigned long nns_pubblica(NN_Snapshot *s, const NeuralNetwork *src) {
+    pthread_mutex_lock(&s->scrittori);
+
+    NNS_Copia *c = s->libere;
+    if (c) {
+        s->libere = c->succ;
+    } else {
+        c = nns_nuova_copia(src);
+        if (!c) {
+            pthread_mutex_unlock(&s->scrittori);
+            return 0;
+        }
+        atomic_fetch_add(&s->n_copie, 1);
+    }
+
+    if (nn_copia_parametri(c->net, src) != 0) {
+        c->succ = s->libere;
+        s->libere = c;
+        pthread_mutex_unlock(&s->scrittori);
+        return 0;
+    }
+
+    /* La copia è completa prima dello scambio: chi la trova
+     * come corrente vede tutti i parametri */
+    const unsigned long versione = atomic_load(&s->versione) + 1;
+    c->versione = versione;
+    c->succ = NULL;
+
+    NNS_Copia *vecchia = atomic_exchange(&s->corrente, c);
+    atomic_store(&s->versione, versione);
+
+    vecchia->succ = s->ritirate;
+    s->ritirate = vecchia;
+    nns_recupera(s);
+
+    /* Dopo lo sblocco 'c' può essere già ritirata e riusata */
+    pthread_mutex_unlock(&s->scrittori);
+    return versione;
+}
+
+/* ============================================================
+ * LETTORI
+ * ============================================================ */
+
+int nns_registra(NN_Snapshot *s) {
+    for (int l = 0; l < s->max_lettori; l++) {
+        int libero = 0;
+        if (atomic_compare_exchange_strong(&s->slot[l].occupato, &libero, 1))
+            return l;
+    }
+    return -1;
+}
+
+void nns_deregistra(NN_Snapshot *s, int lettore) {
+    atomic_store(&s->slot[lettore].hazard, NULL);
+    atomic_store(&s->slot[lettore].occupato, 0);
+}
+
+const NeuralNetwork *nns_fissa(NN_Snapshot *s, int lettore,
+                               unsigned long *versione) {
+    _Atomic(NNS_Copia *) *hazard = &s->slot[lettore].hazard;
+    NNS_Copia *c;
+
+    do {
+        c = atomic_load(&s->corrente);
+        atomic_store(hazard, c);
+    } while (atomic_load(&s->corrente) != c);
+
+    if (versione) *versione = c->versione;
+    return c->net;
+}
+
+void nns_rilascia(NN_Snapshot *s, int lettore) {
+    atomic_store_explicit(&s->slot[lettore].hazard, NULL,
+                          memory_order_release);
+}
+
+unsigned long nns_versione(const NN_Snapshot *s) {
+    return atomic_load(&((NN_Snapshot*)s)->versione);
+}
+
+int nns_copie(const NN_Snapshot *s) {
+    return atomic_load(&((NN_Snapshot*)s)->n_copie);
+}
@@ -0,0 +1,95 @@
+#ifndef NN_SNAPSHOT_H
+#define NN_SNAPSHOT_H
+
+#include "NeuralNetwork.h"
+
+/* ============================================================
+ *      PUBBLICAZIONE DI SNAPSHOT DEL MODELLO SENZA LOCK
+ * ============================================================
+ *
+ * Chi addestra prepara una copia completa dei parametri e la
+ * rende visibile con un solo scambio atomico del puntatore
+ * corrente; chi esegue l'inferenza fissa la versione corrente
+ * senza lock e senza mai attendere gli scrittori.
+ *
+ * Recupero delle copie con hazard pointer: ogni lettore
+ * registrato ha uno slot (su una propria linea di cache) in
+ * cui annuncia la copia che sta usando. Una copia sostituita
+ * viene riusata per una pubblicazione successiva solo quando
+ * nessuno slot la annuncia.
+ *
+ * Le copie esistenti sono al più max_lettori + 2: la memoria
+ * è limitata anche con pubblicazioni continue.
+ *
+ * Gli scrittori si serializzano tra loro con un mutex che i
+ * lettori non toccano mai.
+ */
+
+typedef struct NN_Snapshot NN_Snapshot;
+
+/*
+ * Crea il pubblicatore con una copia di 'iniziale' come
+ * versione 0.
+ *
+ * max_lettori : thread lettori registrabili insieme
+ *
+ * Ritorna NULL in caso di errore.
+ */
+NN_Snapshot *nns_crea(
+    const NeuralNetwork *iniziale,
+    int max_lettori
+);
+
+/*
+ * Libera tutte le copie. Nessun lettore deve avere uno
+ * snapshot fissato.
+ */
+void nns_free(NN_Snapshot *s);
+
+/*
+ * Scrittori: copia i parametri di 'src' e li pubblica.
+ * Ritorna la nuova versione, 0 se 'src' ha un'architettura
+ * diversa o la memoria non è sufficiente.
+ */
+unsigned long nns_pubblica(
+    NN_Snapshot *s,
+    const NeuralNetwork *src
+);
+
+/*
+ * Registra il thread chiamante come lettore.
+ * Ritorna l'indice dello slot, -1 se sono tutti occupati.
+ */
+int nns_registra(NN_Snapshot *s);
+
+void nns_deregistra(NN_Snapshot *s, int lettore);
+
+/*
+ * Fissa lo snapshot corrente: resta valido e immutato fino a
+ * nns_rilascia dello stesso lettore. Al più uno snapshot
+ * fissato per lettore.
+ *
+ * versione : se non NULL, riceve la versione fissata
+ *
+ * Lo snapshot va usato in sola lettura (es. nn_forward_batch
+ * con un workspace del lettore).
+ */
+const NeuralNetwork *nns_fissa(
+    NN_Snapshot *s,
+    int lettore,
+    unsigned long *versione
+);
+
+void nns_rilascia(NN_Snapshot *s, int lettore);
+
+/*
+ * Versione pubblicata più recente
+ */
+unsigned long nns_versione(const NN_Snapshot *s);
+
+/*
+ * Copie del modello allocate finora (limite di memoria)
+ */
+int nns_copie(const NN_Snapshot *s);
+
+#endif
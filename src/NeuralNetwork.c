@@ -1,8 +1,18 @@
+#define _POSIX_C_SOURCE 200809L
+
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
 #include <math.h>
 #include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include "NeuralNetwork.h"
+#include "NN_Kernels.h"
+#include "Metriche.h"
 
 /* ============================================================
  * FUNZIONI DI ATTIVAZIONE
@@ -71,13 +81,112 @@ void softmax(double *x, int n) {
 
 /*
  * Genera un peso casuale con distribuzione uniforme
- * nell’intervallo [-0.5, 0.5].
+ * nell’intervallo [-0.5, 0.5), dal generatore del modello.
  *
  * L’inizializzazione casuale rompe la simmetria iniziale
  * e consente un apprendimento efficace.
  */
-double rand_weight(void) {
-    return ((double)rand() / (double)RAND_MAX) - 0.5;
+static double rand_weight(Rng *rng) {
+    return rng_uniforme(rng) - 0.5;
+}
+
+/* ============================================================
+ * LAYOUT DELL'ARENA
+ * ============================================================
+ *
+ * Tutti i parametri risiedono in un unico blocco allineato
+ * a 64 byte, con ogni segmento che parte su una linea di cache:
+ *
+ *   parametri = [ W1 | W2 | b1 | b2 ]
+ *                \_______/
+ *                 num_pesi: prefisso soggetto a L2
+ *
+ * Il padding tra i segmenti vale sempre zero. Gli accumulatori
+ * dei gradienti usano lo stesso layout, così un aggiornamento
+ * si riduce a due kernel sull'intero blocco.
+ */
+
+#define NN_ALLINEA_BYTE     64
+#define NN_ALLINEA_DOUBLE   (NN_ALLINEA_BYTE / (int)sizeof(double))
+
+/* Arrotonda n (in double) al multiplo di una linea di cache */
+static size_t nn_allinea(size_t n) {
+    return (n + NN_ALLINEA_DOUBLE - 1) & ~(size_t)(NN_ALLINEA_DOUBLE - 1);
+}
+
+/* Offset (in double) dei segmenti del blocco parametri */
+typedef struct {
+    size_t w1, w2, b1, b2;
+    size_t totale;
+} NN_Layout;
+
+static NN_Layout nn_layout(int inputs, int hidden, int outputs) {
+    NN_Layout l;
+    l.w1 = 0;
+    l.w2 = nn_allinea(l.w1 + (size_t)hidden * inputs);
+    l.b1 = nn_allinea(l.w2 + (size_t)outputs * hidden);
+    l.b2 = nn_allinea(l.b1 + (size_t)hidden);
+    l.totale = l.b2 + (size_t)outputs;
+    return l;
+}
+
+/*
+ * Fa puntare pesi e bias nel blocco parametri 'base'
+ */
+static void nn_collega_parametri(NeuralNetwork *net, double *base) {
+    NN_Layout l = nn_layout(net->num_inputs, net->num_hidden,
+                            net->num_outputs);
+
+    net->parametri             = base;
+    net->weights_input_hidden  = base + l.w1;
+    net->weights_hidden_output = base + l.w2;
+    net->bias_hidden           = base + l.b1;
+    net->bias_output           = base + l.b2;
+}
+
+/*
+ * Allocazione allineata a 64 byte e azzerata
+ */
+static void *nn_alloca_allineato(size_t n_double) {
+    size_t byte = nn_allinea(n_double) * sizeof(double);
+    if (byte == 0) byte = NN_ALLINEA_BYTE;
+
+    void *p = aligned_alloc(NN_ALLINEA_BYTE, byte);
+    if (p) memset(p, 0, byte);
+    return p;
+}
+
+/* ============================================================
+ * WORKSPACE PER IL TRAINING A MINI-BATCH
+ * ============================================================ */
+
+/*
+ * Garantisce che i buffer di batch possano contenere almeno
+ * 'batch_size' campioni. I buffer crescono solo quando serve:
+ * a regime il training non esegue alcuna allocazione.
+ *
+ * I quattro buffer sono ricavati da un unico blocco allineato.
+ */
+static int nn_riserva_batch(NeuralNetwork *net, int batch_size) {
+    if (batch_size <= net->batch_capacity) return 0;
+
+    const size_t B  = (size_t)batch_size;
+    const size_t in  = nn_allinea((size_t)net->num_inputs * B);
+    const size_t hid = nn_allinea((size_t)net->num_hidden * B);
+    const size_t out = nn_allinea((size_t)net->num_outputs * B);
+
+    double *blocco = (double*)nn_alloca_allineato(in + 2 * hid + out);
+    if (!blocco) return -1;
+
+    free(net->batch_arena);
+    net->batch_arena       = blocco;
+    net->batch_input       = blocco;
+    net->batch_hidden      = blocco + in;
+    net->batch_hidden_grad = blocco + in + hid;
+    net->batch_output      = blocco + in + 2 * hid;
+
+    net->batch_capacity = batch_size;
+    return 0;
 }
 
 /* ============================================================
@@ -85,21 +194,24 @@ double rand_weight(void) {
  * ============================================================ */
 
 /*
- * Alloca e inizializza una rete neurale feed-forward
- * con:
- *  - uno strato nascosto,
- *  - funzione di attivazione ReLU,
- *  - softmax in uscita.
+ * Alloca la struttura della rete e l'arena che contiene
+ * parametri, gradienti e attivazioni:
  *
- * La rete è progettata per operare come classificatore
- * probabilistico supervisionato.
+ *   arena = [ parametri | gradienti | hidden | output | cache ]
+ *
+ * Con con_parametri = 0 il blocco dei parametri non viene
+ * allocato: il chiamante lo collegherà a una zona già
+ * esistente (es. un checkpoint mappato in memoria).
  */
-NeuralNetwork *nn_create(int inputs, int hidden, int outputs,
-                         double lr, double l2) {
+static NeuralNetwork *nn_alloca(int inputs, int hidden, int outputs,
+                                double lr, double l2, int con_parametri) {
 
     NeuralNetwork *net = (NeuralNetwork*)calloc(1, sizeof(NeuralNetwork));
     if (!net) return NULL;
 
+    /* Selezione dei kernel vettoriali supportati dalla CPU */
+    nnk_inizializza();
+
     /* Parametri strutturali */
     net->num_inputs  = inputs;
     net->num_hidden  = hidden;
@@ -109,36 +221,79 @@ NeuralNetwork *nn_create(int inputs, int hidden, int outputs,
     net->learning_rate = lr;
     net->l2 = l2;
 
-    /* Vettori di attivazione e cache */
-    net->hidden = (double*)calloc(hidden, sizeof(double));
-    net->output = (double*)calloc(outputs, sizeof(double));
-    net->hidden_input_cache = (double*)calloc(hidden, sizeof(double));
+    /* Generatore del modello (nn_create lo reinizializza
+     * con il seme richiesto) */
+    rng_inizializza(&net->rng, NN_SEME_PREDEFINITO);
 
-    /* Matrici dei pesi */
-    net->weights_input_hidden =
-        (double*)malloc(inputs * hidden * sizeof(double));
+    /* Dimensioni dell'arena */
+    NN_Layout l = nn_layout(inputs, hidden, outputs);
+    net->num_parametri = (int)l.totale;
+    net->num_pesi      = (int)l.b1;
 
-    net->weights_hidden_output =
-        (double*)malloc(hidden * outputs * sizeof(double));
+    const size_t par = nn_allinea(l.totale);
+    const size_t hid = nn_allinea((size_t)hidden);
+    const size_t out = nn_allinea((size_t)outputs);
 
-    /* Bias */
-    net->bias_hidden = (double*)calloc(hidden, sizeof(double));
-    net->bias_output = (double*)calloc(outputs, sizeof(double));
+    double *arena = (double*)nn_alloca_allineato(
+        (con_parametri ? par : 0) + par + 2 * hid + out);
+    if (!arena) {
+        free(net);
+        return NULL;
+    }
+    net->arena = arena;
 
-    /* Verifica allocazioni */
-    if (!net->hidden || !net->output || !net->hidden_input_cache ||
-        !net->weights_input_hidden || !net->weights_hidden_output ||
-        !net->bias_hidden || !net->bias_output) {
+    /* Parametri */
+    if (con_parametri) {
+        nn_collega_parametri(net, arena);
+        arena += par;
+    }
+
+    /* Accumulatori dei gradienti (stesso layout dei parametri) */
+    net->gradienti          = arena;
+    net->grad_input_hidden  = arena + l.w1;
+    net->grad_hidden_output = arena + l.w2;
+    net->grad_bias_hidden   = arena + l.b1;
+    net->grad_bias_output   = arena + l.b2;
+    arena += par;
+
+    /* Vettori di attivazione e cache */
+    net->hidden             = arena;
+    net->hidden_input_cache = arena + hid;
+    net->output             = arena + 2 * hid;
+
+    /* Buffer di batch per il training per singolo campione */
+    if (nn_riserva_batch(net, 1) != 0) {
         nn_free(net);
         return NULL;
     }
 
+    return net;
+}
+
+/*
+ * Alloca e inizializza una rete neurale feed-forward
+ * con:
+ *  - uno strato nascosto,
+ *  - funzione di attivazione ReLU,
+ *  - softmax in uscita.
+ *
+ * La rete è progettata per operare come classificatore
+ * probabilistico supervisionato.
+ */
+NeuralNetwork *nn_create(int inputs, int hidden, int outputs,
+                         double lr, double l2, uint64_t seme) {
+
+    NeuralNetwork *net = nn_alloca(inputs, hidden, outputs, lr, l2, 1);
+    if (!net) return NULL;
+
+    rng_inizializza(&net->rng, seme);
+
     /* Inizializzazione casuale dei pesi */
     for (int i = 0; i < inputs * hidden; i++)
-        net->weights_input_hidden[i] = rand_weight();
+        net->weights_input_hidden[i] = rand_weight(&net->rng);
 
     for (int i = 0; i < hidden * outputs; i++)
-        net->weights_hidden_output[i] = rand_weight();
+        net->weights_hidden_output[i] = rand_weight(&net->rng);
 
     /* Bias inizializzati a zero (scelta standard) */
 
@@ -155,16 +310,77 @@ NeuralNetwork *nn_create(int inputs, int hidden, int outputs,
 void nn_free(NeuralNetwork *net) {
     if (!net) return;
 
-    free(net->hidden);
-    free(net->output);
-    free(net->hidden_input_cache);
-    free(net->weights_input_hidden);
-    free(net->weights_hidden_output);
-    free(net->bias_hidden);
-    free(net->bias_output);
+    /* Parametri mappati da un checkpoint */
+    if (net->mappa)
+        munmap(net->mappa, net->mappa_dim);
+
+    free(net->arena);
+    free(net->batch_arena);
     free(net);
 }
 
+/* ============================================================
+ * GENERATORE DEL MODELLO
+ * ============================================================ */
+
+void nn_imposta_seme(NeuralNetwork *net, uint64_t seme) {
+    rng_inizializza(&net->rng, seme);
+}
+
+void nn_mescola(NeuralNetwork *net, int *ordine, int n) {
+    rng_mescola(&net->rng, ordine, n);
+}
+
+/* ============================================================
+ * COPIA E MEDIA DEI PARAMETRI
+ * ============================================================ */
+
+/*
+ * Verifica che due reti abbiano la stessa architettura
+ */
+static int nn_compatibili(const NeuralNetwork *a, const NeuralNetwork *b) {
+    return a->num_inputs == b->num_inputs &&
+           a->num_hidden == b->num_hidden &&
+           a->num_outputs == b->num_outputs;
+}
+
+int nn_copia_parametri(NeuralNetwork *dst, const NeuralNetwork *src) {
+    if (!nn_compatibili(dst, src)) return -1;
+
+    memcpy(dst->parametri, src->parametri,
+           (size_t)src->num_parametri * sizeof(double));
+    return 0;
+}
+
+NeuralNetwork *nn_clone(const NeuralNetwork *src) {
+    NeuralNetwork *net = nn_alloca(src->num_inputs, src->num_hidden,
+                                   src->num_outputs, src->learning_rate,
+                                   src->l2, 1);
+    if (!net) return NULL;
+
+    /* Il clone prosegue la stessa sequenza casuale */
+    net->rng = src->rng;
+    nn_copia_parametri(net, src);
+    return net;
+}
+
+int nn_media_parametri(NeuralNetwork *dst,
+                       const NeuralNetwork *const *src, int n) {
+    if (n <= 0) return -1;
+    for (int k = 0; k < n; k++)
+        if (!nn_compatibili(dst, src[k])) return -1;
+
+    /* Accumulo in ordine fisso per un risultato riproducibile */
+    const double peso = 1.0 / (double)n;
+    const int len = dst->num_parametri;
+
+    nnk_axpby(len, peso, src[0]->parametri, 0.0, dst->parametri);
+    for (int k = 1; k < n; k++)
+        nnk_axpy(len, peso, src[k]->parametri, dst->parametri);
+
+    return 0;
+}
+
 /* ============================================================
  * FORWARD PASS (INFERENZA)
  * ============================================================ */
@@ -178,13 +394,15 @@ void nn_free(NeuralNetwork *net) {
  */
 void nn_forward(NeuralNetwork *net, const double *input) {
 
+    MET_CONTA(NN_FORWARD, 1);
+    MET_CONTA(NN_FORWARD_CAMPIONI, 1);
+
     /* ---------- Input → Hidden ---------- */
     for (int h = 0; h < net->num_hidden; h++) {
-        double sum = net->bias_hidden[h];
         int base = h * net->num_inputs;
-
-        for (int i = 0; i < net->num_inputs; i++)
-            sum += input[i] * net->weights_input_hidden[base + i];
+        double sum = net->bias_hidden[h] +
+            nnk_dot(net->num_inputs, input,
+                    &net->weights_input_hidden[base]);
 
         /* Salvataggio per backpropagation */
         net->hidden_input_cache[h] = sum;
@@ -195,92 +413,658 @@ void nn_forward(NeuralNetwork *net, const double *input) {
 
     /* ---------- Hidden → Output (logits) ---------- */
     for (int o = 0; o < net->num_outputs; o++) {
-        double sum = net->bias_output[o];
         int base = o * net->num_hidden;
-
-        for (int h = 0; h < net->num_hidden; h++)
-            sum += net->hidden[h] * net->weights_hidden_output[base + h];
-
-        net->output[o] = sum;
+        net->output[o] = net->bias_output[o] +
+            nnk_dot(net->num_hidden, net->hidden,
+                    &net->weights_hidden_output[base]);
     }
 
     /* ---------- Normalizzazione Softmax ---------- */
     softmax(net->output, net->num_outputs);
 }
 
+/* ============================================================
+ * FORWARD PASS A BATCH
+ * ============================================================ */
+
+/*
+ * Nucleo comune a inferenza e training a batch:
+ *   XT = Xᵀ
+ *   H  = ReLU(W1 · XT + b1)
+ *   P  = W2 · H + b2          (logit, softmax esclusa)
+ *
+ * I prodotti sono organizzati come prodotti matrice-matrice
+ * sul layout trasposto [neurone][campione]: il ciclo più
+ * interno è un axpy sui campioni, in memoria contigua e
+ * senza riduzioni, eseguito dai kernel vettoriali.
+ */
+static void nn_forward_blocco(const NeuralNetwork *net,
+                              const double *X, int B,
+                              double *XT, double *H, double *P) {
+
+    const int NI = net->num_inputs;
+    const int NH = net->num_hidden;
+    const int NO = net->num_outputs;
+
+    /* ---------- Trasposizione dell'input ---------- */
+    for (int b = 0; b < B; b++)
+        for (int i = 0; i < NI; i++)
+            XT[i * B + b] = X[b * NI + i];
+
+    /* ---------- Input → Hidden: H = ReLU(W1 · Xᵀ + b1) ---------- */
+    for (int h = 0; h < NH; h++) {
+        double *hr = &H[h * B];
+        const double *w = &net->weights_input_hidden[h * NI];
+
+        for (int b = 0; b < B; b++)
+            hr[b] = net->bias_hidden[h];
+
+        for (int i = 0; i < NI; i++)
+            nnk_axpy(B, w[i], &XT[i * B], hr);
+
+        for (int b = 0; b < B; b++)
+            hr[b] = relu(hr[b]);
+    }
+
+    /* ---------- Hidden → Output: P = W2 · H + b2 ---------- */
+    for (int o = 0; o < NO; o++) {
+        double *pr = &P[o * B];
+        const double *w = &net->weights_hidden_output[o * NH];
+
+        for (int b = 0; b < B; b++)
+            pr[b] = net->bias_output[o];
+
+        for (int h = 0; h < NH; h++)
+            nnk_axpy(B, w[h], &H[h * B], pr);
+    }
+}
+
+/*
+ * Alloca un workspace dimensionato sulla rete.
+ */
+NN_Workspace *nn_workspace_create(const NeuralNetwork *net, int capacity) {
+    if (capacity <= 0) capacity = 1;
+
+    NN_Workspace *ws = (NN_Workspace*)calloc(1, sizeof(NN_Workspace));
+    if (!ws) return NULL;
+
+    ws->num_inputs  = net->num_inputs;
+    ws->num_hidden  = net->num_hidden;
+    ws->num_outputs = net->num_outputs;
+    ws->capacity    = capacity;
+
+    ws->input  = (double*)malloc(
+        (size_t)net->num_inputs * capacity * sizeof(double));
+    ws->hidden = (double*)malloc(
+        (size_t)net->num_hidden * capacity * sizeof(double));
+    ws->output = (double*)malloc(
+        (size_t)net->num_outputs * capacity * sizeof(double));
+    ws->hidden_grad = (double*)malloc(
+        (size_t)net->num_hidden * capacity * sizeof(double));
+    ws->riga = (double*)malloc(
+        (size_t)net->num_outputs * sizeof(double));
+
+    if (!ws->input || !ws->hidden || !ws->output ||
+        !ws->hidden_grad || !ws->riga) {
+        nn_workspace_free(ws);
+        return NULL;
+    }
+
+    return ws;
+}
+
+void nn_workspace_free(NN_Workspace *ws) {
+    if (!ws) return;
+
+    free(ws->input);
+    free(ws->hidden);
+    free(ws->output);
+    free(ws->hidden_grad);
+    free(ws->riga);
+    free(ws);
+}
+
+/*
+ * Inferenza a batch: elabora gli n campioni in blocchi da
+ * ws->capacity, senza modificare la rete.
+ */
+int nn_forward_batch(const NeuralNetwork *net,
+                     const double *X, int n,
+                     double *P_out,
+                     NN_Workspace *ws) {
+
+    const int NI = net->num_inputs;
+    const int NO = net->num_outputs;
+
+    /* Workspace dimensionato per una rete diversa */
+    if (ws->num_inputs != NI || ws->num_hidden != net->num_hidden ||
+        ws->num_outputs != NO)
+        return -1;
+
+    MET_INIZIO(t0);
+    MET_CONTA(NN_FORWARD, 1);
+    MET_CONTA(NN_FORWARD_CAMPIONI, n);
+
+    for (int start = 0; start < n; start += ws->capacity) {
+        int B = n - start;
+        if (B > ws->capacity) B = ws->capacity;
+
+        nn_forward_blocco(net, &X[(size_t)start * NI], B,
+                          ws->input, ws->hidden, ws->output);
+
+        /* Softmax per campione, direttamente nel buffer di uscita */
+        for (int b = 0; b < B; b++) {
+            double *p = &P_out[(size_t)(start + b) * NO];
+            for (int o = 0; o < NO; o++)
+                p[o] = ws->output[o * B + b];
+            softmax(p, NO);
+        }
+    }
+
+    MET_FINE(NN_FORWARD, t0);
+    return 0;
+}
+
 /* ============================================================
  * BACKPROPAGATION E AGGIORNAMENTO DEI PESI
  * ============================================================ */
 
+/*
+ * Forward e backward su un blocco di B campioni, fino al
+ * gradiente sullo strato nascosto:
+ *   P = softmax(logit) - Y        (dL/dz, [NO][B])
+ *   G = (W2ᵀ · P) ⊙ ReLU'(H)      (dL/dh, [NH][B])
+ *
+ * z è un buffer di appoggio di num_outputs elementi.
+ * La rete è acceduta in sola lettura.
+ */
+static void nn_backward_blocco(const NeuralNetwork *net,
+                               const double *X, const double *Y, int B,
+                               double *XT, double *H, double *G,
+                               double *P, double *z) {
+
+    const int NH = net->num_hidden;
+    const int NO = net->num_outputs;
+
+    /* ---------- Forward sul batch ---------- */
+    nn_forward_blocco(net, X, B, XT, H, P);
+
+    /* ---------- Softmax e gradiente sull'output ---------- */
+    /* dL/dz = y_pred - y_true */
+    for (int b = 0; b < B; b++) {
+        for (int o = 0; o < NO; o++)
+            z[o] = P[o * B + b];
+
+        softmax(z, NO);
+
+        for (int o = 0; o < NO; o++)
+            P[o * B + b] = z[o] - Y[b * NO + o];
+    }
+
+    /* ---------- Gradiente sullo strato nascosto ---------- */
+    /* dH = (W2ᵀ · dZ) ⊙ ReLU'(z_hidden)
+     * ReLU'(z) > 0 esattamente quando ReLU(z) > 0, per cui
+     * la derivata si ricava dalle attivazioni già salvate.
+     * Va calcolato con W2 non ancora aggiornata. */
+    for (int h = 0; h < NH; h++) {
+        const double *hr = &H[h * B];
+        double *gr = &G[h * B];
+
+        for (int b = 0; b < B; b++)
+            gr[b] = 0.0;
+
+        for (int o = 0; o < NO; o++)
+            nnk_axpy(B, net->weights_hidden_output[o * NH + h],
+                     &P[o * B], gr);
+
+        for (int b = 0; b < B; b++)
+            gr[b] *= relu_derivative(hr[b]);
+    }
+}
+
+/*
+ * Somma nel blocco 'grad' (layout dei parametri) il gradiente
+ * dei pesi calcolato da nn_backward_blocco:
+ *   dW2 += dZ · Hᵀ     dW1 += dH · X
+ */
+static void nn_accumula_gradiente(const NeuralNetwork *net, int B,
+                                  const double *XT, const double *H,
+                                  const double *G, const double *P,
+                                  double *grad) {
+
+    const int NI = net->num_inputs;
+    const int NH = net->num_hidden;
+    const int NO = net->num_outputs;
+
+    NN_Layout l = nn_layout(NI, NH, NO);
+    double *g_w1 = grad + l.w1;
+    double *g_w2 = grad + l.w2;
+    double *g_b1 = grad + l.b1;
+    double *g_b2 = grad + l.b2;
+
+    /* ---------- Gradiente Hidden → Output ---------- */
+    for (int o = 0; o < NO; o++) {
+        const double *pr = &P[o * B];
+        double gb = 0.0;
+
+        for (int b = 0; b < B; b++)
+            gb += pr[b];
+        g_b2[o] += gb;
+
+        for (int h = 0; h < NH; h++)
+            g_w2[o * NH + h] += nnk_dot(B, pr, &H[h * B]);
+    }
+
+    /* ---------- Gradiente Input → Hidden ---------- */
+    for (int h = 0; h < NH; h++) {
+        const double *gr = &G[h * B];
+        double gb = 0.0;
+
+        for (int b = 0; b < B; b++)
+            gb += gr[b];
+        g_b1[h] += gb;
+
+        for (int i = 0; i < NI; i++)
+            g_w1[h * NI + i] += nnk_dot(B, gr, &XT[i * B]);
+    }
+}
+
+/*
+ * Gradiente della loss sommato sugli n campioni, elaborati
+ * in blocchi da ws->capacity. Rientrante: la rete è letta
+ * soltanto e tutto lo stato intermedio è nel workspace.
+ */
+int nn_calcola_gradiente(const NeuralNetwork *net,
+                         const double *X, const double *Y, int n,
+                         double *grad, NN_Workspace *ws) {
+
+    const int NI = net->num_inputs;
+    const int NO = net->num_outputs;
+
+    if (ws->num_inputs != NI || ws->num_hidden != net->num_hidden ||
+        ws->num_outputs != NO)
+        return -1;
+
+    memset(grad, 0, (size_t)net->num_parametri * sizeof(double));
+
+    for (int start = 0; start < n; start += ws->capacity) {
+        int B = n - start;
+        if (B > ws->capacity) B = ws->capacity;
+
+        nn_backward_blocco(net, &X[(size_t)start * NI],
+                           &Y[(size_t)start * NO], B,
+                           ws->input, ws->hidden, ws->hidden_grad,
+                           ws->output, ws->riga);
+        nn_accumula_gradiente(net, B, ws->input, ws->hidden,
+                              ws->hidden_grad, ws->output, grad);
+    }
+
+    return 0;
+}
+
+/*
+ * Discesa del gradiente con regolarizzazione L2, usando il
+ * gradiente medio: w ← (1 - η·λ)·w - (η / n)·Σg
+ *
+ * Gradienti e parametri condividono il layout dell'arena:
+ * un kernel per tutti i pesi (con L2), uno per i bias.
+ */
+void nn_applica_gradiente(NeuralNetwork *net,
+                          const double *grad,
+                          int batch_size) {
+
+    if (batch_size <= 0) return;
+
+    MET_CONTA(NN_CAMPIONI, batch_size);
+    MET_CONTA(NN_AGGIORNAMENTI, 1);
+
+    const double lr = net->learning_rate;
+    const double l2 = net->l2;
+    const double decay = (l2 > 0.0) ? 1.0 - lr * l2 : 1.0;
+    const double passo = -lr / (double)batch_size;
+    const int np = net->num_pesi;
+
+    nnk_axpby(np, passo, grad, decay, net->parametri);
+    nnk_axpy(net->num_parametri - np, passo,
+             grad + np, net->parametri + np);
+}
+
+/*
+ * Passo di SGD su un singolo campione, con una passata di
+ * lettura e una di aggiornamento per matrice:
+ *
+ *   W1: prodotti scalari per righe (forward), poi ger
+ *   W2: prodotti scalari per righe (forward), poi un'unica
+ *       passata che accumula dH = W2ᵀ·dZ con i pesi vecchi
+ *       e li aggiorna (nnk_ger_retro)
+ *
+ * Il percorso a batch legge W2 tre volte (forward, W2ᵀ per
+ * colonne, ger). Il risultato coincide a meno dell'ordine
+ * delle somme.
+ */
+static void nn_train_campione(NeuralNetwork *net,
+                              const double *x, const double *y) {
+
+    const int NI = net->num_inputs;
+    const int NH = net->num_hidden;
+    const int NO = net->num_outputs;
+
+    double *H = net->batch_hidden;        // [NH]
+    double *G = net->batch_hidden_grad;   // [NH]
+    double *z = net->output;              // [NO]
+
+    const double lr = net->learning_rate;
+    const double decay = (net->l2 > 0.0) ? 1.0 - lr * net->l2 : 1.0;
+
+    /* ---------- Forward ---------- */
+    for (int h = 0; h < NH; h++)
+        H[h] = relu(net->bias_hidden[h] +
+                    nnk_dot(NI, x, &net->weights_input_hidden[h * NI]));
+
+    for (int o = 0; o < NO; o++)
+        z[o] = net->bias_output[o] +
+               nnk_dot(NH, H, &net->weights_hidden_output[o * NH]);
+
+    /* dL/dz = y_pred - y_true */
+    softmax(z, NO);
+    for (int o = 0; o < NO; o++)
+        z[o] -= y[o];
+
+    /* ---------- Hidden → Output: dH e aggiornamento fusi ---------- */
+    memset(G, 0, (size_t)NH * sizeof(double));
+    nnk_ger_retro(NO, NH, -lr, z, H, decay,
+                  net->weights_hidden_output, NH, G);
+    nnk_axpy(NO, -lr, z, net->bias_output);
+
+    /* ---------- Input → Hidden ---------- */
+    for (int h = 0; h < NH; h++)
+        G[h] *= relu_derivative(H[h]);
+
+    nnk_ger(NH, NI, -lr, G, x, decay, net->weights_input_hidden, NI);
+    nnk_axpy(NH, -lr, G, net->bias_hidden);
+}
+
 /*
  * Addestramento supervisionato della rete tramite:
  *  - Softmax + Cross-Entropy Loss
- *  - Discesa del gradiente
+ *  - Discesa del gradiente a mini-batch
  *  - Regolarizzazione L2
+ *
+ * Il forward condivide il nucleo dell'inferenza a batch.
+ * Con batch_size = 1 il passo è fuso (nn_train_campione) e
+ * applicato direttamente ai pesi, senza passare dagli
+ * accumulatori.
+ */
+int nn_train_batch(NeuralNetwork *net,
+                   const double *X,
+                   const double *Y,
+                   int batch_size) {
+
+    if (batch_size <= 0) return 0;
+    if (nn_riserva_batch(net, batch_size) != 0) return -1;
+
+    MET_INIZIO(t0);
+
+    /* ---------- Singolo campione: passo fuso ---------- */
+    if (batch_size == 1) {
+        nn_train_campione(net, X, Y);
+
+        MET_CONTA(NN_CAMPIONI, 1);
+        MET_CONTA(NN_AGGIORNAMENTI, 1);
+        MET_FINE(NN_TRAIN, t0);
+        return 0;
+    }
+
+    const int B  = batch_size;
+
+    double *XT = net->batch_input;        // [NI][B]
+    double *H  = net->batch_hidden;       // [NH][B]
+    double *G  = net->batch_hidden_grad;  // [NH][B]
+    double *P  = net->batch_output;       // [NO][B]
+
+    /* net->output funge da buffer per la softmax del campione */
+    nn_backward_blocco(net, X, Y, B, XT, H, G, P, net->output);
+
+    /* ---------- Gradiente medio e aggiornamento ---------- */
+    memset(net->gradienti, 0, (size_t)net->num_parametri * sizeof(double));
+    nn_accumula_gradiente(net, B, XT, H, G, P, net->gradienti);
+    nn_applica_gradiente(net, net->gradienti, B);
+
+    MET_FINE(NN_TRAIN, t0);
+    return 0;
+}
+
+/*
+ * Addestramento su un singolo campione (SGD puro):
+ * caso particolare del training a mini-batch.
  */
 void nn_train(NeuralNetwork *net,
               const double *input,
               const double *target) {
+    nn_train_batch(net, input, target, 1);
+}
 
-    /* Forward pass */
-    nn_forward(net, input);
+/* ============================================================
+ * CHECKPOINT BINARIO
+ * ============================================================
+ *
+ * Layout del file (byte order nativo, verificato in lettura):
+ *
+ *   [0, 128)   header NN_Checkpoint_Header
+ *   [128, ...) blocco parametri [ W1 | W2 | b1 | b2 ]
+ *
+ * Il blocco parametri è la copia esatta di quello dell'arena
+ * (stessi segmenti allineati a 64 byte): si scrive con una
+ * sola fwrite e, in caricamento, la rete può puntare
+ * direttamente dentro la mappatura del file.
+ */
 
-    /* ---------- Gradiente sull’output ---------- */
-    /* dL/dz = y_pred - y_true */
-    double *output_grad =
-        (double*)malloc(net->num_outputs * sizeof(double));
+#define NN_CKPT_MAGIC        0x4B434E4Eu   // "NNCK"
+#define NN_CKPT_VERSIONE     1u
+#define NN_CKPT_ORDINE_BYTE  0x01020304u
+#define NN_CKPT_DIM_HEADER   128
 
-    if (!output_grad) return;
+typedef struct {
+    uint32_t magic;
+    uint32_t versione;
+    uint32_t ordine_byte;
+    uint32_t dim_header;
 
-    for (int o = 0; o < net->num_outputs; o++)
-        output_grad[o] = net->output[o] - target[o];
+    int32_t num_inputs;
+    int32_t num_hidden;
+    int32_t num_outputs;
+    int32_t riservato;
 
-    /* ---------- Gradiente sullo strato nascosto ---------- */
-    double *hidden_grad =
-        (double*)calloc(net->num_hidden, sizeof(double));
+    double learning_rate;
+    double l2;
 
-    if (!hidden_grad) {
-        free(output_grad);
-        return;
+    uint64_t off_weights_input_hidden;
+    uint64_t off_weights_hidden_output;
+    uint64_t off_bias_hidden;
+    uint64_t off_bias_output;
+
+    uint64_t dim_file;
+} NN_Checkpoint_Header;
+
+_Static_assert(sizeof(NN_Checkpoint_Header) <= NN_CKPT_DIM_HEADER,
+               "header del checkpoint troppo grande");
+_Static_assert(NN_CKPT_DIM_HEADER % NN_ALLINEA_BYTE == 0,
+               "il blocco parametri deve restare allineato");
+
+/*
+ * Calcola gli offset (in byte) degli array: sono quelli
+ * del layout dell'arena, traslati dopo l'header.
+ */
+static void ckpt_layout(NN_Checkpoint_Header *h) {
+    NN_Layout l = nn_layout(h->num_inputs, h->num_hidden, h->num_outputs);
+    const uint64_t base = NN_CKPT_DIM_HEADER;
+
+    h->off_weights_input_hidden  = base + l.w1 * sizeof(double);
+    h->off_weights_hidden_output = base + l.w2 * sizeof(double);
+    h->off_bias_hidden           = base + l.b1 * sizeof(double);
+    h->off_bias_output           = base + l.b2 * sizeof(double);
+    h->dim_file                  = base + l.totale * sizeof(double);
+}
+
+/*
+ * Verifica coerenza dell'header con la dimensione reale del file
+ */
+static int ckpt_valida(const NN_Checkpoint_Header *h, uint64_t dim_file) {
+    if (h->magic != NN_CKPT_MAGIC ||
+        h->versione != NN_CKPT_VERSIONE ||
+        h->ordine_byte != NN_CKPT_ORDINE_BYTE ||
+        h->dim_header != NN_CKPT_DIM_HEADER)
+        return -1;
+
+    if (h->num_inputs <= 0 || h->num_hidden <= 0 || h->num_outputs <= 0)
+        return -1;
+
+    NN_Checkpoint_Header atteso = *h;
+    ckpt_layout(&atteso);
+
+    if (atteso.off_weights_input_hidden != h->off_weights_input_hidden ||
+        atteso.off_weights_hidden_output != h->off_weights_hidden_output ||
+        atteso.off_bias_hidden != h->off_bias_hidden ||
+        atteso.off_bias_output != h->off_bias_output ||
+        atteso.dim_file != h->dim_file ||
+        h->dim_file > dim_file)
+        return -1;
+
+    return 0;
+}
+
+int nn_save(const NeuralNetwork *net, const char *path) {
+    NN_Checkpoint_Header h;
+    memset(&h, 0, sizeof(h));
+
+    h.magic       = NN_CKPT_MAGIC;
+    h.versione    = NN_CKPT_VERSIONE;
+    h.ordine_byte = NN_CKPT_ORDINE_BYTE;
+    h.dim_header  = NN_CKPT_DIM_HEADER;
+    h.num_inputs  = net->num_inputs;
+    h.num_hidden  = net->num_hidden;
+    h.num_outputs = net->num_outputs;
+    h.learning_rate = net->learning_rate;
+    h.l2 = net->l2;
+    ckpt_layout(&h);
+
+    /* Scrittura su file temporaneo e rename atomico:
+     * un lettore concorrente vede il vecchio o il nuovo
+     * checkpoint, mai uno parziale */
+    size_t len = strlen(path);
+    char *tmp = (char*)malloc(len + 5);
+    if (!tmp) return -1;
+    memcpy(tmp, path, len);
+    memcpy(tmp + len, ".tmp", 5);
+
+    FILE *f = fopen(tmp, "wb");
+    if (!f) {
+        free(tmp);
+        return -1;
     }
 
-    for (int h = 0; h < net->num_hidden; h++) {
-        double sum = 0.0;
-        for (int o = 0; o < net->num_outputs; o++)
-            sum += output_grad[o] *
-                   net->weights_hidden_output[o * net->num_hidden + h];
+    char blocco_header[NN_CKPT_DIM_HEADER] = {0};
+    memcpy(blocco_header, &h, sizeof(h));
+
+    const size_t n = (size_t)net->num_parametri;
+    int esito =
+        (fwrite(blocco_header, 1, sizeof(blocco_header), f) ==
+            sizeof(blocco_header) &&
+         fwrite(net->parametri, sizeof(double), n, f) == n) ? 0 : -1;
 
-        hidden_grad[h] =
-            sum * relu_derivative(net->hidden_input_cache[h]);
+    if (fclose(f) != 0) esito = -1;
+    if (esito == 0 && rename(tmp, path) != 0) esito = -1;
+    if (esito != 0) remove(tmp);
+
+    free(tmp);
+    return esito;
+}
+
+/*
+ * Caricamento con copia: il blocco parametri viene letto
+ * nell'arena della rete con una sola fread.
+ */
+static NeuralNetwork *nn_load_copia(const char *path) {
+    FILE *f = fopen(path, "rb");
+    if (!f) return NULL;
+
+    NN_Checkpoint_Header h;
+    struct stat st;
+
+    if (fread(&h, sizeof(h), 1, f) != 1 ||
+        fstat(fileno(f), &st) != 0 ||
+        ckpt_valida(&h, (uint64_t)st.st_size) != 0) {
+        fclose(f);
+        return NULL;
     }
 
-    const double lr = net->learning_rate;
-    const double l2 = net->l2;
+    NeuralNetwork *net = nn_alloca(h.num_inputs, h.num_hidden,
+                                   h.num_outputs, h.learning_rate,
+                                   h.l2, 1);
+    if (!net) {
+        fclose(f);
+        return NULL;
+    }
 
-    /* ---------- Aggiornamento Hidden → Output ---------- */
-    for (int o = 0; o < net->num_outputs; o++) {
-        for (int h = 0; h < net->num_hidden; h++) {
-            int idx = o * net->num_hidden + h;
-            double grad_w = output_grad[o] * net->hidden[h];
-            if (l2 > 0.0)
-                grad_w += l2 * net->weights_hidden_output[idx];
-            net->weights_hidden_output[idx] -= lr * grad_w;
-        }
-        net->bias_output[o] -= lr * output_grad[o];
+    const size_t n = (size_t)net->num_parametri;
+    if (fseek(f, NN_CKPT_DIM_HEADER, SEEK_SET) != 0 ||
+        fread(net->parametri, sizeof(double), n, f) != n) {
+        nn_free(net);
+        fclose(f);
+        return NULL;
     }
 
-    /* ---------- Aggiornamento Input → Hidden ---------- */
-    for (int h = 0; h < net->num_hidden; h++) {
-        for (int i = 0; i < net->num_inputs; i++) {
-            int idx = h * net->num_inputs + i;
-            double grad_w = hidden_grad[h] * input[i];
-            if (l2 > 0.0)
-                grad_w += l2 * net->weights_input_hidden[idx];
-            net->weights_input_hidden[idx] -= lr * grad_w;
-        }
-        net->bias_hidden[h] -= lr * hidden_grad[h];
+    fclose(f);
+    return net;
+}
+
+/*
+ * Caricamento senza copia: il file viene mappato in
+ * memoria e il blocco parametri punta nella mappatura.
+ *
+ * La mappatura è privata (copy-on-write): le pagine restano
+ * condivise tra i processi che caricano lo stesso modello
+ * finché nessuno le modifica, e un eventuale training
+ * successivo non altera il file su disco.
+ */
+static NeuralNetwork *nn_load_mmap(const char *path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return NULL;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (uint64_t)st.st_size < NN_CKPT_DIM_HEADER) {
+        close(fd);
+        return NULL;
+    }
+
+    size_t dim = (size_t)st.st_size;
+    void *mappa = mmap(NULL, dim, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mappa == MAP_FAILED) return NULL;
+
+    const NN_Checkpoint_Header *h = (const NN_Checkpoint_Header*)mappa;
+    if (ckpt_valida(h, (uint64_t)dim) != 0) {
+        munmap(mappa, dim);
+        return NULL;
+    }
+
+    NeuralNetwork *net = nn_alloca(h->num_inputs, h->num_hidden,
+                                   h->num_outputs, h->learning_rate,
+                                   h->l2, 0);
+    if (!net) {
+        munmap(mappa, dim);
+        return NULL;
     }
 
-    free(output_grad);
-    free(hidden_grad);
+    net->mappa     = mappa;
+    net->mappa_dim = dim;
+    nn_collega_parametri(net,
+        (double*)((char*)mappa + NN_CKPT_DIM_HEADER));
+
+    return net;
+}
+
+NeuralNetwork *nn_load(const char *path, int usa_mmap) {
+    return usa_mmap ? nn_load_mmap(path) : nn_load_copia(path);
 }
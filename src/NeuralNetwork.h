@@ -1,6 +1,10 @@
 #ifndef NEURAL_NETWORK_H
 #define NEURAL_NETWORK_H
 
+#include <stddef.h>
+#include <stdint.h>
+#include "Rng.h"
+
 /* ============================================================
  *              STRUTTURA DELLA RETE NEURALE
  * ============================================================
@@ -69,8 +73,100 @@ typedef struct {
     double l2;             // Coefficiente di regolarizzazione L2
                            // (0 = disattivata)
 
+    Rng rng;
+    // Generatore pseudo-casuale del modello: inizializzazione
+    // dei pesi e ordine dei campioni a ogni epoca
+
+    /* -------------------------
+     * Workspace per il training a mini-batch
+     * ------------------------- */
+
+    int batch_capacity;
+    // Numero massimo di campioni gestibili dai buffer di batch
+    // (cresce su richiesta, mai riallocato a ogni chiamata)
+
+    double *batch_input;
+    // Input del batch trasposto
+    // Dimensione: [num_inputs][batch]
+
+    double *batch_hidden;
+    // Attivazioni hidden del batch
+    // Dimensione: [num_hidden][batch]
+
+    double *batch_hidden_grad;
+    // Gradiente sullo strato hidden del batch
+    // Dimensione: [num_hidden][batch]
+
+    double *batch_output;
+    // Probabilità di output del batch, poi gradiente output
+    // Dimensione: [num_outputs][batch]
+
+    double *grad_input_hidden;   // [num_hidden][num_inputs]
+    double *grad_hidden_output;  // [num_outputs][num_hidden]
+    double *grad_bias_hidden;    // [num_hidden]
+    double *grad_bias_output;    // [num_outputs]
+    // Viste sul blocco 'gradienti'
+
+    /* -------------------------
+     * Arena dei parametri
+     * ------------------------- */
+
+    double *parametri;
+    // Blocco unico allineato a 64 byte: [ W1 | W2 | b1 | b2 ]
+    // I puntatori a pesi e bias sono viste su questo blocco:
+    // copiare, clonare o salvare un modello è un solo memcpy.
+
+    int num_parametri;  // Lunghezza del blocco in double (padding incluso)
+    int num_pesi;       // Prefisso occupato da W1 e W2 (soggetto a L2)
+
+    double *gradienti;
+    // Accumulatori dei gradienti, stesso layout di 'parametri'
+
+    void *arena;        // Allocazione unica: parametri, gradienti,
+                        // attivazioni e cache
+    void *batch_arena;  // Allocazione unica dei buffer di batch
+
+    /* -------------------------
+     * Checkpoint mappato in memoria
+     * ------------------------- */
+
+    void *mappa;        // Mappatura del file da cui provengono
+                        // pesi e bias (NULL se allocati su heap)
+    size_t mappa_dim;   // Dimensione della mappatura in byte
+
 } NeuralNetwork;
 
+/* ============================================================
+ *              WORKSPACE PER L'ELABORAZIONE A BATCH
+ * ============================================================
+ *
+ * Buffer di appoggio posseduti dal chiamante.
+ * L'inferenza a batch e il calcolo del gradiente non scrivono
+ * mai nella rete: più thread possono usare lo stesso modello,
+ * ciascuno con il proprio workspace.
+ */
+typedef struct {
+
+    int num_inputs;     // Dimensioni della rete di riferimento
+    int num_hidden;
+    int num_outputs;
+
+    int capacity;       // Campioni elaborati per blocco
+
+    double *input;        // Input trasposto     [num_inputs][capacity]
+    double *hidden;       // Attivazioni hidden  [num_hidden][capacity]
+    double *output;       // Logit di output     [num_outputs][capacity]
+    double *hidden_grad;  // Gradiente hidden    [num_hidden][capacity]
+    double *riga;         // Softmax di un campione [num_outputs]
+
+} NN_Workspace;
+
+/*
+ * Seme del generatore per le reti non create con nn_create
+ * (es. caricate da un checkpoint)
+ */
+#define NN_SEME_PREDEFINITO  42
+
 /* ============================================================
  *              INTERFACCIA PUBBLICA
  * ============================================================
@@ -84,13 +180,16 @@ typedef struct {
  * outputs : numero di classi/stati di output
  * lr      : learning rate
  * l2      : regolarizzazione L2
+ * seme    : seme del generatore del modello; a parità di
+ *           seme i pesi iniziali sono identici
  */
 NeuralNetwork *nn_create(
     int inputs,
     int hidden,
     int outputs,
     double lr,
-    double l2
+    double l2,
+    uint64_t seme
 );
 
 /*
@@ -98,6 +197,19 @@ NeuralNetwork *nn_create(
  */
 void nn_free(NeuralNetwork *net);
 
+/*
+ * Reinizializza il generatore del modello con un nuovo seme
+ * (es. dopo nn_load, che usa NN_SEME_PREDEFINITO)
+ */
+void nn_imposta_seme(NeuralNetwork *net, uint64_t seme);
+
+/*
+ * Permutazione casuale sul posto degli indici ordine[0..n),
+ * estratta dal generatore del modello: da chiamare all'inizio
+ * di ogni epoca per visitare i campioni in ordine diverso.
+ */
+void nn_mescola(NeuralNetwork *net, int *ordine, int n);
+
 /*
  * Forward propagation:
  * calcola P(stato | osservazioni)
@@ -108,10 +220,81 @@ void nn_forward(
 );
 
 /*
- * Training della rete neurale:
+ * Crea un workspace per l'inferenza a batch sulla rete 'net'.
+ *
+ * capacity : numero di campioni elaborati per blocco;
+ *            batch più grandi vengono suddivisi in blocchi
+ */
+NN_Workspace *nn_workspace_create(
+    const NeuralNetwork *net,
+    int capacity
+);
+
+/*
+ * Dealloca un workspace di inferenza
+ */
+void nn_workspace_free(NN_Workspace *ws);
+
+/*
+ * Forward propagation a batch (rientrante):
+ * calcola P(stato | osservazioni) per n campioni.
+ *
+ * La rete è acceduta in sola lettura; tutti i valori
+ * intermedi risiedono nel workspace del chiamante.
+ *
+ * X     : input,         [n][num_inputs]
+ * P_out : probabilità,   [n][num_outputs]
+ *
+ * Ritorna 0 se ok, -1 se il workspace è stato creato per
+ * un'architettura diversa (P_out non viene scritto).
+ */
+int nn_forward_batch(
+    const NeuralNetwork *net,
+    const double *X,
+    int n,
+    double *P_out,
+    NN_Workspace *ws
+);
+
+/*
+ * Gradiente della loss sommato su n campioni (rientrante).
+ *
+ * X    : input,          [n][num_inputs]
+ * Y    : target one-hot, [n][num_outputs]
+ * grad : blocco di num_parametri double, stesso layout di
+ *        net->parametri; viene sovrascritto
+ *
+ * Ritorna 0 se ok, -1 se il workspace è stato creato per
+ * un'architettura diversa (grad non viene scritto).
+ */
+int nn_calcola_gradiente(
+    const NeuralNetwork *net,
+    const double *X,
+    const double *Y,
+    int n,
+    double *grad,
+    NN_Workspace *ws
+);
+
+/*
+ * Applica un gradiente sommato su batch_size campioni
+ * (passo sul gradiente medio, con regolarizzazione L2)
+ */
+void nn_applica_gradiente(
+    NeuralNetwork *net,
+    const double *grad,
+    int batch_size
+);
+
+/*
+ * Training della rete neurale su un singolo campione:
  * - forward propagation
  * - backpropagation
  * - aggiornamento dei pesi
+ *
+ * Equivale a nn_train_batch con batch_size = 1, che non
+ * fallisce: i buffer per un campione sono riservati alla
+ * creazione della rete.
  */
 void nn_train(
     NeuralNetwork *net,
@@ -119,4 +302,77 @@ void nn_train(
     const double *target
 );
 
+/*
+ * Training a mini-batch:
+ * accumula il gradiente medio sull'intero batch e applica
+ * un solo aggiornamento dei pesi.
+ *
+ * X          : input del batch, [batch_size][num_inputs]
+ * Y          : target one-hot,  [batch_size][num_outputs]
+ * batch_size : numero di campioni del batch
+ *
+ * Ritorna 0 se ok, -1 se i buffer per batch_size campioni
+ * non possono essere allocati (i pesi non vengono
+ * modificati).
+ */
+int nn_train_batch(
+    NeuralNetwork *net,
+    const double *X,
+    const double *Y,
+    int batch_size
+);
+
+/*
+ * Crea una nuova rete con la stessa architettura, gli stessi
+ * iperparametri e una copia dei parametri di 'src'
+ */
+NeuralNetwork *nn_clone(const NeuralNetwork *src);
+
+/*
+ * Copia tutti i parametri di 'src' in 'dst' (un solo memcpy).
+ * Ritorna -1 se le architetture non coincidono.
+ */
+int nn_copia_parametri(
+    NeuralNetwork *dst,
+    const NeuralNetwork *src
+);
+
+/*
+ * Media dei parametri di n reti (ensemble):
+ * dst = (1/n) Σ src[k]. dst può coincidere con una delle src[k]
+ * solo se è src[0]. Ritorna -1 se le architetture non coincidono.
+ */
+int nn_media_parametri(
+    NeuralNetwork *dst,
+    const NeuralNetwork *const *src,
+    int n
+);
+
+/*
+ * Salva la rete in un checkpoint binario versionato:
+ * dimensioni, learning_rate, l2 e tutti i pesi e bias,
+ * con ogni array allineato a 64 byte.
+ *
+ * Ritorna 0 se ok, -1 in caso di errore di I/O.
+ */
+int nn_save(
+    const NeuralNetwork *net,
+    const char *path
+);
+
+/*
+ * Carica una rete da checkpoint.
+ *
+ * usa_mmap = 0 : i parametri vengono copiati in memoria propria
+ * usa_mmap = 1 : il file viene mappato e pesi e bias puntano
+ *                direttamente nella mappatura, senza copia
+ *
+ * Ritorna NULL se il file manca, è corrotto o di una
+ * versione non supportata.
+ */
+NeuralNetwork *nn_load(
+    const char *path,
+    int usa_mmap
+);
+
 #endif
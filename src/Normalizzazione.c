@@ -0,0 +1,163 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdatomic.h>
+#include <pthread.h>
+#include "Normalizzazione.h"
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define NORM_X86 1
+#include <immintrin.h>
+#endif
+
+/* ============================================================
+ * COSTANTI DELLO SCHEMA
+ * ============================================================ */
+
+#define NORM_NOME(id, nome, scala, traslazione)  nome,
+#define NORM_SCALA(id, nome, scala, traslazione) scala,
+#define NORM_TRASL(id, nome, scala, traslazione) traslazione,
+
+const char *const norm_nomi[NORM_N_FEATURE] = { NORM_SCHEMA(NORM_NOME) };
+const double norm_scala[NORM_N_FEATURE] = { NORM_SCHEMA(NORM_SCALA) };
+const double norm_traslazione[NORM_N_FEATURE] = { NORM_SCHEMA(NORM_TRASL) };
+
+/* ============================================================
+ * PERCORSO GENERICO
+ * ============================================================ */
+
+void norm_batch_generico(const double *raw, double *out, long n, int d,
+                         const double *scala, const double *traslazione) {
+    for (long r = 0; r < n; r++, raw += d, out += d)
+        for (int k = 0; k < d; k++)
+            out[k] = (raw[k] - traslazione[k]) / scala[k];
+}
+
+#ifdef NORM_X86
+
+/* ============================================================
+ * PERCORSI VETTORIALI
+ * ============================================================
+ *
+ * Le righe sono lunghe NORM_N_FEATURE (dispari): il motivo
+ * delle costanti si ripete ogni 2 righe su registri da 2
+ * double e ogni 4 righe su registri da 4. Le costanti di
+ * un passo sono lo schema ripetuto 2 o 4 volte, generato
+ * a compilazione; la coda di righe usa norm_riga.
+ */
+
+#define NORM_PASSO2 (2 * NORM_N_FEATURE)
+#define NORM_PASSO4 (4 * NORM_N_FEATURE)
+
+static const double scala2[NORM_PASSO2] = {
+    NORM_SCHEMA(NORM_SCALA) NORM_SCHEMA(NORM_SCALA)
+};
+static const double trasl2[NORM_PASSO2] = {
+    NORM_SCHEMA(NORM_TRASL) NORM_SCHEMA(NORM_TRASL)
+};
+static const double scala4[NORM_PASSO4] = {
+    NORM_SCHEMA(NORM_SCALA) NORM_SCHEMA(NORM_SCALA)
+    NORM_SCHEMA(NORM_SCALA) NORM_SCHEMA(NORM_SCALA)
+};
+static const double trasl4[NORM_PASSO4] = {
+    NORM_SCHEMA(NORM_TRASL) NORM_SCHEMA(NORM_TRASL)
+    NORM_SCHEMA(NORM_TRASL) NORM_SCHEMA(NORM_TRASL)
+};
+
+/*
+ * Un passo: un vettore per feature dello schema, generato
+ * dalla X-macro (il vettore j copre gli elementi [w·j, w·j+w)
+ * delle w righe del passo), costanti caricate fuori dal ciclo
+ */
+#define NORM_CARICA2(id, nome, scala, traslazione)                         \
+    const __m128d s_##id = _mm_loadu_pd(scala2 + 2 * NORM_##id);           \
+    const __m128d t_##id = _mm_loadu_pd(trasl2 + 2 * NORM_##id);
+#define NORM_VETT2(id, nome, scala, traslazione)                           \
+    _mm_storeu_pd(out + 2 * NORM_##id, _mm_div_pd(                         \
+        _mm_sub_pd(_mm_loadu_pd(raw + 2 * NORM_##id), t_##id), s_##id));
+
+#define NORM_CARICA4(id, nome, scala, traslazione)                         \
+    const __m256d s_##id = _mm256_loadu_pd(scala4 + 4 * NORM_##id);        \
+    const __m256d t_##id = _mm256_loadu_pd(trasl4 + 4 * NORM_##id);
+#define NORM_VETT4(id, nome, scala, traslazione)                           \
+    _mm256_storeu_pd(out + 4 * NORM_##id, _mm256_div_pd(                   \
+        _mm256_sub_pd(_mm256_loadu_pd(raw + 4 * NORM_##id), t_##id), s_##id));
+
+/* SSE2 fa parte dell'ABI x86-64: sempre disponibile */
+static long norm_batch_sse2(const double *raw, double *out, long n) {
+    NORM_SCHEMA(NORM_CARICA2)
+
+    long r = 0;
+    for (; r + 2 <= n; r += 2, raw += NORM_PASSO2, out += NORM_PASSO2) {
+        NORM_SCHEMA(NORM_VETT2)
+    }
+    return r;
+}
+
+/* Compilato con l'attributo target, scelto solo se la CPU ha AVX */
+__attribute__((target("avx")))
+static long norm_batch_avx(const double *raw, double *out, long n) {
+    NORM_SCHEMA(NORM_CARICA4)
+
+    long r = 0;
+    for (; r + 4 <= n; r += 4, raw += NORM_PASSO4, out += NORM_PASSO4) {
+        NORM_SCHEMA(NORM_VETT4)
+    }
+    return r;
+}
+
+#endif /* NORM_X86 */
+
+/* ============================================================
+ * SELEZIONE DEL PERCORSO
+ * ============================================================
+ *
+ * Come per NN_Kernels: il percorso vettoriale è scelto una
+ * volta sola (pthread_once) e pubblicato con una store di
+ * rilascio; norm_batch lo legge con una load di acquisizione.
+ * Il passo restituisce le righe elaborate, il resto va a
+ * norm_riga.
+ */
+
+typedef long (*Norm_Passo)(const double *raw, double *out, long n);
+
+static long norm_batch_scalare(const double *raw, double *out, long n) {
+    (void)raw; (void)out; (void)n;
+    return 0;
+}
+
+static _Atomic(Norm_Passo) passo_attivo = norm_batch_scalare;
+static atomic_int righe_passo = 1;
+static pthread_once_t una_volta = PTHREAD_ONCE_INIT;
+
+static void norm_seleziona(void) {
+#ifdef NORM_X86
+    __builtin_cpu_init();
+    const int avx = __builtin_cpu_supports("avx");
+
+    atomic_store_explicit(&righe_passo, avx ? 4 : 2, memory_order_relaxed);
+    atomic_store_explicit(&passo_attivo,
+                          avx ? norm_batch_avx : norm_batch_sse2,
+                          memory_order_release);
+#endif
+}
+
+static inline Norm_Passo norm_passo(void) {
+    pthread_once(&una_volta, norm_seleziona);
+    return atomic_load_explicit(&passo_attivo, memory_order_acquire);
+}
+
+/* ============================================================
+ * INTERFACCIA PUBBLICA
+ * ============================================================ */
+
+int norm_righe_per_passo(void) {
+    norm_passo();
+    return atomic_load_explicit(&righe_passo, memory_order_relaxed);
+}
+
+void norm_batch(const double *raw, double *out, long n) {
+    long r = norm_passo()(raw, out, n);
+
+    for (; r < n; r++)
+        norm_riga(raw + r * NORM_N_FEATURE, out + r * NORM_N_FEATURE);
+}
@@ -0,0 +1,81 @@
+#ifndef NORMALIZZAZIONE_H
+#define NORMALIZZAZIONE_H
+
+/* ============================================================
+ *          NORMALIZZAZIONE DELLE FEATURE (ICON8)
+ * ============================================================
+ *
+ * Unica definizione dello schema delle feature di input e
+ * unico percorso di normalizzazione, usato sia dal training
+ * (caricamento del CSV, formato colonnare, modo online) sia
+ * dall'inferenza:
+ *
+ *   normalizzata = (grezza - traslazione) / scala
+ *
+ * Dallo schema vengono generati a compilazione:
+ *  - norm_riga: una riga, completamente srotolata con le
+ *    costanti dello schema
+ *  - norm_batch: batch [n][NORM_N_FEATURE], anche sul posto,
+ *    con vettori SSE2 (2 righe per passo) o AVX (4 righe)
+ *    scelti una volta a runtime, come in NN_Kernels
+ * norm_batch_generico accetta invece larghezza e costanti
+ * qualsiasi.
+ *
+ * Tutti i percorsi usano una sottrazione e una divisione per
+ * elemento: i risultati sono identici bit per bit tra loro.
+ */
+
+/* --------------------------------------------------
+ * Schema (X-macro): identificatore, nome, scala,
+ * traslazione. L'ordine è quello delle colonne di
+ * dataset.csv.
+ * -------------------------------------------------- */
+#define NORM_SCHEMA(X)                                \
+    X(ORA,          "ora",          24.0,   0.0)      \
+    X(TEMP_EXT,     "temp_ext",     10.0,   0.0)      \
+    X(LUCI,         "luci",          1.0,   0.0)      \
+    X(MOVIMENTO,    "movimento",     1.0,   0.0)      \
+    X(CONSUMO,      "consumo",      10.0,   0.0)      \
+    X(PREZZO,       "prezzo",        1.0,   0.0)      \
+    X(TEMP_INT,     "temp_int",     30.0,   0.0)
+
+#define NORM_ENUM(id, nome, scala, traslazione) NORM_##id,
+enum { NORM_SCHEMA(NORM_ENUM) NORM_N_FEATURE };
+#undef NORM_ENUM
+
+/* Costanti dello schema, per chi le registra o le confronta */
+extern const char *const norm_nomi[NORM_N_FEATURE];
+extern const double norm_scala[NORM_N_FEATURE];
+extern const double norm_traslazione[NORM_N_FEATURE];
+
+/*
+ * Normalizza una riga (raw e out possono coincidere)
+ */
+static inline void norm_riga(const double *raw, double *out) {
+#define NORM_PASSO(id, nome, scala, traslazione) \
+    out[NORM_##id] = (raw[NORM_##id] - (traslazione)) / (scala);
+    NORM_SCHEMA(NORM_PASSO)
+#undef NORM_PASSO
+}
+
+/*
+ * Normalizza n righe [n][NORM_N_FEATURE]. raw == out
+ * normalizza sul posto; altre sovrapposizioni non sono
+ * ammesse.
+ */
+void norm_batch(const double *raw, double *out, long n);
+
+/*
+ * Come norm_batch per righe di d feature con costanti
+ * arbitrarie, scala[d] e traslazione[d]
+ */
+void norm_batch_generico(const double *raw, double *out, long n, int d,
+                         const double *scala, const double *traslazione);
+
+/*
+ * Righe elaborate per passo vettoriale da norm_batch su
+ * questa CPU (4 = AVX, 2 = SSE2, 1 = scalare)
+ */
+int norm_righe_per_passo(void);
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef OROLOGIO_H
+#define OROLOGIO_H
+
+/* ============================================================
+ *                   OROLOGIO MONOTONO
+ * ============================================================
+ *
+ * Unica sorgente di tempo per statistiche, metriche e
+ * benchmark: CLOCK_MONOTONIC, non influenzato dalle
+ * correzioni dell'ora di sistema.
+ *
+ * Da includere dopo aver definito _POSIX_C_SOURCE
+ * (necessario per clock_gettime).
+ */
+
+#include <stdint.h>
+#include <time.h>
+
+/*
+ * Tempo monotono in nanosecondi
+ */
+static inline uint64_t orologio_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+/*
+ * Tempo monotono in secondi
+ */
+static inline double orologio_secondi(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+#endif
@@ -0,0 +1,311 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <pthread.h>
+#include <glpk.h>
+#include "PL_Lotto.h"
+
+#define PLL_MAX_PIANIFICATORI 16    // Dimensioni distinte tenute per thread
+
+/* ============================================================
+ * STRUTTURA DEL POOL
+ * ============================================================ */
+
+typedef struct {
+    int n;
+    PL_Scheduler *s;
+} PLL_Voce;
+
+typedef struct {
+    /* Intervallo [inizio, fine) ancora da risolvere: il
+     * proprietario preleva da inizio, i ladri tagliano fine */
+    _Alignas(64) pthread_mutex_t mutex;
+    int inizio;
+    int fine;
+
+    struct PL_Lotto *lotto;
+    int indice;
+    pthread_t tid;
+
+    /* Solo il thread proprietario */
+    PLL_Voce voci[PLL_MAX_PIANIFICATORI];
+    int prossima;           // Voce da sostituire quando sono tutte usate
+    int rapido;             // Impostazione applicata ai pianificatori
+    long risolti, non_ottimi, furti, pianificatori;
+} PLL_Lavoratore;
+
+struct PL_Lotto {
+
+    int n_thread;
+    int n_avviati;
+    PLL_Lavoratore *lav;
+
+    /* Lavoro corrente, pubblicato sotto mutex */
+    const PL_Edificio *edifici;
+    PL_Risultato *res;
+    int *esiti;
+    int rapido;
+
+    pthread_mutex_t mutex;
+    pthread_cond_t  avvio;
+    pthread_cond_t  fine;
+    unsigned long generazione;
+    int in_corso;
+    int termina;
+};
+
+/* ============================================================
+ * PIANIFICATORI DEL THREAD
+ * ============================================================ */
+
+/*
+ * Pianificatore per n appartamenti: riusato se già presente
+ * (warm start dalla base dell'ultimo edificio della stessa
+ * dimensione), altrimenti creato al posto della voce più
+ * vecchia.
+ */
+static PL_Scheduler *pll_pianificatore(PLL_Lavoratore *w, int n) {
+    for (int k = 0; k < PLL_MAX_PIANIFICATORI; k++)
+        if (w->voci[k].s && w->voci[k].n == n)
+            return w->voci[k].s;
+
+    PL_Scheduler *s = pl_crea(n);
+    if (!s) return NULL;
+    pl_imposta_rapido(s, w->rapido);
+    w->pianificatori++;
+
+    PLL_Voce *v = &w->voci[w->prossima];
+    w->prossima = (w->prossima + 1) % PLL_MAX_PIANIFICATORI;
+    pl_free(v->s);
+    v->n = n;
+    v->s = s;
+    return s;
+}
+
+static void pll_risolvi_edificio(PLL_Lavoratore *w, int i) {
+    PL_Lotto *l = w->lotto;
+    const PL_Edificio *e = &l->edifici[i];
+
+    PL_Scheduler *s = pll_pianificatore(w, e->n);
+    const int esito = s
+        ? pl_risolvi(s, e->occ_prob, e->price, e->comfort_gain,
+                     e->risk_coeff, e->budget, e->risk_max, &l->res[i])
+        : -1;
+
+    if (l->esiti) l->esiti[i] = esito;
+    if (esito != 0) w->non_ottimi++;
+    w->risolti++;
+}
+
+/* ============================================================
+ * WORK STEALING
+ * ============================================================ */
+
+/* Prossimo edificio del proprio intervallo, -1 se vuoto */
+static int pll_preleva(PLL_Lavoratore *w) {
+    int i = -1;
+    pthread_mutex_lock(&w->mutex);
+    if (w->inizio < w->fine)
+        i = w->inizio++;
+    pthread_mutex_unlock(&w->mutex);
+    return i;
+}
+
+/*
+ * Ruba la metà superiore dell'intervallo di un altro thread,
+ * scorrendo le vittime a partire dal successivo. Ritorna 1 se
+ * il proprio intervallo non è più vuoto.
+ */
+static int pll_ruba(PLL_Lavoratore *w) {
+    PL_Lotto *l = w->lotto;
+
+    for (int d = 1; d < l->n_thread; d++) {
+        PLL_Lavoratore *v = &l->lav[(w->indice + d) % l->n_thread];
+
+        pthread_mutex_lock(&v->mutex);
+        const int resto = v->fine - v->inizio;
+        int da = 0, a = 0;
+        if (resto > 0) {
+            a = v->fine;
+            da = v->fine - (resto + 1) / 2;
+            v->fine = da;
+        }
+        pthread_mutex_unlock(&v->mutex);
+
+        if (a > da) {
+            pthread_mutex_lock(&w->mutex);
+            w->inizio = da;
+            w->fine = a;
+            pthread_mutex_unlock(&w->mutex);
+            w->furti++;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void *pll_thread(void *arg) {
+    PLL_Lavoratore *w = (PLL_Lavoratore*)arg;
+    PL_Lotto *l = w->lotto;
+    unsigned long vista = 0;
+
+    for (;;) {
+        pthread_mutex_lock(&l->mutex);
+        while (!l->termina && l->generazione == vista)
+            pthread_cond_wait(&l->avvio, &l->mutex);
+        if (l->termina) {
+            pthread_mutex_unlock(&l->mutex);
+            break;
+        }
+        vista = l->generazione;
+        const int rapido = l->rapido;
+        pthread_mutex_unlock(&l->mutex);
+
+        if (rapido != w->rapido) {
+            w->rapido = rapido;
+            for (int k = 0; k < PLL_MAX_PIANIFICATORI; k++)
+                if (w->voci[k].s) pl_imposta_rapido(w->voci[k].s, rapido);
+        }
+
+        /* Ogni furto riduce il lavoro restante: il ciclo
+         * termina quando tutti gli intervalli sono vuoti */
+        do {
+            int i;
+            while ((i = pll_preleva(w)) >= 0)
+                pll_risolvi_edificio(w, i);
+        } while (pll_ruba(w));
+
+        pthread_mutex_lock(&l->mutex);
+        if (--l->in_corso == 0)
+            pthread_cond_signal(&l->fine);
+        pthread_mutex_unlock(&l->mutex);
+    }
+
+    /* I problemi e l'ambiente GLPK appartengono al thread */
+    for (int k = 0; k < PLL_MAX_PIANIFICATORI; k++)
+        pl_free(w->voci[k].s);
+    glp_free_env();
+    return NULL;
+}
+
+/* ============================================================
+ * CREAZIONE E DISTRUZIONE
+ * ============================================================ */
+
+PL_Lotto *pll_crea(int n_thread) {
+    if (n_thread < 1) n_thread = 1;
+
+    PL_Lotto *l = (PL_Lotto*)calloc(1, sizeof(PL_Lotto));
+    if (!l) return NULL;
+
+    l->n_thread = n_thread;
+    l->rapido = 1;
+    l->lav = (PLL_Lavoratore*)aligned_alloc(
+        _Alignof(PLL_Lavoratore), (size_t)n_thread * sizeof(PLL_Lavoratore));
+    if (!l->lav) {
+        free(l);
+        return NULL;
+    }
+
+    pthread_mutex_init(&l->mutex, NULL);
+    pthread_cond_init(&l->avvio, NULL);
+    pthread_cond_init(&l->fine, NULL);
+
+    for (int k = 0; k < n_thread; k++) {
+        PLL_Lavoratore *w = &l->lav[k];
+        *w = (PLL_Lavoratore){ .lotto = l, .indice = k, .rapido = 1 };
+        pthread_mutex_init(&w->mutex, NULL);
+    }
+
+    for (int k = 0; k < n_thread; k++) {
+        if (pthread_create(&l->lav[k].tid, NULL, pll_thread, &l->lav[k]) != 0) {
+            pll_free(l);
+            return NULL;
+        }
+        l->n_avviati = k + 1;
+    }
+
+    return l;
+}
+
+void pll_free(PL_Lotto *l) {
+    if (!l) return;
+
+    pthread_mutex_lock(&l->mutex);
+    l->termina = 1;
+    pthread_cond_broadcast(&l->avvio);
+    pthread_mutex_unlock(&l->mutex);
+
+    for (int k = 0; k < l->n_avviati; k++)
+        pthread_join(l->lav[k].tid, NULL);
+
+    for (int k = 0; k < l->n_thread; k++)
+        pthread_mutex_destroy(&l->lav[k].mutex);
+
+    pthread_mutex_destroy(&l->mutex);
+    pthread_cond_destroy(&l->avvio);
+    pthread_cond_destroy(&l->fine);
+
+    free(l->lav);
+    free(l);
+}
+
+int pll_num_thread(const PL_Lotto *l) {
+    return l->n_thread;
+}
+
+void pll_imposta_rapido(PL_Lotto *l, int attivo) {
+    pthread_mutex_lock(&l->mutex);
+    l->rapido = attivo ? 1 : 0;
+    pthread_mutex_unlock(&l->mutex);
+}
+
+/* ============================================================
+ * RISOLUZIONE DI UN LOTTO
+ * ============================================================ */
+
+int pll_risolvi(PL_Lotto *l, const PL_Edificio edifici[], int n,
+                PL_Risultato res[], int esiti[]) {
+
+    if (n <= 0) return 0;
+
+    long non_ottimi = 0;
+    for (int k = 0; k < l->n_thread; k++)
+        non_ottimi -= l->lav[k].non_ottimi;
+
+    /* ---------- Intervalli iniziali e pubblicazione ---------- */
+    pthread_mutex_lock(&l->mutex);
+    for (int k = 0; k < l->n_thread; k++) {
+        PLL_Lavoratore *w = &l->lav[k];
+        pthread_mutex_lock(&w->mutex);
+        w->inizio = (int)((long)k * n / l->n_thread);
+        w->fine   = (int)((long)(k + 1) * n / l->n_thread);
+        pthread_mutex_unlock(&w->mutex);
+    }
+    l->edifici = edifici;
+    l->res = res;
+    l->esiti = esiti;
+    l->in_corso = l->n_thread;
+    l->generazione++;
+    pthread_cond_broadcast(&l->avvio);
+
+    /* ---------- Attesa ---------- */
+    while (l->in_corso > 0)
+        pthread_cond_wait(&l->fine, &l->mutex);
+    pthread_mutex_unlock(&l->mutex);
+
+    for (int k = 0; k < l->n_thread; k++)
+        non_ottimi += l->lav[k].non_ottimi;
+    return (int)non_ottimi;
+}
+
+void pll_statistiche(const PL_Lotto *l, PLL_Statistiche *st) {
+    *st = (PLL_Statistiche){ 0 };
+    for (int k = 0; k < l->n_thread; k++) {
+        const PLL_Lavoratore *w = &l->lav[k];
+        st->edifici       += w->risolti;
+        st->non_ottimi    += w->non_ottimi;
+        st->furti         += w->furti;
+        st->pianificatori += w->pianificatori;
+    }
+}
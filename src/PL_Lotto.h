@@ -0,0 +1,86 @@
+#ifndef PL_LOTTO_H
+#define PL_LOTTO_H
+
+#include "PL_Scheduler.h"
+
+/* ============================================================
+ *        PIANIFICAZIONE DI PIÙ CONDOMINI IN PARALLELO
+ * ============================================================
+ *
+ * A ogni tick ogni edificio ripianifica con un proprio
+ * problema di PL, indipendente dagli altri. Il lotto li
+ * distribuisce su un pool di thread persistenti:
+ *
+ *  - gli edifici sono divisi in intervalli contigui, uno per
+ *    thread; chi esaurisce il proprio ruba metà di ciò che
+ *    resta a un altro (work stealing), così edifici grandi o
+ *    simplex lenti non lasciano core fermi
+ *  - ogni thread ha il proprio ambiente GLPK (GLPK lo tiene
+ *    per thread) e i propri pianificatori PL_Scheduler, uno
+ *    per numero di appartamenti, riusati tra un tick e l'altro
+ *    con warm start; l'ambiente è rilasciato con glp_free_env
+ *    alla chiusura del thread
+ *  - i risultati sono scritti nella posizione dell'edificio:
+ *    l'ordine di uscita è quello di ingresso
+ */
+
+typedef struct PL_Lotto PL_Lotto;
+
+/* Un'istanza: stessi dati e significati di pl_risolvi */
+typedef struct {
+    int n;                          // Appartamenti
+    const double *occ_prob;         // [n]
+    const double *price;            // [n]
+    const double *comfort_gain;     // [n]
+    const double *risk_coeff;       // [n]
+    double budget;
+    double risk_max;
+} PL_Edificio;
+
+typedef struct {
+    long edifici;           // Edifici risolti dalla creazione
+    long non_ottimi;        //   di cui senza ottimo
+    long furti;             // Intervalli rubati tra thread
+    long pianificatori;     // PL_Scheduler creati
+} PLL_Statistiche;
+
+/*
+ * Crea il pool con n_thread thread di lavoro. Il chiamante
+ * di pll_risolvi resta in attesa e non usa GLPK.
+ * Ritorna NULL in caso di errore.
+ */
+PL_Lotto *pll_crea(int n_thread);
+
+/*
+ * Termina i thread (ciascuno libera pianificatori e ambiente
+ * GLPK) e libera il pool
+ */
+void pll_free(PL_Lotto *l);
+
+int pll_num_thread(const PL_Lotto *l);
+
+/*
+ * Percorso rapido dei pianificatori (vedi pl_imposta_rapido),
+ * attivo per default. Vale dalla risoluzione successiva.
+ */
+void pll_imposta_rapido(PL_Lotto *l, int attivo);
+
+/*
+ * Risolve gli n edifici. res[i] deve essere stato creato con
+ * pl_risultato_init(&res[i], edifici[i].n); esiti[i] riceve
+ * l'esito di pl_risolvi (0 = ottimo, -1 altrimenti) e può
+ * essere NULL.
+ *
+ * Ritorna il numero di edifici senza ottimo.
+ */
+int pll_risolvi(
+    PL_Lotto *l,
+    const PL_Edificio edifici[],
+    int n,
+    PL_Risultato res[],
+    int esiti[]
+);
+
+void pll_statistiche(const PL_Lotto *l, PLL_Statistiche *st);
+
+#endif
@@ -0,0 +1,262 @@
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdlib.h>
+#include <glpk.h>
+#include "PL_Orizzonte.h"
+#include "Orologio.h"
+
+/* ============================================================
+ * INDICIZZAZIONE
+ * ============================================================
+ *
+ * Colonne (1-based), tre per coppia (a, t):
+ *   x[a,t] = 1 + 3·(a·T + t),  T[a,t] = +1,  s[a,t] = +2
+ *
+ * Righe (1-based), due per coppia (a, t) più una per periodo:
+ *   dinamica[a,t] = 1 + 2·(a·T + t),  comfort[a,t] = +1
+ *   budget[t]     = 1 + 2·A·T + t
+ */
+
+struct PL_Orizzonte {
+
+    glp_prob *lp;
+    glp_smcp parm;
+
+    int n_app;
+    int n_periodi;
+
+    double *alpha;          // [n_app]
+    int *stat_col;          // Appoggio per la traslazione della base
+    int *stat_riga;
+
+    PL_Statistiche stat;
+};
+
+static inline int col_x(const PL_Orizzonte *o, int a, int t) {
+    return 1 + 3 * (a * o->n_periodi + t);
+}
+
+static inline int riga_dinamica(const PL_Orizzonte *o, int a, int t) {
+    return 1 + 2 * (a * o->n_periodi + t);
+}
+
+static inline int riga_budget(const PL_Orizzonte *o, int t) {
+    return 1 + 2 * o->n_app * o->n_periodi + t;
+}
+
+/* ============================================================
+ * CREAZIONE DEL PROBLEMA
+ * ============================================================ */
+
+PL_Orizzonte *plo_crea(int n_app, int n_periodi,
+                       const double alpha[], const double beta[]) {
+    if (n_app <= 0 || n_periodi <= 0) return NULL;
+
+    PL_Orizzonte *o = (PL_Orizzonte*)calloc(1, sizeof(PL_Orizzonte));
+    if (!o) return NULL;
+
+    const int AT = n_app * n_periodi;
+    const int n_col = 3 * AT;
+    const int n_righe = 2 * AT + n_periodi;
+
+    o->n_app = n_app;
+    o->n_periodi = n_periodi;
+    o->alpha     = (double*)malloc((size_t)n_app * sizeof(double));
+    o->stat_col  = (int*)malloc((size_t)(n_col + 1) * sizeof(int));
+    o->stat_riga = (int*)malloc((size_t)(n_righe + 1) * sizeof(int));
+
+    /* Matrice in formato a triple (1-based): al più 6 non
+     * nulli per coppia (a, t) */
+    const int nz_max = 6 * AT;
+    int *ia = (int*)malloc((size_t)(nz_max + 1) * sizeof(int));
+    int *ja = (int*)malloc((size_t)(nz_max + 1) * sizeof(int));
+    double *ar = (double*)malloc((size_t)(nz_max + 1) * sizeof(double));
+
+    if (!o->alpha || !o->stat_col || !o->stat_riga || !ia || !ja || !ar) {
+        free(ia);
+        free(ja);
+        free(ar);
+        free(o->alpha);
+        free(o->stat_col);
+        free(o->stat_riga);
+        free(o);
+        return NULL;
+    }
+
+    for (int a = 0; a < n_app; a++)
+        o->alpha[a] = alpha[a];
+
+    o->lp = glp_create_prob();
+    glp_set_prob_name(o->lp, "heating_horizon");
+    glp_set_obj_dir(o->lp, GLP_MIN);
+    glp_add_cols(o->lp, n_col);
+    glp_add_rows(o->lp, n_righe);
+
+    int nz = 0;
+    for (int a = 0; a < n_app; a++) {
+        for (int t = 0; t < n_periodi; t++) {
+            const int cx = col_x(o, a, t);
+            const int rd = riga_dinamica(o, a, t);
+
+            /* Limiti: potenza in [0,1], temperatura libera,
+             * deficit non negativo */
+            glp_set_col_bnds(o->lp, cx,     GLP_DB, 0.0, 1.0);
+            glp_set_col_bnds(o->lp, cx + 1, GLP_FR, 0.0, 0.0);
+            glp_set_col_bnds(o->lp, cx + 2, GLP_LO, 0.0, 0.0);
+
+            /* Dinamica: T[a,t] - α T[a,t-1] - β x[a,t] = (1-α) T_ext[t] */
+            ia[++nz] = rd; ja[nz] = cx + 1; ar[nz] = 1.0;
+            ia[++nz] = rd; ja[nz] = cx;     ar[nz] = -beta[a];
+            if (t > 0) {
+                ia[++nz] = rd; ja[nz] = cx + 1 - 3; ar[nz] = -alpha[a];
+            }
+
+            /* Comfort: s[a,t] + T[a,t] ≥ t_comfort */
+            ia[++nz] = rd + 1; ja[nz] = cx + 1; ar[nz] = 1.0;
+            ia[++nz] = rd + 1; ja[nz] = cx + 2; ar[nz] = 1.0;
+
+            /* Budget del periodo: Σ_a x[a,t] (scalato dal prezzo
+             * nel termine noto, così la matrice resta costante) */
+            ia[++nz] = riga_budget(o, t); ja[nz] = cx; ar[nz] = 1.0;
+        }
+    }
+
+    glp_load_matrix(o->lp, nz, ia, ja, ar);
+    free(ia);
+    free(ja);
+    free(ar);
+
+    glp_init_smcp(&o->parm);
+    o->parm.msg_lev = GLP_MSG_OFF;
+    o->parm.presolve = GLP_OFF;
+
+    glp_std_basis(o->lp);
+
+    return o;
+}
+
+void plo_free(PL_Orizzonte *o) {
+    if (!o) return;
+    glp_delete_prob(o->lp);
+    free(o->alpha);
+    free(o->stat_col);
+    free(o->stat_riga);
+    free(o);
+}
+
+void plo_statistiche(const PL_Orizzonte *o, PL_Statistiche *st) {
+    *st = o->stat;
+}
+
+/* ============================================================
+ * RISOLUZIONE
+ * ============================================================ */
+
+int plo_risolvi(PL_Orizzonte *o, const PLO_Dati *d,
+                double *power, double *temp) {
+
+    glp_prob *lp = o->lp;
+    const int A = o->n_app;
+    const int T = o->n_periodi;
+
+    const double t0 = orologio_secondi();
+    const int it0 = glp_get_it_cnt(lp);
+
+    /* ---------- Obiettivo e termini noti ---------- */
+    for (int a = 0; a < A; a++) {
+        const double al = o->alpha[a];
+
+        for (int t = 0; t < T; t++) {
+            const int cx = col_x(o, a, t);
+            const int rd = riga_dinamica(o, a, t);
+
+            glp_set_obj_coef(lp, cx, d->price[t]);
+            glp_set_obj_coef(lp, cx + 2,
+                             d->penalita * d->occ_prob[a * T + t]);
+
+            /* Il primo periodo parte dalla temperatura misurata */
+            double rhs = (1.0 - al) * d->t_ext[t];
+            if (t == 0) rhs += al * d->t_int0[a];
+            glp_set_row_bnds(lp, rd, GLP_FX, rhs, rhs);
+
+            glp_set_row_bnds(lp, rd + 1, GLP_LO, d->t_comfort, 0.0);
+        }
+    }
+
+    /* Budget: Σ_a price[t] x[a,t] ≤ budget[t]  ⇔
+     *         Σ_a x[a,t] ≤ budget[t] / price[t]  (prezzo > 0) */
+    for (int t = 0; t < T; t++) {
+        if (d->price[t] > 0.0)
+            glp_set_row_bnds(lp, riga_budget(o, t), GLP_UP,
+                             0.0, d->budget[t] / d->price[t]);
+        else
+            glp_set_row_bnds(lp, riga_budget(o, t), GLP_FR, 0.0, 0.0);
+    }
+
+    /* ---------- Risoluzione ----------
+     * Se la base traslata non è valida per i nuovi dati si
+     * riparte da una base costruita da GLPK. */
+    int ret = glp_simplex(lp, &o->parm);
+    if (ret == GLP_EBADB || ret == GLP_ESING || ret == GLP_ECOND) {
+        glp_adv_basis(lp, 0);
+        ret = glp_simplex(lp, &o->parm);
+    }
+
+    const int esito = (ret == 0 && glp_get_status(lp) == GLP_OPT) ? 0 : -1;
+
+    /* ---------- Estrazione del piano ---------- */
+    for (int a = 0; a < A; a++)
+        for (int t = 0; t < T; t++) {
+            const int cx = col_x(o, a, t);
+            const double x = glp_get_col_prim(lp, cx);
+            power[a * T + t] = (x > 0.0) ? x : 0.0;
+            if (temp)
+                temp[a * T + t] = glp_get_col_prim(lp, cx + 1);
+        }
+
+    o->stat.iterazioni = glp_get_it_cnt(lp) - it0;
+    o->stat.tempo      = orologio_secondi() - t0;
+    o->stat.esito      = esito;
+    o->stat.n_risoluzioni++;
+    o->stat.iterazioni_totali += o->stat.iterazioni;
+    o->stat.tempo_totale      += o->stat.tempo;
+
+    return esito;
+}
+
+/* ============================================================
+ * ORIZZONTE MOBILE
+ * ============================================================ */
+
+void plo_avanza(PL_Orizzonte *o) {
+    glp_prob *lp = o->lp;
+    const int A = o->n_app;
+    const int T = o->n_periodi;
+    const int n_col = 3 * A * T;
+    const int n_righe = 2 * A * T + T;
+
+    for (int j = 1; j <= n_col; j++)
+        o->stat_col[j] = glp_get_col_stat(lp, j);
+    for (int i = 1; i <= n_righe; i++)
+        o->stat_riga[i] = glp_get_row_stat(lp, i);
+
+    /* Rotazione di un periodo: t eredita lo stato di t+1 e
+     * l'ultimo quello del periodo uscente, così il numero di
+     * variabili in base resta pari al numero di righe */
+    for (int a = 0; a < A; a++)
+        for (int t = 0; t < T; t++) {
+            const int succ = (t + 1) % T;
+            const int cx = col_x(o, a, t);
+            const int rd = riga_dinamica(o, a, t);
+            const int cx_s = col_x(o, a, succ);
+            const int rd_s = riga_dinamica(o, a, succ);
+            for (int k = 0; k < 3; k++)
+                glp_set_col_stat(lp, cx + k, o->stat_col[cx_s + k]);
+            for (int k = 0; k < 2; k++)
+                glp_set_row_stat(lp, rd + k, o->stat_riga[rd_s + k]);
+        }
+
+    for (int t = 0; t < T; t++)
+        glp_set_row_stat(lp, riga_budget(o, t),
+                         o->stat_riga[riga_budget(o, (t + 1) % T)]);
+}
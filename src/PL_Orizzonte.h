@@ -0,0 +1,91 @@
+#ifndef PL_ORIZZONTE_H
+#define PL_ORIZZONTE_H
+
+#include "PL_Scheduler.h"
+
+/* ============================================================
+ *        PIANIFICAZIONE SU ORIZZONTE MOBILE (MULTI-PERIODO)
+ * ============================================================
+ *
+ * Estende la decisione istantanea a un orizzonte di periodi
+ * (es. 96 quarti d'ora): il piano può preriscaldare prima
+ * dei picchi di prezzo sfruttando l'inerzia termica.
+ *
+ * Per ogni appartamento a e periodo t:
+ *   x[a,t] ∈ [0,1]  potenza di riscaldamento
+ *   T[a,t]          temperatura interna a fine periodo
+ *   s[a,t] ≥ 0      deficit di comfort (°C sotto t_comfort)
+ *
+ * Dinamica termica lineare (modello RC discretizzato):
+ *   T[a,t] = α_a T[a,t-1] + (1 - α_a) T_ext[t] + β_a x[a,t]
+ * con T[a,-1] = temperatura interna misurata.
+ *
+ *   min  Σ price[t] x[a,t] + penalita · P(occ)[a,t] · s[a,t]
+ *   s.t. s[a,t] + T[a,t] ≥ t_comfort
+ *        Σ_a price[t] x[a,t] ≤ budget[t]     (per periodo)
+ *
+ * La matrice dipende solo da α e β e viene caricata una sola
+ * volta; a ogni tick cambiano obiettivo e termini noti.
+ */
+
+typedef struct PL_Orizzonte PL_Orizzonte;
+
+/* Dati di un tick, riferiti alla finestra corrente */
+typedef struct {
+    const double *price;     // prezzo per unità di potenza, [n_periodi]
+    const double *t_ext;     // temperatura esterna prevista, [n_periodi]
+    const double *budget;    // costo massimo per periodo, [n_periodi]
+    const double *occ_prob;  // P(occupato), [n_app][n_periodi]
+    const double *t_int0;    // temperatura interna misurata, [n_app]
+    double t_comfort;        // temperatura desiderata se occupato
+    double penalita;         // costo per °C di deficit a occupazione certa
+} PLO_Dati;
+
+/*
+ * Crea il problema per n_app appartamenti su n_periodi.
+ *
+ * alpha[a] ∈ [0,1) : frazione di temperatura conservata
+ *                    in un periodo (inerzia termica)
+ * beta[a]  > 0     : °C guadagnati in un periodo a piena potenza
+ *
+ * Ritorna NULL in caso di errore.
+ */
+PL_Orizzonte *plo_crea(
+    int n_app,
+    int n_periodi,
+    const double alpha[],
+    const double beta[]
+);
+
+void plo_free(PL_Orizzonte *o);
+
+/*
+ * Aggiorna i dati e risolve, ripartendo dalla base corrente.
+ *
+ * power : piano, [n_app][n_periodi]
+ * temp  : temperature previste, [n_app][n_periodi] (può essere NULL)
+ *
+ * Ritorna 0 se è stato trovato l'ottimo, -1 altrimenti.
+ */
+int plo_risolvi(
+    PL_Orizzonte *o,
+    const PLO_Dati *d,
+    double *power,
+    double *temp
+);
+
+/*
+ * Avanza l'orizzonte di un periodo: la base ottima viene
+ * traslata (il periodo t eredita lo stato del periodo t+1,
+ * l'ultimo quello del periodo uscente) come punto di
+ * partenza per il tick successivo. I dati della nuova
+ * finestra vanno passati alla prossima plo_risolvi.
+ */
+void plo_avanza(PL_Orizzonte *o);
+
+/*
+ * Statistiche dell'ultima risoluzione e cumulative
+ */
+void plo_statistiche(const PL_Orizzonte *o, PL_Statistiche *st);
+
+#endif
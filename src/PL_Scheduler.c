@@ -1,5 +1,11 @@
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdlib.h>
 #include <glpk.h>
 #include "PL_Scheduler.h"
+#include "Orologio.h"
+#include "PL_Zaino.h"
+#include "Metriche.h"
 
 /* ============================================================
  *              MACROAREA DECISIONE (ICON3)
@@ -23,13 +29,8 @@
  * Vincoli:
  * 1) Vincolo di budget energetico
  * 2) Vincolo di rischio complessivo
- */
-
-/*
- * ============================================================
- * FUNZIONE calcolarePianoOttimale
  *
- * Costruisce e risolve il problema di PL:
+ * Formulazione completa:
  *
  *   max  Σ x_i * (occ_prob[i] * comfort_gain[i] - price[i])
  *
@@ -38,102 +39,258 @@
  *   Σ x_i * risk_coeff[i] ≤ risk_max
  *   0 ≤ x_i ≤ 1
  *
+ * Con coefficienti non negativi è uno zaino frazionario a
+ * due vincoli: pl_risolvi tenta prima il risolutore dedicato
+ * (PL_Zaino) e ricorre al simplex solo se questo non riesce
+ * a certificare l'ottimo.
+ */
+
+struct PL_Scheduler {
+
+    glp_prob *lp;           // Problema persistente
+    glp_smcp parm;          // Parametri del simplex
+    int n;                  // Numero di slot (colonne)
+
+    int *ind;               // Appoggio per glp_set_mat_row (1-based),
+    double *val;            // [n + 1]
+
+    PL_Zaino *zaino;        // Percorso rapido senza simplex
+    double *coef;           // Coefficienti dell'obiettivo, [n]
+    int rapido;             // 1 = tenta il percorso rapido
+
+    PL_Statistiche stat;
+};
+
+/* ============================================================
+ * RISULTATO
+ * ============================================================ */
+
+int pl_risultato_init(PL_Risultato *res, int n) {
+    res->n = 0;
+    res->power = NULL;
+    if (n <= 0) return 0;
+
+    res->power = (double*)calloc((size_t)n, sizeof(double));
+    if (!res->power) return -1;
+
+    res->n = n;
+    return 0;
+}
+
+void pl_risultato_libera(PL_Risultato *res) {
+    free(res->power);
+    res->power = NULL;
+    res->n = 0;
+}
+
+/* ============================================================
+ * CREAZIONE DEL PROBLEMA DI PROGRAMMAZIONE LINEARE
  * ============================================================
+ *
+ * Si costruisce solo la struttura (colonne, righe, limiti
+ * delle variabili); obiettivo, coefficienti e termini noti
+ * vengono scritti a ogni pl_risolvi.
  */
-PL_Risultato calcolarePianoOttimale(
-    const double occ_prob[],     // Probabilità di occupazione per slot
-    const double price[],        // Prezzo dell’energia per slot
-    const double comfort_gain[], // Utilità attesa per unità di potenza
-    const double risk_coeff[],   // Coefficiente di rischio
-    int n,                       // Numero di slot
-    double budget,               // Budget massimo consentito
-    double risk_max              // Rischio massimo accettabile
-){
-    /* Struttura che conterrà il risultato finale */
-    PL_Risultato res;
-    res.n = n;
+PL_Scheduler *pl_crea(int n) {
+    if (n <= 0) return NULL;
 
-    /* Inizializzazione: potenza nulla per tutti gli slot */
-    for (int i = 0; i < MAX_SLOTS; i++)
-        res.power[i] = 0.0;
+    PL_Scheduler *s = (PL_Scheduler*)calloc(1, sizeof(PL_Scheduler));
+    if (!s) return NULL;
 
-    /* Caso limite: nessuno slot */
-    if (n <= 0) return res;
-
-    /* ========================================================
-     * CREAZIONE DEL PROBLEMA DI PROGRAMMAZIONE LINEARE
-     * ======================================================== */
-    glp_prob *lp = glp_create_prob();
-    glp_set_prob_name(lp, "heating_schedule");
-    glp_set_obj_dir(lp, GLP_MAX); // Massimizzazione
-
-    /* ========================================================
-     * DEFINIZIONE DELLE VARIABILI DECISIONALI x_i
-     * ======================================================== */
-    glp_add_cols(lp, n);
+    s->ind    = (int*)malloc((size_t)(n + 1) * sizeof(int));
+    s->val    = (double*)malloc((size_t)(n + 1) * sizeof(double));
+    s->coef   = (double*)malloc((size_t)n * sizeof(double));
+    s->zaino  = plz_crea(n);
+    s->rapido = 1;
+    if (!s->ind || !s->val || !s->coef || !s->zaino) {
+        free(s->ind);
+        free(s->val);
+        free(s->coef);
+        plz_free(s->zaino);
+        free(s);
+        return NULL;
+    }
+
+    s->n = n;
+    s->lp = glp_create_prob();
+    glp_set_prob_name(s->lp, "heating_schedule");
+    glp_set_obj_dir(s->lp, GLP_MAX); // Massimizzazione
+
+    /* Variabili decisionali x_i: continue, 0 ≤ x_i ≤ 1 */
+    glp_add_cols(s->lp, n);
     for (int i = 1; i <= n; i++) {
+        glp_set_col_bnds(s->lp, i, GLP_DB, 0.0, 1.0);
+        glp_set_col_kind(s->lp, i, GLP_CV);
+    }
+
+    /* Riga 1: budget energetico, riga 2: rischio massimo */
+    glp_add_rows(s->lp, 2);
+
+    for (int i = 0; i < n; i++)
+        s->ind[i+1] = i + 1;
+
+    /* Disattivazione output del simplex; niente presolve,
+     * che scarterebbe la base precedente */
+    glp_init_smcp(&s->parm);
+    s->parm.msg_lev = GLP_MSG_OFF;
+    s->parm.presolve = GLP_OFF;
+
+    /* Base iniziale: tutte le x_i al limite inferiore */
+    glp_std_basis(s->lp);
 
-        /* Vincolo sulle variabili: 0 ≤ x_i ≤ 1 */
-        glp_set_col_bnds(lp, i, GLP_DB, 0.0, 1.0);
+    return s;
+}
+
+void pl_free(PL_Scheduler *s) {
+    if (!s) return;
+    glp_delete_prob(s->lp);
+    free(s->ind);
+    free(s->val);
+    free(s->coef);
+    plz_free(s->zaino);
+    free(s);
+}
+
+void pl_imposta_rapido(PL_Scheduler *s, int attivo) {
+    s->rapido = attivo ? 1 : 0;
+}
+
+void pl_reimposta_base(PL_Scheduler *s) {
+    glp_std_basis(s->lp);
+}
+
+void pl_statistiche(const PL_Scheduler *s, PL_Statistiche *st) {
+    *st = s->stat;
+}
+
+/* ============================================================
+ * RISOLUZIONE CON WARM START
+ * ============================================================ */
+int pl_risolvi(PL_Scheduler *s,
+               const double occ_prob[],
+               const double price[],
+               const double comfort_gain[],
+               const double risk_coeff[],
+               double budget,
+               double risk_max,
+               PL_Risultato *res) {
 
-        /* Variabile continua */
-        glp_set_col_kind(lp, i, GLP_CV);
+    const int n = s->n;
+    glp_prob *lp = s->lp;
 
-        /* Coefficiente della funzione obiettivo:
-         * utilità attesa - costo */
-        double coef = occ_prob[i-1] * comfort_gain[i-1] - price[i-1];
-        glp_set_obj_coef(lp, i, coef);
+    if (res->n != n || !res->power) return -1;
+
+    const double t0 = orologio_secondi();
+    const int it0 = glp_get_it_cnt(lp);
+
+    /* Coefficienti dell'obiettivo: utilità attesa - costo */
+    for (int i = 0; i < n; i++)
+        s->coef[i] = occ_prob[i] * comfort_gain[i] - price[i];
+
+    /* ---------- Percorso rapido ----------
+     * Accettato solo con ottimo certificato; il problema GLPK
+     * non viene toccato e conserva l'ultima base. */
+    if (s->rapido &&
+        plz_risolvi(s->zaino, n, s->coef, price, budget,
+                    risk_coeff, risk_max, res->power, NULL) == 0) {
+        s->stat.iterazioni = 0;
+        s->stat.tempo      = orologio_secondi() - t0;
+        s->stat.esito      = 0;
+        s->stat.rapido     = 1;
+        s->stat.n_risoluzioni++;
+        s->stat.n_rapide++;
+        s->stat.tempo_totale += s->stat.tempo;
+
+        MET_CONTA(PL_RISOLUZIONI, 1);
+        MET_CONTA(PL_RAPIDE, 1);
+        MET_DURATA(PL_RISOLVI, s->stat.tempo);
+        return 0;
     }
 
-    /* ========================================================
-     * DEFINIZIONE DEI VINCOLI
-     * ======================================================== */
-    glp_add_rows(lp, 2);
+    /* ---------- Aggiornamento sul posto dei dati ----------
+     * Gli stati di base di righe e colonne non vengono toccati:
+     * il simplex riparte dalla base ottima precedente. */
+
+    for (int i = 1; i <= n; i++)
+        glp_set_obj_coef(lp, i, s->coef[i-1]);
 
-    /* Vincolo 1: budget energetico */
+    /* Vincolo di budget: Σ x_i * price[i] ≤ budget */
     glp_set_row_bnds(lp, 1, GLP_UP, 0.0, budget);
+    for (int i = 0; i < n; i++)
+        s->val[i+1] = price[i];
+    glp_set_mat_row(lp, 1, n, s->ind, s->val);
 
-    /* Vincolo 2: rischio massimo */
+    /* Vincolo di rischio: Σ x_i * risk_coeff[i] ≤ risk_max */
     glp_set_row_bnds(lp, 2, GLP_UP, 0.0, risk_max);
+    for (int i = 0; i < n; i++)
+        s->val[i+1] = risk_coeff[i];
+    glp_set_mat_row(lp, 2, n, s->ind, s->val);
 
-    int ind[MAX_SLOTS + 1];
-    double val[MAX_SLOTS + 1];
-
-    /* --- Vincolo di budget: Σ x_i * price[i] ≤ budget --- */
-    for (int i = 0; i < n; i++) {
-        ind[i+1] = i + 1;
-        val[i+1] = price[i];
+    /* ---------- Risoluzione ----------
+     * Se la base precedente è diventata singolare con i nuovi
+     * coefficienti si riparte dalla base standard. */
+    int ret = glp_simplex(lp, &s->parm);
+    if (ret == GLP_EBADB || ret == GLP_ESING || ret == GLP_ECOND) {
+        MET_CONTA(PL_RIPARTENZE, 1);
+        glp_std_basis(lp);
+        ret = glp_simplex(lp, &s->parm);
     }
-    glp_set_mat_row(lp, 1, n, ind, val);
 
-    /* --- Vincolo di rischio: Σ x_i * risk_coeff[i] ≤ risk_max --- */
+    const int esito = (ret == 0 && glp_get_status(lp) == GLP_OPT) ? 0 : -1;
+
+    /* ---------- Estrazione della soluzione ---------- */
     for (int i = 0; i < n; i++) {
-        ind[i+1] = i + 1;
-        val[i+1] = risk_coeff[i];
+        double x = glp_get_col_prim(lp, i + 1);
+        res->power[i] = (x > 0.0) ? x : 0.0;
     }
-    glp_set_mat_row(lp, 2, n, ind, val);
 
-    /* ========================================================
-     * RISOLUZIONE DEL PROBLEMA
-     * ======================================================== */
-    glp_smcp parm;
-    glp_init_smcp(&parm);
+    /* ---------- Statistiche ---------- */
+    s->stat.iterazioni = glp_get_it_cnt(lp) - it0;
+    s->stat.tempo      = orologio_secondi() - t0;
+    s->stat.esito      = esito;
+    s->stat.rapido     = 0;
+    s->stat.n_risoluzioni++;
+    s->stat.iterazioni_totali += s->stat.iterazioni;
+    s->stat.tempo_totale      += s->stat.tempo;
+
+    /* Errore di glp_simplex, oppure terminato senza ottimo */
+    MET_CONTA(PL_RISOLUZIONI, 1);
+    MET_CONTA(PL_ITERAZIONI, s->stat.iterazioni);
+    MET_CONTA(PL_ERRORI_SIMPLEX, ret != 0);
+    MET_CONTA(PL_NON_OTTIME, ret == 0 && esito != 0);
+    MET_DURATA(PL_RISOLVI, s->stat.tempo);
 
-    /* Disattivazione output del simplex */
-    parm.msg_lev = GLP_MSG_OFF;
+    return esito;
+}
 
-    glp_simplex(lp, &parm);
+/*
+ * ============================================================
+ * FUNZIONE calcolarePianoOttimale
+ *
+ * Risoluzione singola tramite un pianificatore temporaneo
+ * ============================================================
+ */
+PL_Risultato calcolarePianoOttimale(
+    const double occ_prob[],     // Probabilità di occupazione per slot
+    const double price[],        // Prezzo dell’energia per slot
+    const double comfort_gain[], // Utilità attesa per unità di potenza
+    const double risk_coeff[],   // Coefficiente di rischio
+    int n,                       // Numero di slot
+    double budget,               // Budget massimo consentito
+    double risk_max              // Rischio massimo accettabile
+){
+    /* Struttura che conterrà il risultato finale,
+     * inizializzata con potenza nulla per tutti gli slot */
+    PL_Risultato res;
+    if (pl_risultato_init(&res, n) != 0) return res;
 
-    /* ========================================================
-     * ESTRAZIONE DELLA SOLUZIONE OTTIMA
-     * ======================================================== */
-    for (int i = 0; i < n; i++) {
-        double x = glp_get_col_prim(lp, i + 1);
-        res.power[i] = (x > 0.0) ? x : 0.0;
-    }
+    /* Caso limite: nessuno slot */
+    PL_Scheduler *s = pl_crea(n);
+    if (!s) return res;
 
-    /* Pulizia memoria */
-    glp_delete_prob(lp);
+    pl_risolvi(s, occ_prob, price, comfort_gain, risk_coeff,
+               budget, risk_max, &res);
 
+    pl_free(s);
     return res;
 }
@@ -14,9 +14,6 @@
  * e rischio.
  */
 
-/* Numero massimo di slot gestibili dal pianificatore */
-#define MAX_SLOTS 10
-
 /* ============================================================
  * STRUTTURA RISULTATO DELLA PL
  *
@@ -24,12 +21,104 @@
  * riscaldamento assegnato allo slot i-esimo.
  *
  * n indica il numero effettivo di slot utilizzati.
+ * L'array power è allocato su heap con n elementi: va
+ * creato con pl_risultato_init e liberato con
+ * pl_risultato_libera.
  * ============================================================ */
 typedef struct {
-    double power[MAX_SLOTS]; // livello di riscaldamento (0 = spento, 1 = massimo)
+    double *power;           // livello di riscaldamento (0 = spento, 1 = massimo), [n]
     int n;                   // numero di slot considerati
 } PL_Risultato;
 
+/*
+ * Alloca un risultato per n slot con potenze nulle.
+ * Ritorna 0 se ok, -1 se manca memoria (res resta vuoto).
+ */
+int pl_risultato_init(PL_Risultato *res, int n);
+
+/*
+ * Libera l'array delle potenze (res resta vuoto e riusabile)
+ */
+void pl_risultato_libera(PL_Risultato *res);
+
+/* ============================================================
+ * PIANIFICATORE PERSISTENTE
+ *
+ * Il problema di PL viene costruito una sola volta per un
+ * numero fisso di slot. Ogni risoluzione aggiorna sul posto
+ * obiettivo, coefficienti dei vincoli e termini noti, poi
+ * riparte dalla base ottima della risoluzione precedente
+ * (warm start): quando cambiano solo prezzi e probabilità
+ * bastano di norma pochi pivot.
+ * ============================================================ */
+typedef struct PL_Scheduler PL_Scheduler;
+
+/* Statistiche di risoluzione */
+typedef struct {
+    int    iterazioni;          // pivot del simplex nell'ultima risoluzione
+    double tempo;               // secondi dell'ultima risoluzione
+    int    esito;               // 0 = ottimo trovato, -1 altrimenti
+    int    rapido;              // 1 = risolta dal percorso rapido
+
+    long   n_risoluzioni;       // risoluzioni dalla creazione
+    long   n_rapide;            //   di cui senza simplex
+    long   iterazioni_totali;
+    double tempo_totale;
+} PL_Statistiche;
+
+/*
+ * Crea il pianificatore per n slot (n ≥ 1).
+ * Ritorna NULL in caso di errore.
+ */
+PL_Scheduler *pl_crea(int n);
+
+/*
+ * Libera il pianificatore e il problema GLPK associato
+ */
+void pl_free(PL_Scheduler *s);
+
+/*
+ * Aggiorna i dati e risolve il problema (stessa formulazione
+ * e stessi significati di calcolarePianoOttimale), ripartendo
+ * dalla base ottima precedente.
+ *
+ * Gli array di input hanno n elementi; res deve essere
+ * stato creato con pl_risultato_init per lo stesso n.
+ *
+ * Ritorna 0 se è stato trovato l'ottimo, -1 altrimenti
+ * (in res resta la soluzione corrente di GLPK).
+ */
+int pl_risolvi(
+    PL_Scheduler *s,
+    const double occ_prob[],
+    const double price[],
+    const double comfort_gain[],
+    const double risk_coeff[],
+    double budget,
+    double risk_max,
+    PL_Risultato *res
+);
+
+/*
+ * Attiva (default) o disattiva il percorso rapido: con
+ * coefficienti non negativi il problema è uno zaino
+ * frazionario a due vincoli, risolto senza simplex quando
+ * l'ottimo è certificato dal duale lagrangiano (PL_Zaino).
+ * Se il certificato fallisce si usa comunque GLPK.
+ */
+void pl_imposta_rapido(PL_Scheduler *s, int attivo);
+
+/*
+ * Scarta la base corrente: la prossima risoluzione parte
+ * dalla base standard (a freddo, come un problema nuovo)
+ */
+void pl_reimposta_base(PL_Scheduler *s);
+
+/*
+ * Statistiche dell'ultima risoluzione e cumulative
+ */
+void pl_statistiche(const PL_Scheduler *s, PL_Statistiche *st);
+
 /* ============================================================
  * FUNZIONE DI OTTIMIZZAZIONE
  *
@@ -48,6 +137,11 @@ typedef struct {
  *
  * OUTPUT:
  *  - struttura PL_Risultato con le potenze ottimali
+ *    (da liberare con pl_risultato_libera)
+ *
+ * Risoluzione singola: crea un pianificatore, lo usa una
+ * volta e lo distrugge. Per risoluzioni ripetute usare
+ * pl_crea / pl_risolvi.
  * ============================================================ */
 PL_Risultato calcolarePianoOttimale(
     const double occ_prob[],     // P(slot occupato)
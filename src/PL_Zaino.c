@@ -0,0 +1,319 @@
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "PL_Zaino.h"
+
+#define PLZ_MAX_ITER    100     // Passi massimi della ricerca su μ
+#define PLZ_TOLLERANZA  1e-9    // Gap e ammissibilità relativi
+
+struct PL_Zaino {
+
+    int capacita;       // Numero massimo di variabili
+
+    double *rho;        // Rapporto costo ridotto / peso, [capacita]
+    int *idx;           // Candidati della selezione, [capacita]
+    double *x_lo;       // Soluzione lagrangiana all'estremo sinistro
+    double *x_hi;       //   e destro dell'intervallo su μ
+    double *x_mid;      //   e al punto di prova
+};
+
+/* Soluzione del problema lagrangiano per un μ fissato */
+typedef struct {
+    double mu;
+    double lambda;
+    double ax, rx, cx;  // Σ a_i x_i, Σ r_i x_i, Σ c_i x_i
+    double g;           // Valore del duale g(λ, μ)
+} PLZ_Punto;
+
+/* ============================================================
+ * CREAZIONE E DISTRUZIONE
+ * ============================================================ */
+
+PL_Zaino *plz_crea(int n) {
+    if (n <= 0) return NULL;
+
+    PL_Zaino *z = (PL_Zaino*)calloc(1, sizeof(PL_Zaino));
+    if (!z) return NULL;
+
+    z->capacita = n;
+    z->rho   = (double*)malloc((size_t)n * sizeof(double));
+    z->idx   = (int*)malloc((size_t)n * sizeof(int));
+    z->x_lo  = (double*)malloc((size_t)n * sizeof(double));
+    z->x_hi  = (double*)malloc((size_t)n * sizeof(double));
+    z->x_mid = (double*)malloc((size_t)n * sizeof(double));
+
+    if (!z->rho || !z->idx || !z->x_lo || !z->x_hi || !z->x_mid) {
+        plz_free(z);
+        return NULL;
+    }
+
+    return z;
+}
+
+void plz_free(PL_Zaino *z) {
+    if (!z) return;
+    free(z->rho);
+    free(z->idx);
+    free(z->x_lo);
+    free(z->x_hi);
+    free(z->x_mid);
+    free(z);
+}
+
+/* ============================================================
+ * ZAINO A UN VINCOLO: SELEZIONE PESATA IN O(n)
+ * ============================================================ */
+
+static inline void scambia(int *v, int i, int j) {
+    int t = v[i];
+    v[i] = v[j];
+    v[j] = t;
+}
+
+static inline double mediana3(double a, double b, double c) {
+    if (a < b) {
+        if (b < c) return b;
+        return (a < c) ? c : a;
+    }
+    if (a < c) return a;
+    return (b < c) ? c : b;
+}
+
+/*
+ * Trova il rapporto critico λ: i candidati con rho > λ entrano
+ * per intero, quelli con rho == λ per la frazione *theta, gli
+ * altri restano fuori; il peso selezionato vale esattamente
+ * 'cap'. Richiede Σ a[idx[k]] > cap.
+ *
+ * Quickselect a tre vie sui rapporti (ordine decrescente),
+ * guidato dal peso cumulato invece che dalla posizione:
+ * tempo atteso lineare, nessun ordinamento completo.
+ */
+static double plz_rapporto_critico(int *idx, int m,
+                                   const double *rho, const double *a,
+                                   double cap, double *theta) {
+    int lo = 0, hi = m;
+
+    while (lo < hi) {
+        const double p = mediana3(rho[idx[lo]],
+                                  rho[idx[lo + (hi - lo) / 2]],
+                                  rho[idx[hi - 1]]);
+
+        /* Partizione: [lo, gt) > p | [gt, i) == p | [lt, hi) < p */
+        int gt = lo, i = lo, lt = hi;
+        while (i < lt) {
+            const double v = rho[idx[i]];
+            if (v > p)      scambia(idx, gt++, i++);
+            else if (v < p) scambia(idx, i, --lt);
+            else            i++;
+        }
+
+        double w_gt = 0.0, w_eq = 0.0;
+        for (int k = lo; k < gt; k++) w_gt += a[idx[k]];
+        for (int k = gt; k < lt; k++) w_eq += a[idx[k]];
+
+        /* Il rapporto critico è tra quelli maggiori di p */
+        if (w_gt > cap) {
+            hi = gt;
+            continue;
+        }
+
+        cap -= w_gt;
+
+        /* Il rapporto critico è p: i pari merito si dividono
+         * la capacità residua */
+        if (w_eq >= cap) {
+            *theta = cap / w_eq;
+            return p;
+        }
+
+        /* Tutti i candidati >= p entrano: si prosegue sui minori */
+        cap -= w_eq;
+        lo = lt;
+    }
+
+    /* Non raggiungibile se Σ a > cap */
+    *theta = 1.0;
+    return 0.0;
+}
+
+/*
+ * Risolve il lagrangiano per μ fissato:
+ *   max Σ (c_i - μ r_i) x_i   s.t. Σ a_i x_i ≤ B, 0 ≤ x ≤ 1
+ * e ne calcola i riepiloghi e il valore duale.
+ */
+static void plz_interno(PL_Zaino *z, int n,
+                        const double *c, const double *a, double B,
+                        const double *r, double R,
+                        double mu, double *x, PLZ_Punto *p) {
+    int m = 0;
+    double peso = 0.0;
+
+    for (int i = 0; i < n; i++) {
+        const double d = c[i] - mu * r[i];
+        if (d <= 0.0) {
+            x[i] = 0.0;
+        } else if (a[i] == 0.0) {
+            x[i] = 1.0;             // Guadagno senza costo di budget
+        } else {
+            x[i] = 1.0;
+            z->rho[i] = d / a[i];
+            z->idx[m++] = i;
+            peso += a[i];
+        }
+    }
+
+    double lambda = 0.0;
+
+    /* Budget non sufficiente per tutti i candidati */
+    if (peso > B) {
+        double theta;
+        lambda = plz_rapporto_critico(z->idx, m, z->rho, a, B, &theta);
+
+        for (int k = 0; k < m; k++) {
+            const int i = z->idx[k];
+            x[i] = (z->rho[i] > lambda) ? 1.0
+                 : (z->rho[i] == lambda) ? theta : 0.0;
+        }
+    }
+
+    /* Riepiloghi e valore duale */
+    double ax = 0.0, rx = 0.0, cx = 0.0, g = 0.0;
+    for (int i = 0; i < n; i++) {
+        ax += a[i] * x[i];
+        rx += r[i] * x[i];
+        cx += c[i] * x[i];
+        const double d = c[i] - lambda * a[i] - mu * r[i];
+        if (d > 0.0) g += d;
+    }
+
+    p->mu = mu;
+    p->lambda = lambda;
+    p->ax = ax;
+    p->rx = rx;
+    p->cx = cx;
+    p->g  = g + lambda * B + mu * R;
+}
+
+/* ============================================================
+ * CERTIFICATO DI OTTIMALITÀ
+ * ============================================================ */
+
+/*
+ * Verifica indipendente dall'algoritmo: x deve rispettare
+ * limiti e vincoli, e il suo valore deve distare dal duale
+ * g(λ, μ) (un maggiorante dell'ottimo) meno della tolleranza.
+ */
+static int plz_certifica(int n,
+                         const double *c, const double *a, double B,
+                         const double *r, double R,
+                         const double *x, double lambda, double mu,
+                         double *gap) {
+    double ax = 0.0, rx = 0.0, cx = 0.0, g = 0.0;
+
+    for (int i = 0; i < n; i++) {
+        if (!(x[i] >= 0.0 && x[i] <= 1.0)) return -1;
+        ax += a[i] * x[i];
+        rx += r[i] * x[i];
+        cx += c[i] * x[i];
+        const double d = c[i] - lambda * a[i] - mu * r[i];
+        if (d > 0.0) g += d;
+    }
+    g += lambda * B + mu * R;
+
+    if (ax > B + PLZ_TOLLERANZA * fmax(1.0, B) ||
+        rx > R + PLZ_TOLLERANZA * fmax(1.0, R))
+        return -1;
+
+    const double scarto = g - cx;
+    if (gap) *gap = scarto;
+
+    return (scarto <= PLZ_TOLLERANZA * fmax(1.0, fabs(cx))) ? 0 : -1;
+}
+
+/* ============================================================
+ * RISOLUZIONE
+ * ============================================================ */
+
+int plz_risolvi(PL_Zaino *z, int n,
+                const double c[], const double a[], double B,
+                const double r[], double R,
+                double x[], double *gap) {
+
+    if (n <= 0 || n > z->capacita) return -1;
+
+    /* ---------- Struttura supportata ---------- */
+    if (!(B >= 0.0) || !(R >= 0.0) || !isfinite(B) || !isfinite(R))
+        return -1;
+    for (int i = 0; i < n; i++)
+        if (!isfinite(c[i]) || !isfinite(a[i]) || !isfinite(r[i]) ||
+            a[i] < 0.0 || r[i] < 0.0)
+            return -1;
+
+    /* ---------- μ = 0: il rischio non è attivo ---------- */
+    PLZ_Punto lo, hi, mid;
+    plz_interno(z, n, c, a, B, r, R, 0.0, z->x_lo, &lo);
+
+    if (lo.rx <= R) {
+        memcpy(x, z->x_lo, (size_t)n * sizeof(double));
+        return plz_certifica(n, c, a, B, r, R, x, lo.lambda, 0.0, gap);
+    }
+
+    /* ---------- Intervallo iniziale su μ ----------
+     * Oltre max(c_i / r_i) nessuna variabile con r_i > 0 ha
+     * costo ridotto positivo: Σ r_i x_i = 0 ≤ R. */
+    double mu_max = 0.0;
+    for (int i = 0; i < n; i++)
+        if (r[i] > 0.0 && c[i] > 0.0 && c[i] / r[i] > mu_max)
+            mu_max = c[i] / r[i];
+
+    plz_interno(z, n, c, a, B, r, R, mu_max * (1.0 + 1e-9), z->x_hi, &hi);
+
+    /* ---------- Ricerca su μ ----------
+     * Invarianti: lo.rx > R (subgradiente negativo),
+     * hi.rx ≤ R (subgradiente non negativo). La combinazione
+     * convessa di x_lo e x_hi che satura il rischio è
+     * ammissibile; il duale migliore tra i due estremi ne
+     * maggiora l'ottimo. */
+    double theta = 1.0;
+
+    for (int it = 0; it < PLZ_MAX_ITER; it++) {
+        theta = (R - hi.rx) / (lo.rx - hi.rx);
+
+        const double primale = theta * lo.cx + (1.0 - theta) * hi.cx;
+        const double duale = fmin(lo.g, hi.g);
+        if (duale - primale <= PLZ_TOLLERANZA * fmax(1.0, fabs(primale)))
+            break;
+
+        /* Punto d'incontro delle tangenti a h(μ) nei due estremi
+         * (esatto su un tratto lineare); bisezione se cade
+         * troppo vicino a un estremo */
+        const double s_lo = R - lo.rx, s_hi = R - hi.rx;
+        const double ampiezza = hi.mu - lo.mu;
+        double mu = (hi.g - lo.g + s_lo * lo.mu - s_hi * hi.mu) / (s_lo - s_hi);
+
+        if (!(mu > lo.mu + 1e-3 * ampiezza && mu < hi.mu - 1e-3 * ampiezza))
+            mu = lo.mu + 0.5 * ampiezza;
+        if (!(mu > lo.mu && mu < hi.mu))
+            break;          // Intervallo esaurito
+
+        plz_interno(z, n, c, a, B, r, R, mu, z->x_mid, &mid);
+
+        double *t;
+        if (mid.rx > R) {
+            lo = mid;
+            t = z->x_lo; z->x_lo = z->x_mid; z->x_mid = t;
+        } else {
+            hi = mid;
+            t = z->x_hi; z->x_hi = z->x_mid; z->x_mid = t;
+        }
+    }
+
+    theta = (R - hi.rx) / (lo.rx - hi.rx);
+    for (int i = 0; i < n; i++)
+        x[i] = fmin(1.0, theta * z->x_lo[i] + (1.0 - theta) * z->x_hi[i]);
+
+    /* Certificato con il migliore dei due duali */
+    const PLZ_Punto *d = (lo.g <= hi.g) ? &lo : &hi;
+    return plz_certifica(n, c, a, B, r, R, x, d->lambda, d->mu, gap);
+}
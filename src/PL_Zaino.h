@@ -0,0 +1,67 @@
+#ifndef PL_ZAINO_H
+#define PL_ZAINO_H
+
+/* ============================================================
+ *        ZAINO CONTINUO A DUE VINCOLI (PERCORSO RAPIDO)
+ * ============================================================
+ *
+ * Il problema del pianificatore ha solo variabili limitate
+ * 0 ≤ x_i ≤ 1 e due vincoli ≤ a coefficienti non negativi:
+ *
+ *   max  Σ c_i x_i
+ *   s.t. Σ a_i x_i ≤ B     (budget)
+ *        Σ r_i x_i ≤ R     (rischio)
+ *
+ * cioè uno zaino frazionario a due vincoli. Si risolve senza
+ * simplex con il duale lagrangiano:
+ *
+ *   g(λ, μ) = Σ max(0, c_i - λ a_i - μ r_i) + λ B + μ R
+ *
+ *  - per μ fissato il minimo su λ è uno zaino a un vincolo,
+ *    risolto in O(n) con una selezione pesata sui rapporti
+ *  - su μ la funzione è convessa: ricerca monodimensionale
+ *    sul segno del subgradiente R - Σ r_i x_i(μ)
+ *
+ * Se uno dei vincoli non è attivo basta il primo passo
+ * (μ = 0) o non serve nemmeno la selezione.
+ *
+ * CERTIFICATO: la soluzione è accettata solo se è ammissibile
+ * e il gap con il duale g(λ, μ) (che per dualità debole
+ * maggiora l'ottimo) è entro la tolleranza. Altrimenti il
+ * chiamante deve ricorrere al simplex.
+ */
+
+typedef struct PL_Zaino PL_Zaino;
+
+/*
+ * Crea il risolutore con i buffer per n variabili
+ */
+PL_Zaino *plz_crea(int n);
+
+void plz_free(PL_Zaino *z);
+
+/*
+ * Risolve il problema su n variabili (n ≤ capacità di z).
+ *
+ * x   : soluzione, [n]
+ * gap : se non NULL, gap duale certificato
+ *
+ * Ritorna:
+ *   0  ottimo certificato
+ *  -1  struttura non supportata (coefficienti negativi o
+ *      non finiti, termini noti negativi) o certificato
+ *      fallito: x non è affidabile
+ */
+int plz_risolvi(
+    PL_Zaino *z,
+    int n,
+    const double c[],
+    const double a[],
+    double B,
+    const double r[],
+    double R,
+    double x[],
+    double *gap
+);
+
+#endif
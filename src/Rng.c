@@ -0,0 +1,77 @@
+#include "Rng.h"
+
+static inline uint64_t ruota(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+/* ============================================================
+ * INIZIALIZZAZIONE
+ * ============================================================ */
+
+/*
+ * SplitMix64: genera le quattro parole dello stato.
+ * Non può produrre lo stato tutto nullo, l'unico
+ * vietato per xoshiro.
+ */
+static uint64_t splitmix64(uint64_t *x) {
+    uint64_t z = (*x += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+void rng_inizializza(Rng *r, uint64_t seme) {
+    for (int i = 0; i < 4; i++)
+        r->s[i] = splitmix64(&seme);
+}
+
+/* ============================================================
+ * GENERAZIONE
+ * ============================================================ */
+
+uint64_t rng_u64(Rng *r) {
+    uint64_t *s = r->s;
+    const uint64_t risultato = ruota(s[1] * 5, 7) * 9;
+    const uint64_t t = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = ruota(s[3], 45);
+
+    return risultato;
+}
+
+double rng_uniforme(Rng *r) {
+    return (double)(rng_u64(r) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/*
+ * Metodo di Lemire: moltiplicazione a 64 bit e rigetto
+ * della sola frazione di valori che introdurrebbe bias.
+ */
+uint32_t rng_intervallo(Rng *r, uint32_t n) {
+    uint64_t m = (rng_u64(r) >> 32) * (uint64_t)n;
+    uint32_t basso = (uint32_t)m;
+
+    if (basso < n) {
+        const uint32_t soglia = (uint32_t)(-n) % n;
+        while (basso < soglia) {
+            m = (rng_u64(r) >> 32) * (uint64_t)n;
+            basso = (uint32_t)m;
+        }
+    }
+
+    return (uint32_t)(m >> 32);
+}
+
+void rng_mescola(Rng *r, int *v, int n) {
+    for (int i = n - 1; i > 0; i--) {
+        int j = (int)rng_intervallo(r, (uint32_t)i + 1);
+        int t = v[i];
+        v[i] = v[j];
+        v[j] = t;
+    }
+}
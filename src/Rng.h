@@ -0,0 +1,51 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include <stdint.h>
+
+/* ============================================================
+ *          GENERATORE PSEUDO-CASUALE PER MODELLO
+ * ============================================================
+ *
+ * xoshiro256** (Blackman, Vigna): 256 bit di stato, periodo
+ * 2^256 - 1, veloce e di buona qualità statistica.
+ *
+ * Ogni generatore è una struttura posseduta dal chiamante,
+ * senza stato globale: modelli diversi (o thread diversi)
+ * producono sequenze indipendenti e riproducibili a partire
+ * dal proprio seme.
+ */
+
+typedef struct {
+    uint64_t s[4];
+} Rng;
+
+/*
+ * Inizializza lo stato a partire da un seme a 64 bit.
+ * Lo stato viene espanso con SplitMix64, quindi anche semi
+ * piccoli o consecutivi danno sequenze ben separate.
+ */
+void rng_inizializza(Rng *r, uint64_t seme);
+
+/*
+ * Prossimo valore a 64 bit
+ */
+uint64_t rng_u64(Rng *r);
+
+/*
+ * Uniforme in [0, 1) con 53 bit di mantissa
+ */
+double rng_uniforme(Rng *r);
+
+/*
+ * Intero uniforme in [0, n), senza distorsione modulo.
+ * n deve essere maggiore di zero.
+ */
+uint32_t rng_intervallo(Rng *r, uint32_t n);
+
+/*
+ * Permutazione casuale sul posto di v[0..n) (Fisher–Yates)
+ */
+void rng_mescola(Rng *r, int *v, int n);
+
+#endif
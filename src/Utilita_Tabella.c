@@ -0,0 +1,462 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <stdatomic.h>
+#include "Incertezza.h"
+#include "Utilita_Tabella.h"
+
+/* ============================================================
+ * TABELLA COMPILATA
+ * ============================================================
+ *
+ * Ogni condizione diventa una soglia della forma "x >= s":
+ *
+ *   x <  c  ⇔  non (x >= c)
+ *   x >= c  ⇔  x >= c
+ *   x >  c  ⇔  x >= c⁺        (c⁺ = double successivo a c)
+ *   x <= c  ⇔  non (x >= c⁺)
+ *
+ * Le soglie di ciascuna variabile sono ordinate e senza
+ * ripetizioni; l'indice di cella k è il numero di soglie
+ * superate, quindi la soglia j è superata ⇔ k > j.
+ *
+ * Una temperatura NaN non supera alcuna soglia ma rende falsa
+ * anche ogni condizione "<": ha una cella propria, k = n + 1,
+ * compilata con tutte le condizioni sulla variabile false
+ * (come la catena di confronti originale).
+ *
+ * u[(k_ti · (n_te + 2) + k_te) · UT_PASSO + stato]
+ */
+
+#define UT_PASSO 4      // Stati per cella, arrotondati per l'allineamento
+
+struct Utilita_Tabella {
+    int n_ti, n_te;
+    double soglie_ti[UT_MAX_SOGLIE];
+    double soglie_te[UT_MAX_SOGLIE];
+    double u[];
+};
+
+/* ============================================================
+ * VALORI PREDEFINITI
+ * ============================================================ */
+
+static const UT_Termine termini_predefiniti[] = {
+    /* AWAY: penalità se si spreca energia mantenendo
+     * una temperatura interna elevata */
+    { STATO_AWAY,  -0.5, 0.0, 1, { { UT_TI, UT_MAGGIORE, 16.0 } } },
+
+    /* HOME: comfort prioritario sotto la soglia, con
+     * bonus se fuori fa freddo */
+    { STATO_HOME,   1.2, 0.4, 1, { { UT_TI, UT_MINORE, 19.5 } } },
+    { STATO_HOME,   0.5, 0.0, 2, { { UT_TE, UT_MINORE, 8.0 },
+                                   { UT_TI, UT_MINORE, 20.0 } } },
+
+    /* SLEEP: penalità forte se la casa è troppo calda,
+     * minimo di tepore con freddo dentro e fuori */
+    { STATO_SLEEP, -2.5, 0.2, 1, { { UT_TI, UT_MAGGIORE_UGUALE, 19.5 } } },
+    { STATO_SLEEP,  0.3, 0.0, 2, { { UT_TE, UT_MINORE, 5.0 },
+                                   { UT_TI, UT_MINORE, 17.0 } } }
+};
+
+#define N_PREDEFINITI \
+    ((int)(sizeof(termini_predefiniti) / sizeof(termini_predefiniti[0])))
+
+/* ============================================================
+ * COMPILAZIONE
+ * ============================================================ */
+
+static double soglia_di(const UT_Condizione *c) {
+    return (c->op == UT_MAGGIORE || c->op == UT_MINORE_UGUALE)
+         ? nextafter(c->soglia, INFINITY)
+         : c->soglia;
+}
+
+static int confronta_double(const void *a, const void *b) {
+    const double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+/* Ordina e rimuove i duplicati, ritorna il numero di soglie */
+static int normalizza_soglie(double *s, int n) {
+    qsort(s, (size_t)n, sizeof(double), confronta_double);
+    int m = 0;
+    for (int j = 0; j < n; j++)
+        if (m == 0 || s[j] != s[m - 1])
+            s[m++] = s[j];
+    return m;
+}
+
+static int indice_soglia(const double *s, int n, double x) {
+    for (int j = 0; j < n; j++)
+        if (s[j] == x) return j;
+    return -1;
+}
+
+static int termine_valido(const UT_Termine *t) {
+    if (t->stato < 0 || t->stato >= N_STATI) return 0;
+    if (t->n_cond < 0 || t->n_cond > UT_MAX_CONDIZIONI) return 0;
+    if (!isfinite(t->se_vero) || !isfinite(t->se_falso)) return 0;
+
+    for (int c = 0; c < t->n_cond; c++) {
+        const UT_Condizione *cd = &t->cond[c];
+        if (cd->var != UT_TI && cd->var != UT_TE) return 0;
+        if (cd->op < UT_MINORE || cd->op > UT_MAGGIORE_UGUALE) return 0;
+        if (!isfinite(cd->soglia)) return 0;
+    }
+    return 1;
+}
+
+Utilita_Tabella *ut_compila(const UT_Termine termini[], int n) {
+    if (n < 0 || n > UT_MAX_TERMINI) return NULL;
+
+    /* ---------- Raccolta delle soglie ---------- */
+    double s_ti[UT_MAX_TERMINI * UT_MAX_CONDIZIONI];
+    double s_te[UT_MAX_TERMINI * UT_MAX_CONDIZIONI];
+    int n_ti = 0, n_te = 0;
+
+    for (int i = 0; i < n; i++) {
+        if (!termine_valido(&termini[i])) return NULL;
+        for (int c = 0; c < termini[i].n_cond; c++) {
+            const UT_Condizione *cd = &termini[i].cond[c];
+            if (cd->var == UT_TI) s_ti[n_ti++] = soglia_di(cd);
+            else                  s_te[n_te++] = soglia_di(cd);
+        }
+    }
+
+    n_ti = normalizza_soglie(s_ti, n_ti);
+    n_te = normalizza_soglie(s_te, n_te);
+    if (n_ti > UT_MAX_SOGLIE || n_te > UT_MAX_SOGLIE) return NULL;
+
+    const size_t n_celle = (size_t)(n_ti + 2) * (n_te + 2);
+    Utilita_Tabella *t = (Utilita_Tabella*)malloc(
+        sizeof(Utilita_Tabella) + n_celle * UT_PASSO * sizeof(double));
+    if (!t) return NULL;
+
+    t->n_ti = n_ti;
+    t->n_te = n_te;
+    memcpy(t->soglie_ti, s_ti, (size_t)n_ti * sizeof(double));
+    memcpy(t->soglie_te, s_te, (size_t)n_te * sizeof(double));
+
+    /* ---------- Valori per cella ----------
+     * Stesso ordine di somma della valutazione termine per
+     * termine: u = ((0 + t1) + t2) + ... */
+    for (int k_ti = 0; k_ti <= n_ti + 1; k_ti++) {
+        for (int k_te = 0; k_te <= n_te + 1; k_te++) {
+            double *u = &t->u[((size_t)k_ti * (n_te + 2) + k_te) * UT_PASSO];
+            for (int s = 0; s < UT_PASSO; s++)
+                u[s] = 0.0;
+
+            for (int i = 0; i < n; i++) {
+                const UT_Termine *tm = &termini[i];
+                int vero = 1;
+
+                for (int c = 0; c < tm->n_cond; c++) {
+                    const UT_Condizione *cd = &tm->cond[c];
+                    const int nan = (cd->var == UT_TI) ? k_ti > n_ti
+                                                       : k_te > n_te;
+                    const int superata = (cd->var == UT_TI)
+                        ? k_ti > indice_soglia(s_ti, n_ti, soglia_di(cd))
+                        : k_te > indice_soglia(s_te, n_te, soglia_di(cd));
+                    const int verso = (cd->op == UT_MAGGIORE ||
+                                       cd->op == UT_MAGGIORE_UGUALE);
+                    if (nan || superata != verso) vero = 0;
+                }
+
+                u[tm->stato] += vero ? tm->se_vero : tm->se_falso;
+            }
+        }
+    }
+
+    return t;
+}
+
+Utilita_Tabella *ut_predefinita(void) {
+    return ut_compila(termini_predefiniti, N_PREDEFINITI);
+}
+
+void ut_free(Utilita_Tabella *t) {
+    free(t);
+}
+
+/* ============================================================
+ * FILE DI CONFIGURAZIONE
+ * ============================================================
+ *
+ *   # commento
+ *   away   -0.5  0.0  se ti > 16
+ *   home    0.5       se te < 8  e ti < 20
+ */
+
+#define UT_MAX_TOKEN 32
+
+typedef struct {
+    const char *testo[UT_MAX_TOKEN];
+    int colonna[UT_MAX_TOKEN];
+    int n;
+} Token;
+
+/* Divide la riga (modificandola) in token separati da spazi */
+static int dividi(char *riga, Token *tk) {
+    tk->n = 0;
+    char *p = riga;
+
+    for (;;) {
+        while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n') p++;
+        if (*p == '\0' || *p == '#') return 0;
+        if (tk->n == UT_MAX_TOKEN) return -1;
+
+        tk->testo[tk->n] = p;
+        tk->colonna[tk->n] = (int)(p - riga) + 1;
+        tk->n++;
+
+        while (*p && *p != ' ' && *p != '\t' && *p != '\r' &&
+               *p != '\n' && *p != '#') p++;
+        if (*p == '#') { *p = '\0'; return 0; }
+        if (*p) *p++ = '\0';
+    }
+}
+
+static int leggi_numero(const char *s, double *x) {
+    char *fine;
+    *x = strtod(s, &fine);
+    return fine != s && *fine == '\0' && isfinite(*x);
+}
+
+static int leggi_stato(const char *s) {
+    if (strcmp(s, "away") == 0)  return STATO_AWAY;
+    if (strcmp(s, "home") == 0)  return STATO_HOME;
+    if (strcmp(s, "sleep") == 0) return STATO_SLEEP;
+    return -1;
+}
+
+static int leggi_operatore(const char *s) {
+    if (strcmp(s, "<") == 0)  return UT_MINORE;
+    if (strcmp(s, "<=") == 0) return UT_MINORE_UGUALE;
+    if (strcmp(s, ">") == 0)  return UT_MAGGIORE;
+    if (strcmp(s, ">=") == 0) return UT_MAGGIORE_UGUALE;
+    return -1;
+}
+
+/*
+ * Analizza i token di una riga.
+ * Ritorna 0 se valida, -1 con indice del token e messaggio
+ * altrimenti.
+ */
+static int analizza_termine(const Token *tk, UT_Termine *t,
+                            int *errato, const char **errore) {
+    int i = 0;
+
+    memset(t, 0, sizeof(*t));
+
+    *errato = i;
+    if ((t->stato = leggi_stato(tk->testo[i])) < 0) {
+        *errore = "stato non valido (away, home, sleep)";
+        return -1;
+    }
+    i++;
+
+    *errato = i;
+    if (i >= tk->n || !leggi_numero(tk->testo[i], &t->se_vero)) {
+        *errore = "valore atteso";
+        return -1;
+    }
+    i++;
+
+    if (i < tk->n && strcmp(tk->testo[i], "se") != 0) {
+        *errato = i;
+        if (!leggi_numero(tk->testo[i], &t->se_falso)) {
+            *errore = "valore o 'se' atteso";
+            return -1;
+        }
+        i++;
+    }
+
+    if (i == tk->n) return 0;
+
+    /* se <cond> [e <cond>]... */
+    const char *legame = "se";
+    while (i < tk->n) {
+        *errato = i;
+        if (strcmp(tk->testo[i], legame) != 0) {
+            *errore = (legame[0] == 's') ? "'se' atteso" : "'e' atteso";
+            return -1;
+        }
+        legame = "e";
+        i++;
+
+        if (t->n_cond == UT_MAX_CONDIZIONI) {
+            *errore = "troppe condizioni";
+            return -1;
+        }
+        UT_Condizione *cd = &t->cond[t->n_cond];
+
+        *errato = i;
+        if (i >= tk->n || (strcmp(tk->testo[i], "ti") != 0 &&
+                           strcmp(tk->testo[i], "te") != 0)) {
+            *errore = "variabile attesa (ti, te)";
+            return -1;
+        }
+        cd->var = (tk->testo[i][1] == 'i') ? UT_TI : UT_TE;
+        i++;
+
+        *errato = i;
+        if (i >= tk->n || (cd->op = leggi_operatore(tk->testo[i])) < 0) {
+            *errore = "operatore atteso (<, <=, >, >=)";
+            return -1;
+        }
+        i++;
+
+        *errato = i;
+        if (i >= tk->n || !leggi_numero(tk->testo[i], &cd->soglia)) {
+            *errore = "soglia attesa";
+            return -1;
+        }
+        i++;
+
+        t->n_cond++;
+    }
+
+    return 0;
+}
+
+Utilita_Tabella *ut_carica(const char *path) {
+    FILE *f = fopen(path, "r");
+    if (!f) return NULL;
+
+    UT_Termine termini[UT_MAX_TERMINI];
+    int n = 0, errori = 0, num_riga = 0;
+    char buf[512];
+
+    while (fgets(buf, sizeof(buf), f)) {
+        num_riga++;
+
+        Token tk;
+        if (dividi(buf, &tk) != 0) {
+            fprintf(stderr, "%s:%d:1: troppi elementi\n", path, num_riga);
+            errori++;
+            continue;
+        }
+        if (tk.n == 0) continue;
+
+        if (n == UT_MAX_TERMINI) {
+            fprintf(stderr, "%s:%d:1: più di %d termini\n",
+                    path, num_riga, UT_MAX_TERMINI);
+            errori++;
+            break;
+        }
+
+        int errato;
+        const char *errore;
+        if (analizza_termine(&tk, &termini[n], &errato, &errore) != 0) {
+            const int col = (errato < tk.n)
+                ? tk.colonna[errato]
+                : tk.colonna[tk.n - 1] + (int)strlen(tk.testo[tk.n - 1]);
+            fprintf(stderr, "%s:%d:%d: %s\n", path, num_riga, col, errore);
+            errori++;
+            continue;
+        }
+        n++;
+    }
+
+    fclose(f);
+    if (errori) return NULL;
+
+    Utilita_Tabella *t = ut_compila(termini, n);
+    if (!t)
+        fprintf(stderr, "%s: più di %d soglie distinte per variabile\n",
+                path, UT_MAX_SOGLIE);
+    return t;
+}
+
+/* ============================================================
+ * VALUTAZIONE
+ * ============================================================
+ *
+ * Il conteggio delle soglie superate non ha salti dipendenti
+ * dai dati: il costo è lo stesso per ogni temperatura. La
+ * cella NaN è scelta con x != x, anch'essa senza salti.
+ */
+
+static inline const double *cella(const Utilita_Tabella *t,
+                                  double temp_int, double temp_ext) {
+    int k_ti = 0, k_te = 0;
+    for (int j = 0; j < t->n_ti; j++)
+        k_ti += (temp_int >= t->soglie_ti[j]);
+    for (int j = 0; j < t->n_te; j++)
+        k_te += (temp_ext >= t->soglie_te[j]);
+    k_ti = (temp_int != temp_int) ? t->n_ti + 1 : k_ti;
+    k_te = (temp_ext != temp_ext) ? t->n_te + 1 : k_te;
+    return &t->u[(k_ti * (t->n_te + 2) + k_te) * UT_PASSO];
+}
+
+double ut_utilita(const Utilita_Tabella *t, int stato,
+                  double temp_int, double temp_ext) {
+    if (stato < 0 || stato >= N_STATI) return 0.0;
+    return cella(t, temp_int, temp_ext)[stato];
+}
+
+double ut_utilita_attesa(const Utilita_Tabella *t, const double p[],
+                         double temp_int, double temp_ext) {
+    const double *u = cella(t, temp_int, temp_ext);
+    double eu = 0.0;
+    for (int s = 0; s < N_STATI; s++)
+        eu += p[s] * u[s];
+    return eu;
+}
+
+void ut_utilita_attesa_batch(
+    const Utilita_Tabella *t,
+    const double p_away[],
+    const double p_home[],
+    const double p_sleep[],
+    const double temp_int[],
+    const double temp_ext[],
+    int n,
+    double eu[]
+) {
+    for (int i = 0; i < n; i++) {
+        const double *u = cella(t, temp_int[i], temp_ext[i]);
+        double e = 0.0;
+        e += p_away[i]  * u[STATO_AWAY];
+        e += p_home[i]  * u[STATO_HOME];
+        e += p_sleep[i] * u[STATO_SLEEP];
+        eu[i] = e;
+    }
+}
+
+/* ============================================================
+ * TABELLA ATTIVA
+ * ============================================================
+ *
+ * Puntatore atomico: i lettori lo caricano una volta per
+ * valutazione (acquire) e vedono sempre una tabella completa.
+ * Al primo uso senza pubblicazioni viene installata la
+ * predefinita; se due thread la creano insieme, chi perde
+ * il confronto-scambio libera la propria copia.
+ */
+
+static _Atomic(Utilita_Tabella *) tabella_attiva = NULL;
+
+const Utilita_Tabella *ut_attiva(void) {
+    Utilita_Tabella *t = atomic_load_explicit(&tabella_attiva,
+                                              memory_order_acquire);
+    if (t) return t;
+
+    Utilita_Tabella *nuova = ut_predefinita();
+    if (!nuova) return NULL;
+
+    if (atomic_compare_exchange_strong_explicit(
+            &tabella_attiva, &t, nuova,
+            memory_order_acq_rel, memory_order_acquire))
+        return nuova;
+
+    ut_free(nuova);
+    return t;
+}
+
+Utilita_Tabella *ut_pubblica(Utilita_Tabella *t) {
+    return atomic_exchange_explicit(&tabella_attiva, t,
+                                    memory_order_acq_rel);
+}
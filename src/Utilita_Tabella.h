@@ -0,0 +1,120 @@
+#ifndef UTILITA_TABELLA_H
+#define UTILITA_TABELLA_H
+
+/* ============================================================
+ *            TABELLE DI UTILITÀ GUIDATE DAI DATI
+ * ============================================================
+ *
+ * La funzione di utilità U(s) è descritta da termini del tipo
+ *
+ *   stato  se_vero  [se_falso]  [se cond [e cond ...]]
+ *
+ * con cond = "ti|te  <|<=|>|>=  soglia" su temperatura interna
+ * (ti) ed esterna (te). U(s) è la somma, nell'ordine del file,
+ * dei termini dello stato: se_vero se tutte le condizioni sono
+ * vere, se_falso (predefinito 0) altrimenti.
+ *
+ * Alla compilazione le soglie dividono il piano (ti, te) in
+ * celle in cui U è costante; la tabella piatta contiene U per
+ * ogni cella e stato, e la valutazione si riduce a contare le
+ * soglie superate (senza salti) più una lettura.
+ *
+ * Una tabella compilata è immutabile: può essere letta da più
+ * thread e sostituita tra un tick e l'altro con ut_pubblica.
+ */
+
+#define UT_MAX_SOGLIE     15    // Soglie distinte per variabile
+#define UT_MAX_TERMINI    64
+#define UT_MAX_CONDIZIONI 4     // Condizioni per termine
+
+/* Variabili e operatori delle condizioni */
+enum { UT_TI, UT_TE };
+enum { UT_MINORE, UT_MINORE_UGUALE, UT_MAGGIORE, UT_MAGGIORE_UGUALE };
+
+typedef struct {
+    int var;                // UT_TI / UT_TE
+    int op;                 // UT_MINORE, ...
+    double soglia;
+} UT_Condizione;
+
+typedef struct {
+    int stato;              // STATO_AWAY / STATO_HOME / STATO_SLEEP
+    double se_vero;
+    double se_falso;
+    int n_cond;             // 0: termine sempre vero
+    UT_Condizione cond[UT_MAX_CONDIZIONI];
+} UT_Termine;
+
+typedef struct Utilita_Tabella Utilita_Tabella;
+
+/*
+ * Compila n termini in una tabella.
+ * Ritorna NULL se i termini non sono validi o la memoria
+ * non è sufficiente.
+ */
+Utilita_Tabella *ut_compila(const UT_Termine termini[], int n);
+
+/*
+ * Legge i termini da un file di configurazione e li compila.
+ * Righe vuote e commenti (#) sono ignorati; gli errori sono
+ * segnalati su stderr come file:riga:colonna.
+ *
+ * Ritorna NULL se il file non esiste o contiene errori.
+ */
+Utilita_Tabella *ut_carica(const char *path);
+
+/* Tabella con i valori predefiniti (vedi utilita.cfg) */
+Utilita_Tabella *ut_predefinita(void);
+
+void ut_free(Utilita_Tabella *t);
+
+/* --------------------------------------------------
+ * Valutazione su una tabella esplicita
+ *
+ * Stesse semantiche di calcola_utilita, utilita_attesa
+ * e utilita_attesa_batch (Incertezza.h)
+ * -------------------------------------------------- */
+double ut_utilita(
+    const Utilita_Tabella *t,
+    int stato,
+    double temp_int,
+    double temp_ext
+);
+
+double ut_utilita_attesa(
+    const Utilita_Tabella *t,
+    const double p[],
+    double temp_int,
+    double temp_ext
+);
+
+void ut_utilita_attesa_batch(
+    const Utilita_Tabella *t,
+    const double p_away[],
+    const double p_home[],
+    const double p_sleep[],
+    const double temp_int[],
+    const double temp_ext[],
+    int n,
+    double eu[]
+);
+
+/* --------------------------------------------------
+ * Tabella attiva
+ *
+ * ut_attiva    : tabella usata da Incertezza.h
+ *                (la predefinita se nessuna è stata
+ *                pubblicata)
+ * ut_pubblica  : sostituisce atomicamente la tabella
+ *                attiva e ritorna la precedente
+ *                (NULL: si torna alla predefinita)
+ *
+ * Le valutazioni già in corso continuano sulla tabella
+ * precedente: il chiamante la libera con ut_free solo
+ * quando sono terminate (es. al tick successivo).
+ * -------------------------------------------------- */
+const Utilita_Tabella *ut_attiva(void);
+
+Utilita_Tabella *ut_pubblica(Utilita_Tabella *t);
+
+#endif
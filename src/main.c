@@ -1,18 +1,38 @@
+#define _POSIX_C_SOURCE 200809L
+
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
 #include "NeuralNetwork.h"
+#include "NN_Quantizzato.h"
+#include "NN_Online.h"
+#include "NN_Parallelo.h"
+#include "Dataset.h"
+#include "Normalizzazione.h"
 #include "Incertezza.h"
+#include "Utilita_Tabella.h"
 #include "PL_Scheduler.h"
+#include "Metriche.h"
 
 /* ============================================================
  * PARAMETRI GLOBALI DEL SISTEMA
  * ============================================================ */
 #define N_SLOTS         4       // Numero di appartamenti / slot decisionali
-#define N_FEATURES      7       // Numero di feature di input della rete
+#define N_FEATURES      NORM_N_FEATURE  // Feature di input della rete (schema)
 #define N_STATI         3       // Stati: Away, Home, Sleep
 #define EPOCHE          500     // Epoche di addestramento rete neurale
 #define BUDGET          1.2     // Vincolo massimo di energia consumabile
 #define RISCHIO         0.1     // Vincolo massimo di rischio globale
+#define MODELLO_FILE    "modello.nnck"  // Checkpoint della rete addestrata
+#define SEME            42      // Seme del generatore della rete
+#define UTILITA_FILE    "utilita.cfg"   // Tabella della funzione di utilità
+#define BATCH_ONLINE    8       // Righe per passo nel modo online
+#define PUBBLICA_OGNI   16      // Passi tra due snapshot pubblicati
+#define DATASET_CSV     "dataset.csv"   // Dataset di addestramento
+#define DATASET_BIN     "dataset.col"   // Dataset colonnare (tools/converti_dataset)
+#define RIGHE_DERIVA    65536   // Righe del dataset colonnare per la deriva
+#define BATCH_PARALLELO 32      // Mini-batch del training con --thread
 
 /* ============================================================
  * MACROAREA 1 — APPRENDIMENTO (ICON7–ICON8)
@@ -20,58 +40,113 @@
  * ============================================================ */
 
 /*
- * Carica il dataset da file CSV ed esegue l'addestramento
- * della rete neurale.
+ * Esegue un'epoca di addestramento della rete neurale
+ * sul dataset già caricato e normalizzato in memoria.
  *
- * - Normalizza le feature (feature engineering)
  * - La rete impara P(Stato | Evidenze)
+ * - I campioni sono visitati nell'ordine 'ordine',
+ *   rimescolato a ogni epoca dal generatore della rete
  */
-void train_system(NeuralNetwork *net, const char *filename) {
-    FILE *f = fopen(filename, "r");
-    if (!f) return;
-
-    double row[N_FEATURES];
-    int target_class;
-
-    while (fscanf(
-        f,
-        "%lf, %lf, %lf, %lf, %lf, %lf, %lf, %d",
-        &row[0], &row[1], &row[2],
-        &row[3], &row[4], &row[5],
-        &row[6], &target_class
-    ) == 8) {
-
-        // Normalizzazione delle feature (ICON8)
-        double input[N_FEATURES] = {
-            row[0] / 24.0,   // ora
-            row[1] / 10.0,   // temperatura esterna
-            row[2],          // luci
-            row[3],          // movimento
-            row[4] / 10.0,   // consumo
-            row[5],          // prezzo energia
-            row[6] / 30.0    // temperatura interna
-        };
+void train_system(NeuralNetwork *net, const Dataset *ds, int *ordine) {
+    nn_mescola(net, ordine, ds->n_righe);
+
+    for (int k = 0; k < ds->n_righe; k++) {
+        const int r = ordine[k];
 
         // Target one-hot (Away, Home, Sleep)
         double target[3] = {0, 0, 0};
-        target[target_class] = 1.0;
+        target[ds->y[r]] = 1.0;
 
-        nn_train(net, input, target);
+        nn_train(net, &ds->X[(size_t)r * ds->n_feature], target);
     }
+}
+
+/*
+ * Come train_system, leggendo le colonne direttamente dalla
+ * mappatura del file binario
+ */
+void train_system_colonne(NeuralNetwork *net, const Dataset_Colonne *dc,
+                          int *ordine) {
+    nn_mescola(net, ordine, (int)dc->n_righe);
+
+    for (long k = 0; k < dc->n_righe; k++) {
+        const int r = ordine[k];
 
-    fclose(f);
+        double x[DATASET_N_FEATURE];
+        dataset_colonne_riga(dc, r, x);
+
+        double target[3] = {0, 0, 0};
+        target[dc->y[r]] = 1.0;
+
+        nn_train(net, x, target);
+    }
 }
 
-/* ============================================================
- * MAIN
- * ============================================================ */
-int main(void) {
+/*
+ * Epoca a mini-batch di BATCH_PARALLELO righe, ciascuno
+ * addestrato in parallelo dal pool (--thread N) con un solo
+ * aggiornamento dei pesi. Le righe, dal CSV (ds) o dalle
+ * colonne (dc), sono raccolte in Xb e Yb.
+ */
+void train_system_parallelo(NN_Parallelo *pool, NeuralNetwork *net,
+                            const Dataset *ds, const Dataset_Colonne *dc,
+                            int *ordine, double *Xb, double *Yb) {
+    const int n = ds ? ds->n_righe : (int)dc->n_righe;
+    nn_mescola(net, ordine, n);
 
-    srand(42);
+    for (int k = 0; k < n; k += BATCH_PARALLELO) {
+        const int m = (n - k < BATCH_PARALLELO) ? n - k : BATCH_PARALLELO;
 
-    /* ========================================================
-     * MACROAREA 1 — APPRENDIMENTO
-     * ======================================================== */
+        memset(Yb, 0, (size_t)m * N_STATI * sizeof(double));
+        for (int i = 0; i < m; i++) {
+            const int r = ordine[k + i];
+            double *x = &Xb[(size_t)i * N_FEATURES];
+
+            if (ds) memcpy(x, &ds->X[(size_t)r * ds->n_feature], N_FEATURES * sizeof(double));
+            else    dataset_colonne_riga(dc, r, x);
+            Yb[(size_t)i * N_STATI + (ds ? ds->y[r] : dc->y[r])] = 1.0;
+        }
+
+        nnp_train_batch(pool, net, Xb, Yb, m);
+    }
+}
+
+/*
+ * Mappa il dataset colonnare se esiste e non è più vecchio
+ * del CSV da cui deriva; altrimenti NULL, segnalando perché
+ * il file presente non viene usato.
+ */
+Dataset_Colonne *mappa_dataset_colonne(void) {
+    struct stat bin, csv;
+    if (stat(DATASET_BIN, &bin) != 0) return NULL;
+
+    if (stat(DATASET_CSV, &csv) == 0 &&
+        (csv.st_mtim.tv_sec > bin.st_mtim.tv_sec ||
+         (csv.st_mtim.tv_sec == bin.st_mtim.tv_sec &&
+          csv.st_mtim.tv_nsec > bin.st_mtim.tv_nsec))) {
+        fprintf(stderr, "%s ignorato: più vecchio di %s "
+                "(rigenerare con tools/converti_dataset)\n",
+                DATASET_BIN, DATASET_CSV);
+        return NULL;
+    }
+
+    const char *motivo;
+    Dataset_Colonne *dc = dataset_mappa_colonne(DATASET_BIN, &motivo);
+    if (!dc)
+        fprintf(stderr, "%s ignorato: %s\n", DATASET_BIN, motivo);
+    return dc;
+}
+
+/*
+ * Crea la rete neurale e la addestra sul dataset: il file
+ * colonnare se presente e aggiornato, altrimenti il CSV.
+ * Riporta anche la deriva delle copie a bassa precisione.
+ *
+ * n_thread = 0 : un campione per aggiornamento (nn_train),
+ *                il training di riferimento
+ * n_thread > 0 : mini-batch data-paralleli su n_thread thread
+ */
+NeuralNetwork *addestra_modello(int n_thread) {
 
     // Creazione della rete neurale
     NeuralNetwork *ann = nn_create(
@@ -79,17 +154,239 @@ int main(void) {
         16,           // neuroni hidden
         3,            // output probabilistici
         0.01,         // learning rate
-        0.001         // regolarizzazione L2
+        0.001,        // regolarizzazione L2
+        SEME          // seme del generatore
     );
+    if (!ann) return NULL;
+
+    // Dataset colonnare mappato in memoria (nessuna analisi),
+    // altrimenti caricamento e normalizzazione del CSV
+    Dataset_Colonne *dc = mappa_dataset_colonne();
+    Dataset *ds = dc ? NULL : dataset_carica_csv(DATASET_CSV);
+    if (!dc && !ds) {
+        fprintf(stderr, "Impossibile caricare %s\n", DATASET_CSV);
+        nn_free(ann);
+        return NULL;
+    }
+    if (ds && ds->n_errori > 0)
+        fprintf(stderr, "%s: %d righe scartate\n", DATASET_CSV, ds->n_errori);
+
+    const long n_righe = dc ? dc->n_righe : ds->n_righe;
+    printf("Addestramento su %s: %ld righe\n",
+           dc ? DATASET_BIN : DATASET_CSV, n_righe);
+
+    // Permutazione dei campioni, rimescolata a ogni epoca
+    int *ordine = (int*)malloc((size_t)n_righe * sizeof(int));
+
+    // Righe contigue per la deriva: quelle del CSV, oppure le
+    // prime RIGHE_DERIVA raccolte dalle colonne
+    const int n_deriva = ds ? ds->n_righe
+                       : (int)(n_righe < RIGHE_DERIVA ? n_righe : RIGHE_DERIVA);
+    double *X_deriva = ds ? ds->X
+                     : (double*)malloc((size_t)n_deriva * DATASET_N_FEATURE * sizeof(double));
+
+    if (!ordine || !X_deriva) {
+        fprintf(stderr, "Memoria insufficiente per l'addestramento\n");
+        free(ordine);
+        if (dc) free(X_deriva);
+        dataset_colonne_free(dc);
+        dataset_free(ds);
+        nn_free(ann);
+        return NULL;
+    }
+    for (long r = 0; r < n_righe; r++)
+        ordine[r] = (int)r;
+    if (dc)
+        for (int r = 0; r < n_deriva; r++)
+            dataset_colonne_riga(dc, r, &X_deriva[(size_t)r * DATASET_N_FEATURE]);
 
     // Addestramento su dataset
-    for (int e = 0; e < EPOCHE; e++)
-        train_system(ann, "dataset.csv");
+    if (n_thread > 0) {
+        NN_Parallelo *pool = nnp_crea(ann, n_thread, BATCH_PARALLELO);
+        double *Xb = (double*)malloc(BATCH_PARALLELO * N_FEATURES * sizeof(double));
+        double *Yb = (double*)malloc(BATCH_PARALLELO * N_STATI * sizeof(double));
+
+        if (pool && Xb && Yb) {
+            printf("Addestramento parallelo: %d thread, mini-batch %d\n",
+                   nnp_num_thread(pool), BATCH_PARALLELO);
+            for (int e = 0; e < EPOCHE; e++)
+                train_system_parallelo(pool, ann, ds, dc, ordine, Xb, Yb);
+        }
+        else {
+            fprintf(stderr, "Memoria insufficiente per il training parallelo\n");
+            nn_free(ann);
+            ann = NULL;
+        }
+
+        nnp_free(pool);
+        free(Xb);
+        free(Yb);
+    }
+    else {
+        for (int e = 0; e < EPOCHE; e++) {
+            if (dc) train_system_colonne(ann, dc, ordine);
+            else    train_system(ann, ds, ordine);
+        }
+    }
+    free(ordine);
+
+    if (!ann) {
+        if (dc) free(X_deriva);
+        dataset_colonne_free(dc);
+        dataset_free(ds);
+        return NULL;
+    }
+
+    // Copie di sola inferenza a bassa precisione:
+    // deriva massima delle probabilità rispetto al modello double
+    NN_Float *ann_f = nn_esporta_float(ann);
+    NN_Int8 *ann_q = nn_esporta_int8(ann);
+    double deriva_f, deriva_q;
+
+    if (ann_f && ann_q &&
+        nn_deriva_quantizzazione(ann, ann_f, ann_q, X_deriva, n_deriva,
+                                 &deriva_f, &deriva_q) == 0)
+        printf("Deriva massima P(stato) su %s: "
+               "float %.2e | int8 %.2e\n",
+               dc ? DATASET_BIN : DATASET_CSV, deriva_f, deriva_q);
+
+    nn_float_free(ann_f);
+    nn_int8_free(ann_q);
+    if (dc) free(X_deriva);
+    dataset_colonne_free(dc);
+    dataset_free(ds);
+
+    return ann;
+}
+
+/*
+ * Modo online: aggiorna il modello con le righe che arrivano
+ * da 'sorgente' ("-" = stdin, anche una pipe), nel formato di
+ * dataset.csv. A fine flusso l'ultimo snapshot pubblicato
+ * diventa il nuovo checkpoint.
+ */
+int esegui_online(const NeuralNetwork *ann, const char *sorgente) {
+    const int da_stdin = strcmp(sorgente, "-") == 0;
+    FILE *f = da_stdin ? stdin : fopen(sorgente, "r");
+    if (!f) {
+        fprintf(stderr, "Impossibile aprire %s\n", sorgente);
+        return 1;
+    }
+
+    NN_Online *online = nno_crea(ann, BATCH_ONLINE, PUBBLICA_OGNI, 1);
+    if (!online) {
+        fprintf(stderr, "Memoria insufficiente per il modo online\n");
+        if (!da_stdin) fclose(f);
+        return 1;
+    }
+
+    while (nno_consuma(online, f, da_stdin ? "stdin" : sorgente, 0) > 0)
+        ;
+    if (!da_stdin) fclose(f);
+
+    nno_pubblica(online);
+
+    NNO_Statistiche st;
+    nno_statistiche(online, &st);
+    printf("Modo online: %ld righe (%ld scartate), %ld aggiornamenti, "
+           "versione %lu\n", st.righe, st.scartate, st.aggiornamenti,
+           nno_versione(online));
+    if (st.falliti > 0)
+        fprintf(stderr, "Modo online: %ld batch scartati per memoria "
+                "insufficiente\n", st.falliti);
+
+    NN_Snapshot *pub = nno_snapshot(online);
+    const int lettore = nns_registra(pub);
+    if (nn_save(nns_fissa(pub, lettore, NULL), MODELLO_FILE) != 0)
+        fprintf(stderr, "Impossibile salvare %s\n", MODELLO_FILE);
+    nns_rilascia(pub, lettore);
+    nns_deregistra(pub, lettore);
+
+    nno_free(online);
+    return 0;
+}
+
+/* ============================================================
+ * METRICHE DI ESERCIZIO
+ *
+ * Con METRICHE=<destinazione> nell'ambiente i contatori sono
+ * scritti all'uscita su file o su socket locale
+ * ("unix:<percorso>"). Richiede la build con make CON_METRICHE=1.
+ * ============================================================ */
+void scrivi_metriche(void) {
+    const char *dest = getenv("METRICHE");
+    if (!dest || !*dest) return;
+
+#ifdef METRICHE_ABILITATE
+    if (met_scrivi_destinazione(dest) != 0)
+        fprintf(stderr, "Impossibile scrivere le metriche su %s\n", dest);
+#else
+    fprintf(stderr, "METRICHE ignorata: compilare con make CON_METRICHE=1\n");
+#endif
+}
+
+/* ============================================================
+ * MAIN
+ *
+ *   ./main                      analisi e piano energetico
+ *   ./main --online [file|-]    apprendimento online da flusso
+ *   ./main --thread N ...       addestramento a mini-batch su
+ *                               N thread (se manca il checkpoint)
+ * ============================================================ */
+int main(int argc, char **argv) {
+
+    atexit(scrivi_metriche);
+
+    const char *online = NULL;
+    int n_thread = 0;
+
+    for (int a = 1; a < argc; a++) {
+        if (strcmp(argv[a], "--online") == 0)
+            online = (a + 1 < argc && strncmp(argv[a + 1], "--", 2) != 0)
+                   ? argv[++a] : "-";
+        else if (strcmp(argv[a], "--thread") == 0 && a + 1 < argc &&
+                 (n_thread = atoi(argv[a + 1])) > 0)
+            a++;
+        else {
+            fprintf(stderr, "uso: %s [--online [file|-]] [--thread N]\n",
+                    argv[0]);
+            return 2;
+        }
+    }
+
+    /* ========================================================
+     * MACROAREA 1 — APPRENDIMENTO
+     * ======================================================== */
+
+    // Modello già addestrato: caricamento dal checkpoint
+    // (mappato in memoria, nessun riaddestramento)
+    NeuralNetwork *ann = nn_load(MODELLO_FILE, 1);
+
+    if (!ann) {
+        ann = addestra_modello(n_thread);
+        if (!ann) return 1;
+
+        if (nn_save(ann, MODELLO_FILE) != 0)
+            fprintf(stderr, "Impossibile salvare %s\n", MODELLO_FILE);
+    }
+
+    if (online) {
+        const int esito = esegui_online(ann, online);
+        nn_free(ann);
+        return esito;
+    }
 
     /* ========================================================
      * MACROAREA 2 — INCERTEZZA / VALUTAZIONE STOCASTICA (ICON9)
      * ======================================================== */
 
+    // Tabella di utilità da file; se assente restano i valori
+    // predefiniti. In un ciclo di controllo la ricarica avviene
+    // tra un tick e l'altro con la stessa chiamata.
+    Utilita_Tabella *tabella = ut_carica(UTILITA_FILE);
+    if (tabella)
+        ut_free(ut_pubblica(tabella));
+
     // Dati di test (stato corrente degli appartamenti)
     double slots_test[N_SLOTS][N_FEATURES] = {
         // ora, temp_ext, luci, mov, consumo, prezzo, temp_int
@@ -104,24 +401,34 @@ int main(void) {
     double risk_coeff[N_SLOTS];
     double occ_prob[N_SLOTS];
 
+    // Normalizzazione input per inferenza, con le stesse
+    // costanti del training (i valori grezzi servono ancora
+    // per utilità e vincoli)
+    double input_norm[N_SLOTS][N_FEATURES];
+    norm_batch(&slots_test[0][0], &input_norm[0][0], N_SLOTS);
+
+    // Inferenza neurale a batch: P(Stato | Evidenze) per tutti gli slot
+    double prob[N_SLOTS][N_STATI];
+    NN_Workspace *ws = nn_workspace_create(ann, N_SLOTS);
+    if (!ws) {
+        fprintf(stderr, "Memoria insufficiente per l'inferenza\n");
+        nn_free(ann);
+        return 1;
+    }
+    const int esito_inferenza =
+        nn_forward_batch(ann, &input_norm[0][0], N_SLOTS, &prob[0][0], ws);
+    nn_workspace_free(ws);
+    if (esito_inferenza != 0) {
+        fprintf(stderr, "Workspace incompatibile con la rete\n");
+        nn_free(ann);
+        return 1;
+    }
+
     printf("\n\n--- ANALISI AGENTE INTELLIGENTE ---\n\n");
 
     for (int i = 0; i < N_SLOTS; i++) {
 
-        // Normalizzazione input per inferenza
-        double input_norm[N_FEATURES] = {
-            slots_test[i][0] / 24.0,
-            slots_test[i][1] / 10.0,
-            slots_test[i][2],
-            slots_test[i][3],
-            slots_test[i][4] / 5.0,
-            slots_test[i][5],
-            slots_test[i][6] / 30.0
-        };
-
-        // Inferenza neurale: P(Stato | Evidenze)
-        nn_forward(ann, input_norm);
-        double *p = ann->output;
+        const double *p = prob[i];
 
         double t_int = slots_test[i][6];
         double t_ext = slots_test[i][1];
@@ -152,16 +459,48 @@ int main(void) {
      * MACROAREA 3 — DECISIONE OTTIMALE (PL - ICON3)
      * ======================================================== */
 
-    PL_Risultato piano = calcolarePianoOttimale(
+    // Pianificatore persistente: in un ciclo di controllo viene
+    // creato una volta e ri-risolto a ogni aggiornamento dei dati
+    PL_Scheduler *pianificatore = pl_crea(N_SLOTS);
+    if (!pianificatore) {
+        fprintf(stderr, "Impossibile creare il problema di PL\n");
+        nn_free(ann);
+        return 1;
+    }
+
+    PL_Risultato piano;
+    if (pl_risultato_init(&piano, N_SLOTS) != 0) {
+        fprintf(stderr, "Memoria insufficiente per il piano\n");
+        pl_free(pianificatore);
+        nn_free(ann);
+        return 1;
+    }
+    const int esito_piano = pl_risolvi(
+        pianificatore,
         occ_prob,
         prices,
         comfort_gain,
         risk_coeff,
-        N_SLOTS,
         BUDGET,
-        RISCHIO
+        RISCHIO,
+        &piano
     );
 
+    PL_Statistiche stat;
+    pl_statistiche(pianificatore, &stat);
+    pl_free(pianificatore);
+
+    // Senza ottimo la soluzione corrente di GLPK non rispetta
+    // necessariamente budget e rischio: nessun piano
+    if (esito_piano != 0) {
+        fprintf(stderr, "Nessun piano ottimo trovato (%d iterazioni "
+                "del simplex)\n", stat.iterazioni);
+        pl_risultato_libera(&piano);
+        ut_free(ut_pubblica(NULL));
+        nn_free(ann);
+        return 1;
+    }
+
     printf("\n--- PIANO ENERGETICO OTTIMALE ---\n");
     for (int i = 0; i < N_SLOTS; i++)
         printf(
@@ -169,7 +508,16 @@ int main(void) {
             i + 1,
             piano.power[i] * 100
         );
+    if (stat.rapido)
+        printf("(zaino frazionario certificato, %.3f ms)\n",
+               stat.tempo * 1e3);
+    else
+        printf("(simplex: %d iterazioni, %.3f ms)\n",
+               stat.iterazioni, stat.tempo * 1e3);
+
+    pl_risultato_libera(&piano);
 
+    ut_free(ut_pubblica(NULL));
     nn_free(ann);
     return 0;
 }
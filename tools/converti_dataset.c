@@ -0,0 +1,35 @@
+#include <stdio.h>
+#include "Dataset.h"
+
+/* ============================================================
+ *     CONVERSIONE DEL DATASET CSV NEL FORMATO COLONNARE
+ * ============================================================
+ *
+ * Uso: converti_dataset [dataset.csv] [dataset.col]
+ *
+ * Il file prodotto contiene le feature già normalizzate e
+ * viene usato da ./main al posto del CSV quando presente.
+ * Va rigenerato se cambiano le costanti di normalizzazione
+ * (un file non aggiornato viene rifiutato in lettura).
+ */
+
+int main(int argc, char **argv) {
+    const char *csv = (argc > 1) ? argv[1] : "dataset.csv";
+    const char *bin = (argc > 2) ? argv[2] : "dataset.col";
+
+    if (argc > 3) {
+        fprintf(stderr, "uso: %s [file.csv] [file.col]\n", argv[0]);
+        return 2;
+    }
+
+    Dataset_Conversione st;
+    if (dataset_converti_colonne(csv, bin, &st) != 0) {
+        fprintf(stderr, "Conversione di %s in %s non riuscita\n", csv, bin);
+        return 1;
+    }
+
+    printf("%s -> %s: %ld righe", csv, bin, st.righe);
+    if (st.scartate > 0) printf(" (%d scartate)", st.scartate);
+    printf("\n");
+    return 0;
+}